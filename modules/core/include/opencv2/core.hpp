@@ -2278,6 +2278,51 @@ the convolution sample in dft description.
 */
 CV_EXPORTS_W void idft(InputArray src, OutputArray dst, int flags = 0, int nonzeroRows = 0);
 
+/** @brief Discrete Fourier transform of a fixed size, type and set of flags, prepared for reuse.
+
+The plan keeps the factorization of the transform length, the twiddle factors and the working
+buffers, so that a series of same-size transforms (frame-by-frame phase correlation,
+frequency-domain filtering) pays the setup cost once. DFTPlan::apply(src, dst) gives the same result
+as dft(src, dst, flags, nonzeroRows).
+
+@note dft keeps a small per-thread cache of recently used plans too (see the
+OPENCV_DFT_PLAN_CACHE_SIZE environment variable). A DFTPlan object must not be used by several
+threads at the same time.
+@sa dft, idft
+*/
+class CV_EXPORTS DFTPlan
+{
+public:
+    DFTPlan();
+
+    /** @overload
+    @param size size of the input arrays.
+    @param type type of the input arrays: CV_32FC1, CV_32FC2, CV_64FC1 or CV_64FC2.
+    @param flags transformation flags, representing a combination of the #DftFlags
+    @param nonzeroRows see dft.
+    */
+    DFTPlan(Size size, int type, int flags = 0, int nonzeroRows = 0);
+
+    /** @brief Prepares the plan, see DFTPlan(Size, int, int, int) */
+    void create(Size size, int type, int flags = 0, int nonzeroRows = 0);
+
+    /** @brief Performs the transform.
+    @param src input array of the plan size and type.
+    @param dst output array, its type is dstType().
+    */
+    void apply(InputArray src, OutputArray dst);
+
+    bool empty() const;
+    Size size() const;
+    int type() const;
+    int dstType() const;
+    int flags() const;
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
 /** @brief Performs a forward or inverse discrete Cosine transform of 1D or 2D array.
 
 The function cv::dct performs a forward or inverse discrete Cosine transform (DCT) of a 1D or 2D
@@ -3072,7 +3117,18 @@ enum KmeansFlags {
         user-supplied labels instead of computing them from the initial centers. For the second and
         further attempts, use the random or semi-random centers. Use one of KMEANS_\*_CENTERS flag
         to specify the exact method.*/
-    KMEANS_USE_INITIAL_LABELS = 1
+    KMEANS_USE_INITIAL_LABELS = 1,
+    /** Use the triangle inequality bounds (Hamerly, "Making k-means even faster", 2010) to skip the
+        distance computations which can't change the sample label. The clustering is the same as
+        without the flag, but iterations after the first few ones are much faster, especially for
+        large K. Requires 2 floats of additional memory per sample.*/
+    KMEANS_HAMERLY            = 4,
+    /** Mini-batch k-means (Sculley, "Web-scale k-means clustering", 2010): centers are updated
+        using random batches of samples, criteria.maxCount is the number of batches (it's not limited
+        by 100 in this mode). Labels and compactness are computed for all the samples at the end.
+        Batch size is max(1024, 4*K) by default (see OPENCV_KMEANS_MINI_BATCH_SIZE). Can't be combined
+        with #KMEANS_HAMERLY.*/
+    KMEANS_MINI_BATCH         = 8
 };
 
 /** @example samples/cpp/kmeans.cpp
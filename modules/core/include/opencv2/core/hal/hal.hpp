@@ -82,6 +82,29 @@ CV_EXPORTS void gemm64fc(const double* src1, size_t src1_step, const double* src
                         double alpha, const double* src3, size_t src3_step, double beta, double* dst, size_t dst_step,
                         int m_a, int n_a, int n_d, int flags);
 
+/** @brief Packed cache-blocked single precision GEMM: C = alpha*A*B + beta*C
+
+A is MxK matrix with element (i, k) stored at A[i*lda0 + k*lda1], B is KxN matrix with element (k, j)
+stored at B[k*ldb0 + j*ldb1], so transposed operands are expressed by swapped strides. C is MxN matrix
+with row stride ldc. All strides are in elements. B may be packed once with fastGemmPackB and reused
+by several fastGemm calls with the same N and K.
+*/
+CV_EXPORTS size_t fastGemmPackBSize(int N, int K);
+CV_EXPORTS void fastGemmPackB(const float* B, int ldb0, int ldb1, int N, int K, float* packed_B);
+CV_EXPORTS void fastGemm(int M, int N, int K, float alpha,
+                         const float* A, int lda0, int lda1,
+                         const float* B, int ldb0, int ldb1,
+                         float beta, float* C, int ldc, bool multi_thread = true);
+CV_EXPORTS void fastGemm(int M, int N, int K, float alpha,
+                         const float* A, int lda0, int lda1,
+                         const float* packed_B, float beta, float* C, int ldc, bool multi_thread = true);
+CV_EXPORTS void fastGemmBatch(size_t batch, const size_t* A_offsets, const size_t* B_offsets, const size_t* C_offsets,
+                              int M, int N, int K, float alpha, const float* A, int lda0, int lda1,
+                              const float* B, int ldb0, int ldb1, float beta, float* C, int ldc);
+CV_EXPORTS void fastGemmBatch(size_t batch, const size_t* A_offsets, const size_t* packed_B_offsets, const size_t* C_offsets,
+                              int M, int N, int K, float alpha, const float* A, int lda0, int lda1,
+                              const float* packed_B, float beta, float* C, int ldc);
+
 CV_EXPORTS int normL1_(const uchar* a, const uchar* b, int n);
 CV_EXPORTS float normL1_(const float* a, const float* b, int n);
 CV_EXPORTS float normL2Sqr_(const float* a, const float* b, int n);
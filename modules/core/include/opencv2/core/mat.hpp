@@ -3579,6 +3579,11 @@ real-valued scalar ( double )):
 -   Matrix initializers ( Mat::eye(), Mat::zeros(), Mat::ones() ), matrix comma-separated
     initializers, matrix constructors and operators that extract sub-matrices (see Mat description).
 -   Mat_<destination_type>() constructors to cast the result to the proper type.
+
+Chains of element-wise operations on floating-point matrices of the same size and type (addition,
+subtraction, scaling, per-element multiplication and division, `abs()`, and a final comparison with
+a scalar like `abs(A - B) > alpha`) are evaluated lazily: the expression is evaluated in a single
+pass over the data when it is assigned to a matrix, without intermediate matrices.
 @note Comma-separated initializers and probably some other operations may require additional
 explicit Mat() or Mat_<T>() constructor calls to resolve a possible ambiguity.
 
@@ -3700,6 +3705,8 @@ MatExpr operator / (const Matx<_Tp, m, n>& a, const Mat& b) { return Mat(a) / b;
 CV_EXPORTS MatExpr operator < (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator < (const Mat& a, double s);
 CV_EXPORTS MatExpr operator < (double s, const Mat& a);
+CV_EXPORTS MatExpr operator < (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator < (double s, const MatExpr& e);
 template<typename _Tp, int m, int n> static inline
 MatExpr operator < (const Mat& a, const Matx<_Tp, m, n>& b) { return a < Mat(b); }
 template<typename _Tp, int m, int n> static inline
@@ -3708,6 +3715,8 @@ MatExpr operator < (const Matx<_Tp, m, n>& a, const Mat& b) { return Mat(a) < b;
 CV_EXPORTS MatExpr operator <= (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator <= (const Mat& a, double s);
 CV_EXPORTS MatExpr operator <= (double s, const Mat& a);
+CV_EXPORTS MatExpr operator <= (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator <= (double s, const MatExpr& e);
 template<typename _Tp, int m, int n> static inline
 MatExpr operator <= (const Mat& a, const Matx<_Tp, m, n>& b) { return a <= Mat(b); }
 template<typename _Tp, int m, int n> static inline
@@ -3716,6 +3725,8 @@ MatExpr operator <= (const Matx<_Tp, m, n>& a, const Mat& b) { return Mat(a) <=
 CV_EXPORTS MatExpr operator == (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator == (const Mat& a, double s);
 CV_EXPORTS MatExpr operator == (double s, const Mat& a);
+CV_EXPORTS MatExpr operator == (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator == (double s, const MatExpr& e);
 template<typename _Tp, int m, int n> static inline
 MatExpr operator == (const Mat& a, const Matx<_Tp, m, n>& b) { return a == Mat(b); }
 template<typename _Tp, int m, int n> static inline
@@ -3724,6 +3735,8 @@ MatExpr operator == (const Matx<_Tp, m, n>& a, const Mat& b) { return Mat(a) ==
 CV_EXPORTS MatExpr operator != (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator != (const Mat& a, double s);
 CV_EXPORTS MatExpr operator != (double s, const Mat& a);
+CV_EXPORTS MatExpr operator != (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator != (double s, const MatExpr& e);
 template<typename _Tp, int m, int n> static inline
 MatExpr operator != (const Mat& a, const Matx<_Tp, m, n>& b) { return a != Mat(b); }
 template<typename _Tp, int m, int n> static inline
@@ -3732,6 +3745,8 @@ MatExpr operator != (const Matx<_Tp, m, n>& a, const Mat& b) { return Mat(a) !=
 CV_EXPORTS MatExpr operator >= (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator >= (const Mat& a, double s);
 CV_EXPORTS MatExpr operator >= (double s, const Mat& a);
+CV_EXPORTS MatExpr operator >= (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator >= (double s, const MatExpr& e);
 template<typename _Tp, int m, int n> static inline
 MatExpr operator >= (const Mat& a, const Matx<_Tp, m, n>& b) { return a >= Mat(b); }
 template<typename _Tp, int m, int n> static inline
@@ -3740,6 +3755,8 @@ MatExpr operator >= (const Matx<_Tp, m, n>& a, const Mat& b) { return Mat(a) >=
 CV_EXPORTS MatExpr operator > (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator > (const Mat& a, double s);
 CV_EXPORTS MatExpr operator > (double s, const Mat& a);
+CV_EXPORTS MatExpr operator > (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator > (double s, const MatExpr& e);
 template<typename _Tp, int m, int n> static inline
 MatExpr operator > (const Mat& a, const Matx<_Tp, m, n>& b) { return a > Mat(b); }
 template<typename _Tp, int m, int n> static inline
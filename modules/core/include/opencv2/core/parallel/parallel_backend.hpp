@@ -47,6 +47,10 @@ namespace cv { namespace parallel {
  * - disable backend: `OPENCV_PARALLEL_PRIORITY_<backend>=0`
  * - specify list of backends with high priority (>100000): `OPENCV_PARALLEL_PRIORITY_LIST=TBB,OPENMP`. Unknown backends are registered as new plugins.
  *
+ * Builtin `WORKSTEALING` backend is not selected automatically. It is activated by name (`OPENCV_PARALLEL_BACKEND=WORKSTEALING`,
+ * `setParallelForBackend("WORKSTEALING")` or the priority list above). It uses per-worker task deques with work stealing
+ * and executes concurrent `parallel_for_()` calls from different application threads and nested parallel regions in parallel.
+ *
  */
 
 /** Interface for parallel_for backends implementations
@@ -221,6 +221,39 @@ Here is how to read the file created by the code sample above:
     fs2.release();
 @endcode
 
+Raw matrix blobs    {#raw_blobs}
+----------------
+When a file storage is opened for writing with the FileStorage::RAW_BLOBS flag, the element data
+of dense matrices is not encoded as text. It is appended to the companion binary file, which has
+the same name as the storage plus the `.blob` suffix (e.g. `model.yml.blob`). Every block is
+aligned to 64 bytes and stored in the native byte order. The text file only keeps the header of
+each matrix (sizes, element type) and the offset of its block:
+@code{.yaml}
+%YAML:1.0
+---
+weights: !!opencv-matrix
+   rows: 4096
+   cols: 1024
+   dt: f
+   blob: 64
+@endcode
+On reading, the companion file is memory-mapped once and such matrices are returned as Mat headers
+pointing into the mapping, so no data is parsed or copied. The mapping is copy-on-write: modifying
+a loaded matrix does not change the file, and the pages are shared between processes until they
+are written. The mapping is kept alive by the loaded matrices after FileStorage::release(). Writing
+the storage again under the same name does not truncate the companion file: the new one is written
+to `<name>.blob.tmp` and replaces it on release, so the matrices loaded before keep their data. The
+flag is not compatible with FileStorage::MEMORY.
+
+@code
+    FileStorage fs("model.yml", FileStorage::WRITE | FileStorage::RAW_BLOBS);
+    fs << "weights" << weights;
+    fs.release();
+
+    FileStorage fs2("model.yml", FileStorage::READ);
+    Mat w = fs2["weights"].mat(); // no copy
+@endcode
+
 Format specification    {#format_spec}
 --------------------
 `([count]{u|c|w|s|i|f|d})`... where the characters correspond to fundamental C++ types:
@@ -276,6 +309,7 @@ public:
 
         BASE64      = 64,     //!< flag, write rawdata in Base64 by default. (consider using WRITE_BASE64)
         WRITE_BASE64 = BASE64 | WRITE, //!< flag, enable both WRITE and BASE64
+        RAW_BLOBS   = 128,    //!< flag, write data of dense matrices as raw aligned blocks into the companion `.blob` file, see @ref raw_blobs
     };
     enum State
     {
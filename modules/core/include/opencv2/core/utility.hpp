@@ -656,6 +656,42 @@ public:
 */
 CV_EXPORTS void parallel_for_(const Range& range, const ParallelLoopBody& body, double nstripes=-1.);
 
+/** @brief Limits parallelism of parallel_for_() calls issued by the current thread
+
+The object installs a thread-local parallel context for its lifetime: each parallel_for_() called
+from this thread (including nested calls from the loop bodies) is executed by at most @p maxThreads
+threads concurrently and is split into at most @p maxStripes stripes. getNumThreads() reports the
+limited value within the scope. The limits are applied on top of the global setNumThreads() value
+and are honored by all parallel backends.
+
+Nested scopes can't relax limits of outer scopes: the minimal value is used.
+
+This allows to bound CPU usage of independent requests processed by the same process:
+@code
+    {
+        cv::ParallelForScope scope(2);  // this request uses up to 2 threads
+        cv::resize(src, dst, Size(), 0.5, 0.5);
+    }
+@endcode
+
+@param maxThreads Maximal number of threads, 1 means serial execution, values <= 0 don't limit threads.
+@param maxStripes Maximal number of stripes, values <= 0 don't limit stripes.
+
+@ingroup core_parallel
+*/
+class CV_EXPORTS ParallelForScope
+{
+public:
+    explicit ParallelForScope(int maxThreads, int maxStripes = 0);
+    ~ParallelForScope();
+protected:
+    int prevMaxThreads_;
+    int prevMaxStripes_;
+private:
+    ParallelForScope(const ParallelForScope&) = delete;
+    ParallelForScope& operator=(const ParallelForScope&) = delete;
+};
+
 //! @ingroup core_parallel
 class ParallelLoopBodyLambdaWrapper : public ParallelLoopBody
 {
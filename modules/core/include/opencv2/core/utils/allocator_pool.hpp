@@ -0,0 +1,56 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_ALLOCATOR_POOL_HPP
+#define OPENCV_CORE_ALLOCATOR_POOL_HPP
+
+#include "opencv2/core/mat.hpp"
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Counters of the pooled CPU allocator
+
+@sa getPoolAllocator, getPoolAllocatorStatistics
+*/
+struct PoolAllocatorStatistics
+{
+    uint64_t hits = 0;          //!< number of buffers served from per-thread free lists
+    uint64_t misses = 0;        //!< number of buffers which fell through to fastMalloc()
+    uint64_t evictions = 0;     //!< number of released buffers which did not fit into the pool and were freed
+    uint64_t currentUsage = 0;  //!< bytes currently handed out to Mat objects
+    uint64_t peakUsage = 0;     //!< maximal value of currentUsage since the last resetPoolAllocatorStatistics() call
+    size_t retainedSize = 0;    //!< bytes kept in free lists, ready for reuse
+    size_t maxRetainedSize = 0; //!< limit of retainedSize, see BufferPoolController::setMaxReservedSize()
+};
+
+/** @brief Returns the pooled CPU allocator.
+
+The allocator keeps released buffers in per-thread free lists, grouped by size classes
+(four classes per power of two), and hands them out again to subsequent allocations of
+a similar size. Pipelines which repeatedly create and release matrices of the same shape
+do not call fastMalloc()/fastFree() in the steady state.
+
+The allocator is not installed by default. Use `Mat::setDefaultAllocator(cv::utils::getPoolAllocator())`
+or set the `OPENCV_ALLOC_POOL=1` environment variable to make it the default one.
+
+The amount of memory kept in free lists is limited by `OPENCV_ALLOC_POOL_LIMIT` (128Mb by default).
+The limit can be changed and the retained buffers can be released through
+`getPoolAllocator()->getBufferPoolController()`.
+*/
+CV_EXPORTS MatAllocator* getPoolAllocator();
+
+/** @brief Returns a snapshot of the pooled allocator counters. */
+CV_EXPORTS PoolAllocatorStatistics getPoolAllocatorStatistics();
+
+/** @brief Resets hit/miss/eviction counters and sets peak usage to the current usage. */
+CV_EXPORTS void resetPoolAllocatorStatistics();
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_ALLOCATOR_POOL_HPP
@@ -59,6 +59,7 @@ enum RegionFlag {
 
 
 class TraceMessage;
+struct RegionStatistics;
 
 class TraceStorage {
 public:
@@ -66,6 +67,13 @@ public:
     virtual ~TraceStorage() {}
 
     virtual bool put(const TraceMessage& msg) const = 0;
+
+    // Region events. Default implementation emits text messages through put()
+    virtual bool putRegionEnter(const Region& region) const;
+    virtual bool putRegionLeave(const Region& region, const RegionStatistics& result) const;
+    virtual bool putRegionArg(const Region& region, const TraceArg& arg, const char* value) const;
+    virtual bool putRegionArg(const Region& region, const TraceArg& arg, int64 value) const;
+    virtual bool putRegionArg(const Region& region, const TraceArg& arg, double value) const;
 };
 
 struct RegionStatistics
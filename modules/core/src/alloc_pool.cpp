@@ -0,0 +1,354 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "opencv2/core/utils/allocator_pool.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/logger.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+#include <atomic>
+
+namespace cv { namespace utils {
+
+namespace {
+
+// size class 0 holds buffers up to 64 bytes, then 4 classes per power of two
+static const size_t POOL_MIN_CLASS_SIZE = 64;
+static const int POOL_NUM_SIZE_CLASSES = 1 + (64 - 6) * 4;
+static const size_t POOL_MAX_CACHED_UMATDATA = 64;
+
+static inline int highestBit(size_t v)
+{
+    CV_DbgAssert(v > 0);
+#if defined(__GNUC__)
+    return (int)(sizeof(unsigned long long) * 8 - 1) - __builtin_clzll((unsigned long long)v);
+#else
+    int p = 0;
+    while (v >>= 1)
+        p++;
+    return p;
+#endif
+}
+
+/** Returns size class index and its capacity (rounded up size) or -1 if buffer should not be pooled */
+static inline int getSizeClass(size_t size, size_t& capacity)
+{
+    if (size <= POOL_MIN_CLASS_SIZE)
+    {
+        capacity = POOL_MIN_CLASS_SIZE;
+        return 0;
+    }
+    if (size > ((size_t)-1 >> 2))
+        return -1;
+    int p = highestBit(size - 1);  // 2^p < size <= 2^(p+1), p >= 6
+    size_t step = (size_t)1 << (p - 2);
+    capacity = (size + step - 1) & ~(step - 1);
+    return 1 + (p - 6) * 4 + (int)(capacity >> (p - 2)) - 5;
+}
+
+class PoolMatAllocator;
+static PoolMatAllocator& getPoolMatAllocatorInstance();
+
+struct PoolThreadCache
+{
+    PoolThreadCache();
+    ~PoolThreadCache();
+
+    Mutex mutex;  // uncontended, except freeAllReservedBuffers() / statistics calls from other threads
+    std::vector<void*> buffers[POOL_NUM_SIZE_CLASSES];
+    std::vector<void*> umatdata;  // raw storage of released UMatData objects
+
+    uint64_t hits, misses, evictions;
+};
+
+class PoolMatAllocator CV_FINAL : public MatAllocator, public BufferPoolController
+{
+public:
+    PoolMatAllocator()
+        : retainedSize(0)
+        , currentUsage(0), peakUsage(0)
+        , maxRetainedSize(getConfigurationParameterSizeT("OPENCV_ALLOC_POOL_LIMIT", (size_t)1 << 27))
+        , terminatedHits(0), terminatedMisses(0), terminatedEvictions(0)
+    {
+        CV_LOG_DEBUG(NULL, "Pooled CPU allocator: max retained size=" << maxRetainedSize.load());
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        PoolThreadCache& cache = tls.getRef();
+        uchar* data = data0 ? (uchar*)data0 : (uchar*)popBuffer(cache, total);
+        UMatData* u = newUMatData(cache);
+        u->data = u->origdata = data;
+        u->size = total;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+        else
+            trackUsage(total);
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        PoolThreadCache& cache = tls.getRef();
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            pushBuffer(cache, u->origdata, u->size);
+            u->origdata = 0;
+            currentUsage -= (uint64_t)u->size;
+        }
+        deleteUMatData(cache, u);
+    }
+
+    BufferPoolController* getBufferPoolController(const char* /*id*/) const CV_OVERRIDE
+    {
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    // BufferPoolController
+    size_t getReservedSize() const CV_OVERRIDE { return retainedSize.load(); }
+    size_t getMaxReservedSize() const CV_OVERRIDE { return maxRetainedSize.load(); }
+    void setMaxReservedSize(size_t size) CV_OVERRIDE
+    {
+        maxRetainedSize.store(size);
+        if (retainedSize.load() > size)
+            freeAllReservedBuffers();
+    }
+    void freeAllReservedBuffers() CV_OVERRIDE
+    {
+        AutoLock lock(registryMutex);
+        for (size_t i = 0; i < caches.size(); i++)
+            releaseCacheBuffers(*caches[i]);
+    }
+
+    PoolAllocatorStatistics getStatistics() const
+    {
+        PoolAllocatorStatistics s;
+        AutoLock lock(registryMutex);
+        s.hits = terminatedHits;
+        s.misses = terminatedMisses;
+        s.evictions = terminatedEvictions;
+        for (size_t i = 0; i < caches.size(); i++)
+        {
+            PoolThreadCache& cache = *caches[i];
+            AutoLock cacheLock(cache.mutex);
+            s.hits += cache.hits;
+            s.misses += cache.misses;
+            s.evictions += cache.evictions;
+        }
+        s.currentUsage = currentUsage.load();
+        s.peakUsage = peakUsage.load();
+        s.retainedSize = retainedSize.load();
+        s.maxRetainedSize = maxRetainedSize.load();
+        return s;
+    }
+
+    void resetStatistics()
+    {
+        AutoLock lock(registryMutex);
+        terminatedHits = terminatedMisses = terminatedEvictions = 0;
+        for (size_t i = 0; i < caches.size(); i++)
+        {
+            PoolThreadCache& cache = *caches[i];
+            AutoLock cacheLock(cache.mutex);
+            cache.hits = cache.misses = cache.evictions = 0;
+        }
+        peakUsage.store(currentUsage.load());
+    }
+
+    void registerCache(PoolThreadCache* cache)
+    {
+        AutoLock lock(registryMutex);
+        caches.push_back(cache);
+    }
+
+    void unregisterCache(PoolThreadCache* cache)
+    {
+        AutoLock lock(registryMutex);
+        releaseCacheBuffers(*cache);
+        terminatedHits += cache->hits;
+        terminatedMisses += cache->misses;
+        terminatedEvictions += cache->evictions;
+        for (size_t i = 0; i < cache->umatdata.size(); i++)
+            ::operator delete(cache->umatdata[i]);
+        cache->umatdata.clear();
+        caches.erase(std::remove(caches.begin(), caches.end(), cache), caches.end());
+    }
+
+protected:
+    void trackUsage(size_t size) const
+    {
+        uint64_t usage = (currentUsage += (uint64_t)size);
+        uint64_t peak = peakUsage.load();
+        while (usage > peak && !peakUsage.compare_exchange_weak(peak, usage))
+            ;
+    }
+
+    void* popBuffer(PoolThreadCache& cache, size_t size) const
+    {
+        size_t capacity = size;
+        int idx = getSizeClass(size, capacity);
+        {
+            AutoLock lock(cache.mutex);
+            if (idx >= 0)
+            {
+                std::vector<void*>& list = cache.buffers[idx];
+                if (!list.empty())
+                {
+                    void* ptr = list.back();
+                    list.pop_back();
+                    retainedSize -= capacity;
+                    cache.hits++;
+                    return ptr;
+                }
+            }
+            cache.misses++;
+        }
+        // buffers are always allocated with the class capacity, so they can be returned into the pool later
+        return fastMalloc(capacity);
+    }
+
+    void pushBuffer(PoolThreadCache& cache, void* ptr, size_t size) const
+    {
+        size_t capacity = size;
+        int idx = getSizeClass(size, capacity);
+        if (idx >= 0 && capacity <= maxRetainedSize.load())
+        {
+            size_t prev = retainedSize.fetch_add(capacity);
+            if (prev + capacity <= maxRetainedSize.load())
+            {
+                AutoLock lock(cache.mutex);
+                cache.buffers[idx].push_back(ptr);
+                return;
+            }
+            retainedSize -= capacity;
+        }
+        {
+            AutoLock lock(cache.mutex);
+            cache.evictions++;
+        }
+        fastFree(ptr);
+    }
+
+    UMatData* newUMatData(PoolThreadCache& cache) const
+    {
+        void* raw = NULL;
+        {
+            AutoLock lock(cache.mutex);
+            if (!cache.umatdata.empty())
+            {
+                raw = cache.umatdata.back();
+                cache.umatdata.pop_back();
+            }
+        }
+        if (!raw)
+            raw = ::operator new(sizeof(UMatData));
+        return new (raw) UMatData(this);
+    }
+
+    void deleteUMatData(PoolThreadCache& cache, UMatData* u) const
+    {
+        u->~UMatData();
+        {
+            AutoLock lock(cache.mutex);
+            if (cache.umatdata.size() < POOL_MAX_CACHED_UMATDATA)
+            {
+                cache.umatdata.push_back(u);
+                return;
+            }
+        }
+        ::operator delete(u);
+    }
+
+    void releaseCacheBuffers(PoolThreadCache& cache) const
+    {
+        AutoLock lock(cache.mutex);
+        for (int idx = 0; idx < POOL_NUM_SIZE_CLASSES; idx++)
+        {
+            std::vector<void*>& list = cache.buffers[idx];
+            if (list.empty())
+                continue;
+            size_t capacity = idx == 0 ? POOL_MIN_CLASS_SIZE
+                : ((size_t)((idx - 1) % 4 + 5) << ((idx - 1) / 4 + 6 - 2));
+            for (size_t i = 0; i < list.size(); i++)
+                fastFree(list[i]);
+            retainedSize -= capacity * list.size();
+            list.clear();
+        }
+    }
+
+    mutable std::atomic<size_t> retainedSize;
+    mutable std::atomic<uint64_t> currentUsage, peakUsage;
+    std::atomic<size_t> maxRetainedSize;
+
+    mutable TLSData<PoolThreadCache> tls;
+
+    mutable Mutex registryMutex;
+    std::vector<PoolThreadCache*> caches;  // guarded by registryMutex
+    uint64_t terminatedHits, terminatedMisses, terminatedEvictions;  // guarded by registryMutex
+};
+
+static PoolMatAllocator& getPoolMatAllocatorInstance()
+{
+    CV_SINGLETON_LAZY_INIT_REF(PoolMatAllocator, new PoolMatAllocator())
+}
+
+PoolThreadCache::PoolThreadCache()
+    : hits(0), misses(0), evictions(0)
+{
+    getPoolMatAllocatorInstance().registerCache(this);
+}
+
+PoolThreadCache::~PoolThreadCache()
+{
+    getPoolMatAllocatorInstance().unregisterCache(this);
+}
+
+} // namespace
+
+MatAllocator* getPoolAllocator()
+{
+    return &getPoolMatAllocatorInstance();
+}
+
+PoolAllocatorStatistics getPoolAllocatorStatistics()
+{
+    return getPoolMatAllocatorInstance().getStatistics();
+}
+
+void resetPoolAllocatorStatistics()
+{
+    getPoolMatAllocatorInstance().resetStatistics();
+}
+
+}} // namespace
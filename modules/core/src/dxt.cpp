@@ -43,6 +43,8 @@
 #include "opencv2/core/opencl/runtime/opencl_clfft.hpp"
 #include "opencv2/core/opencl/runtime/opencl_core.hpp"
 #include "opencl_kernels_core.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/tls.hpp"
 #include <map>
 
 namespace cv
@@ -1259,11 +1261,14 @@ RealDFT(const OcvDftOptions & c, const T* src, T* dst)
         T scale2 = scale*(T)0.5;
         int n2 = n >> 1;
 
-        c.factors[0] >>= 1;
+        // the context is shared by parallel row passes, so the halved factors are kept locally
+        int sub_factors[34];
+        std::copy(c.factors, c.factors + c.nf, sub_factors);
+        sub_factors[0] >>= 1;
 
         OcvDftOptions sub_c = c;
-        sub_c.factors += (c.factors[0] == 1);
-        sub_c.nf -= (c.factors[0] == 1);
+        sub_c.factors = sub_factors + (sub_factors[0] == 1);
+        sub_c.nf -= (sub_factors[0] == 1);
         sub_c.isComplex = false;
         sub_c.isInverse = false;
         sub_c.noPermute = false;
@@ -1272,8 +1277,6 @@ RealDFT(const OcvDftOptions & c, const T* src, T* dst)
 
         DFT(sub_c, (Complex<T>*)src, (Complex<T>*)dst);
 
-        c.factors[0] <<= 1;
-
         t = dst[0] - dst[1];
         dst[0] = (dst[0] + dst[1])*scale;
         dst[1] = t*scale;
@@ -1474,11 +1477,14 @@ CCSIDFT(const OcvDftOptions & c, const T* src, T* dst)
             }
         }
 
-        c.factors[0] >>= 1;
+        // the context is shared by parallel row passes, so the halved factors are kept locally
+        int sub_factors[34];
+        std::copy(c.factors, c.factors + c.nf, sub_factors);
+        sub_factors[0] >>= 1;
 
         OcvDftOptions sub_c = c;
-        sub_c.factors += (c.factors[0] == 1);
-        sub_c.nf -= (c.factors[0] == 1);
+        sub_c.factors = sub_factors + (sub_factors[0] == 1);
+        sub_c.nf -= (sub_factors[0] == 1);
         sub_c.isComplex = false;
         sub_c.isInverse = false;
         sub_c.noPermute = !inplace;
@@ -1487,8 +1493,6 @@ CCSIDFT(const OcvDftOptions & c, const T* src, T* dst)
 
         DFT(sub_c, (Complex<T>*)dst, (Complex<T>*)dst);
 
-        c.factors[0] <<= 1;
-
         for( j = 0; j < n; j += 2 )
         {
             t0 = dst[j]*scale;
@@ -2778,6 +2782,12 @@ inline DftDims determineDims(int rows, int cols, bool isRowWise, bool isContinuo
     return InvalidDim;
 }
 
+// row / column passes of large 2D transforms are processed in parallel
+static const double DFT_PARALLEL_MIN_SIZE = (double)(1 << 16);  // elements
+
+// checks that 1D transform context may be applied concurrently from several threads
+static bool isReentrantDFT1D(const hal::DFT1D* c);
+
 class OcvDftImpl CV_FINAL : public hal::DFT2D
 {
 protected:
@@ -3058,23 +3068,15 @@ protected:
         if( nz <= 0 || nz > count )
             nz = count;
 
-        int i;
-        for( i = 0; i < nz; i++ )
+        if( nz > 1 && (double)len*nz >= DFT_PARALLEL_MIN_SIZE && isReentrantDFT1D(contextA.get()) )
         {
-            const uchar* sptr = src_data + src_step * i;
-            uchar* dptr0 = dst_data + dst_step * i;
-            uchar* dptr = dptr0;
-
-            if( needBufferA )
-                dptr = tmp_bufA.data();
-
-            contextA->apply(sptr, dptr);
-
-            if( needBufferA )
-                memcpy( dptr0, dptr + dptr_offset, dst_full_len );
+            RowDftInvoker invoker(*this, src_data, src_step, dst_data, dst_step, len, dptr_offset, dst_full_len);
+            parallel_for_(Range(0, nz), invoker, (double)len*nz/DFT_PARALLEL_MIN_SIZE);
         }
+        else
+            rowDftRange(Range(0, nz), src_data, src_step, dst_data, dst_step, dptr_offset, dst_full_len, tmp_bufA.data());
 
-        for( ; i < count; i++ )
+        for( int i = nz; i < count; i++ )
         {
             uchar* dptr0 = dst_data + dst_step * i;
             memset( dptr0, 0, dst_full_len );
@@ -3186,17 +3188,63 @@ protected:
             }
         }
 
-        for(int i = a; i < b; i += 2 )
+        int npairs = std::max((b - a + 1)/2, 0);
+        if( npairs > 1 && (double)len*(b - a) >= DFT_PARALLEL_MIN_SIZE && isReentrantDFT1D(contextB.get()) )
+        {
+            ColDftInvoker invoker(*this, sptr0, src_step, dptr0, dst_step, a, b, len);
+            parallel_for_(Range(0, npairs), invoker, (double)len*(b - a)/DFT_PARALLEL_MIN_SIZE);
+        }
+        else
+            colDftPairs(Range(0, npairs), sptr0, src_step, dptr0, dst_step, a, b, len,
+                        buf0.data(), buf1.data(), tmp_bufB.data());
+
+        if(isLastStage && mode == FwdRealToComplex)
+            complementComplexOutput(depth, dst_data, dst_step, count, len, 2);
+    }
+
+    void rowDftRange(const Range& range, const uchar* src_data, size_t src_step, uchar* dst_data, size_t dst_step,
+                     int dptr_offset, int dst_full_len, uchar* tmp_buf) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const uchar* sptr = src_data + src_step * i;
+            uchar* dptr0 = dst_data + dst_step * i;
+            uchar* dptr = dptr0;
+
+            if( needBufferA )
+                dptr = tmp_buf;
+
+            contextA->apply(sptr, dptr);
+
+            if( needBufferA )
+                memcpy( dptr0, dptr + dptr_offset, dst_full_len );
+        }
+    }
+
+    // processes pairs of complex columns [a + range.start*2, a + range.end*2) of [a, b)
+    void colDftPairs(const Range& range, const uchar* sptr0, size_t src_step, uchar* dptr0, size_t dst_step,
+                     int a, int b, int len, uchar* cbuf0, uchar* cbuf1, uchar* tmp_buf) const
+    {
+        uchar *dbuf0 = cbuf0, *dbuf1 = cbuf1;
+        if( needBufferB )
+        {
+            dbuf1 = tmp_buf;
+            dbuf0 = cbuf1;
+        }
+
+        sptr0 += (size_t)range.start*2*complex_elem_size;
+        dptr0 += (size_t)range.start*2*complex_elem_size;
+        for(int i = a + range.start*2; i < std::min(b, a + range.end*2); i += 2 )
         {
             if( i+1 < b )
             {
-                CopyFrom2Columns( sptr0, src_step, buf0.data(), buf1.data(), len, complex_elem_size );
-                contextB->apply(buf1.data(), dbuf1);
+                CopyFrom2Columns( sptr0, src_step, cbuf0, cbuf1, len, complex_elem_size );
+                contextB->apply(cbuf1, dbuf1);
             }
             else
-                CopyColumn( sptr0, src_step, buf0.data(), complex_elem_size, len, complex_elem_size );
+                CopyColumn( sptr0, src_step, cbuf0, complex_elem_size, len, complex_elem_size );
 
-            contextB->apply(buf0.data(), dbuf0);
+            contextB->apply(cbuf0, dbuf0);
 
             if( i+1 < b )
                 CopyTo2Columns( dbuf0, dbuf1, dptr0, dst_step, len, complex_elem_size );
@@ -3205,9 +3253,58 @@ protected:
             sptr0 += 2*complex_elem_size;
             dptr0 += 2*complex_elem_size;
         }
-        if(isLastStage && mode == FwdRealToComplex)
-            complementComplexOutput(depth, dst_data, dst_step, count, len, 2);
     }
+
+    class RowDftInvoker CV_FINAL : public ParallelLoopBody
+    {
+    public:
+        RowDftInvoker(const OcvDftImpl& impl_, const uchar* src_, size_t src_step_, uchar* dst_, size_t dst_step_,
+                      int len_, int dptr_offset_, int dst_full_len_)
+            : impl(impl_), src(src_), src_step(src_step_), dst(dst_), dst_step(dst_step_),
+              len(len_), dptr_offset(dptr_offset_), dst_full_len(dst_full_len_)
+        {}
+
+        void operator()(const Range& range) const CV_OVERRIDE
+        {
+            AutoBuffer<uchar> buf;
+            if( impl.needBufferA )
+                buf.allocate(len * impl.complex_elem_size);
+            impl.rowDftRange(range, src, src_step, dst, dst_step, dptr_offset, dst_full_len, buf.data());
+        }
+
+    protected:
+        const OcvDftImpl& impl;
+        const uchar* src;
+        size_t src_step;
+        uchar* dst;
+        size_t dst_step;
+        int len, dptr_offset, dst_full_len;
+    };
+
+    class ColDftInvoker CV_FINAL : public ParallelLoopBody
+    {
+    public:
+        ColDftInvoker(const OcvDftImpl& impl_, const uchar* src_, size_t src_step_, uchar* dst_, size_t dst_step_,
+                      int a_, int b_, int len_)
+            : impl(impl_), src(src_), src_step(src_step_), dst(dst_), dst_step(dst_step_), a(a_), b(b_), len(len_)
+        {}
+
+        void operator()(const Range& range) const CV_OVERRIDE
+        {
+            const size_t bufsize = (size_t)len * impl.complex_elem_size;
+            AutoBuffer<uchar> buf(bufsize * (impl.needBufferB ? 3 : 2));
+            impl.colDftPairs(range, src, src_step, dst, dst_step, a, b, len,
+                             buf.data(), buf.data() + bufsize, buf.data() + bufsize*2);
+        }
+
+    protected:
+        const OcvDftImpl& impl;
+        const uchar* src;
+        size_t src_step;
+        uchar* dst;
+        size_t dst_step;
+        int a, b, len;
+    };
 };
 
 class OcvDftBasicImpl CV_FINAL : public hal::DFT1D
@@ -3373,6 +3470,13 @@ public:
     void free() {}
 };
 
+static bool isReentrantDFT1D(const hal::DFT1D* c)
+{
+    // OpenCV implementation keeps read-only tables only, IPP and HAL replacements may use working buffers
+    const OcvDftBasicImpl* impl = dynamic_cast<const OcvDftBasicImpl*>(c);
+    return impl && !impl->opt.useIpp;
+}
+
 struct ReplacementDFT1D : public hal::DFT1D
 {
     cvhalDFT *context;
@@ -3483,6 +3587,170 @@ Ptr<DFT2D> DFT2D::create(int width, int height, int depth,
 } // cv::
 
 
+namespace cv {
+
+static int getDftDstType(int type, int flags)
+{
+    bool inv = (flags & DFT_INVERSE) != 0;
+    int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+
+    CV_Assert( type == CV_32FC1 || type == CV_32FC2 || type == CV_64FC1 || type == CV_64FC2 );
+
+    // Fail if DFT_COMPLEX_INPUT is specified, but src is not 2 channels.
+    CV_Assert( !((flags & DFT_COMPLEX_INPUT) && cn != 2) );
+
+    if( !inv && cn == 1 && (flags & DFT_COMPLEX_OUTPUT) )
+        return CV_MAKETYPE(depth, 2);
+    if( inv && cn == 2 && (flags & DFT_REAL_OUTPUT) )
+        return depth;
+    return type;
+}
+
+static int getHalDftFlags(const Mat& src, const Mat& dst, int flags)
+{
+    int f = 0;
+    if (src.isContinuous() && dst.isContinuous())
+        f |= CV_HAL_DFT_IS_CONTINUOUS;
+    if (flags & DFT_INVERSE)
+        f |= CV_HAL_DFT_INVERSE;
+    if (flags & DFT_ROWS)
+        f |= CV_HAL_DFT_ROWS;
+    if (flags & DFT_SCALE)
+        f |= CV_HAL_DFT_SCALE;
+    if (src.data == dst.data)
+        f |= CV_HAL_DFT_IS_INPLACE;
+    return f;
+}
+
+static size_t getDftPlanCacheSize()
+{
+    static size_t size = utils::getConfigurationParameterSizeT("OPENCV_DFT_PLAN_CACHE_SIZE", 8);
+    return size;
+}
+
+/** Per-thread cache of recently used DFT contexts (factorization, twiddle factors and buffers) */
+class DftPlanCache
+{
+public:
+    struct Key
+    {
+        int width, height, depth, src_channels, dst_channels, flags, nonzero_rows;
+
+        bool operator==(const Key& k) const
+        {
+            return width == k.width && height == k.height && depth == k.depth &&
+                   src_channels == k.src_channels && dst_channels == k.dst_channels &&
+                   flags == k.flags && nonzero_rows == k.nonzero_rows;
+        }
+    };
+
+    explicit DftPlanCache(size_t maxSize_ = getDftPlanCacheSize()) : maxSize(maxSize_) {}
+
+    /** Takes the context out of the cache while it is used: the transform runs parallel_for_ and the
+     * waiting thread may execute other tasks (e.g. with the work-stealing backend), which call dft()
+     * with the same parameters on this thread. Such nested calls get their own context.
+     */
+    Ptr<hal::DFT2D> acquire(const Key& key)
+    {
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].first == key)
+            {
+                Ptr<hal::DFT2D> c = entries[i].second;
+                entries.erase(entries.begin() + i);
+                return c;
+            }
+        }
+        return hal::DFT2D::create(key.width, key.height, key.depth,
+                                  key.src_channels, key.dst_channels, key.flags, key.nonzero_rows);
+    }
+
+    /** Returns the context to the front of the cache: the least recently used context is evicted first */
+    void release(const Key& key, const Ptr<hal::DFT2D>& c)
+    {
+        if (maxSize == 0)
+            return;
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].first == key)
+                return;  // returned by a nested call
+        }
+        if (entries.size() >= maxSize)
+            entries.resize(maxSize - 1);
+        entries.insert(entries.begin(), std::make_pair(key, c));
+    }
+
+    struct Lease
+    {
+        Lease(DftPlanCache& cache_, const Key& key_) : cache(cache_), key(key_), context(cache_.acquire(key_)) {}
+        ~Lease() { cache.release(key, context); }
+        DftPlanCache& cache;
+        const Key key;
+        const Ptr<hal::DFT2D> context;
+    };
+
+protected:
+    size_t maxSize;
+    std::vector<std::pair<Key, Ptr<hal::DFT2D> > > entries;
+};
+
+static TLSData<DftPlanCache>& getDftPlanCacheTLS()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TLSData<DftPlanCache>, new TLSData<DftPlanCache>())
+}
+
+struct DFTPlan::Impl
+{
+    Impl(Size size_, int type_, int flags_, int nonzeroRows_)
+        : size(size_), type(type_), flags(flags_), nonzeroRows(nonzeroRows_), dstType(getDftDstType(type_, flags_)),
+          contexts(4)
+    {}
+
+    Size size;
+    int type, flags, nonzeroRows, dstType;
+    DftPlanCache contexts;  // in-place / continuous variants
+};
+
+DFTPlan::DFTPlan()
+{
+}
+
+DFTPlan::DFTPlan(Size size, int type, int flags, int nonzeroRows)
+{
+    create(size, type, flags, nonzeroRows);
+}
+
+void DFTPlan::create(Size size, int type, int flags, int nonzeroRows)
+{
+    CV_Assert(size.width > 0 && size.height > 0);
+    p = makePtr<Impl>(size, type, flags, nonzeroRows);
+}
+
+void DFTPlan::apply(InputArray _src, OutputArray _dst)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(!empty());
+    Mat src = _src.getMat();
+    CV_Assert(src.dims <= 2 && src.size() == p->size && src.type() == p->type);
+
+    _dst.create(src.size(), p->dstType);
+    Mat dst = _dst.getMat();
+
+    DftPlanCache::Key key = { src.cols, src.rows, src.depth(), src.channels(), dst.channels(),
+                              getHalDftFlags(src, dst, p->flags), p->nonzeroRows };
+    DftPlanCache::Lease lease(p->contexts, key);
+    lease.context->apply(src.data, src.step, dst.data, dst.step);
+}
+
+bool DFTPlan::empty() const { return !p; }
+Size DFTPlan::size() const { return p ? p->size : Size(); }
+int DFTPlan::type() const { return p ? p->type : -1; }
+int DFTPlan::dstType() const { return p ? p->dstType : -1; }
+int DFTPlan::flags() const { return p ? p->flags : 0; }
+
+} // cv::
+
 void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
 {
     CV_INSTRUMENT_REGION();
@@ -3499,37 +3767,16 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
 #endif
 
     Mat src0 = _src0.getMat(), src = src0;
-    bool inv = (flags & DFT_INVERSE) != 0;
-    int type = src.type();
     int depth = src.depth();
 
-    CV_Assert( type == CV_32FC1 || type == CV_32FC2 || type == CV_64FC1 || type == CV_64FC2 );
-
-    // Fail if DFT_COMPLEX_INPUT is specified, but src is not 2 channels.
-    CV_Assert( !((flags & DFT_COMPLEX_INPUT) && src.channels() != 2) );
-
-    if( !inv && src.channels() == 1 && (flags & DFT_COMPLEX_OUTPUT) )
-        _dst.create( src.size(), CV_MAKETYPE(depth, 2) );
-    else if( inv && src.channels() == 2 && (flags & DFT_REAL_OUTPUT) )
-        _dst.create( src.size(), depth );
-    else
-        _dst.create( src.size(), type );
+    _dst.create( src.size(), getDftDstType(src.type(), flags) );
 
     Mat dst = _dst.getMat();
 
-    int f = 0;
-    if (src.isContinuous() && dst.isContinuous())
-        f |= CV_HAL_DFT_IS_CONTINUOUS;
-    if (inv)
-        f |= CV_HAL_DFT_INVERSE;
-    if (flags & DFT_ROWS)
-        f |= CV_HAL_DFT_ROWS;
-    if (flags & DFT_SCALE)
-        f |= CV_HAL_DFT_SCALE;
-    if (src.data == dst.data)
-        f |= CV_HAL_DFT_IS_INPLACE;
-    Ptr<hal::DFT2D> c = hal::DFT2D::create(src.cols, src.rows, depth, src.channels(), dst.channels(), f, nonzero_rows);
-    c->apply(src.data, src.step, dst.data, dst.step);
+    DftPlanCache::Key key = { src.cols, src.rows, depth, src.channels(), dst.channels(),
+                              getHalDftFlags(src, dst, flags), nonzero_rows };
+    DftPlanCache::Lease lease(getDftPlanCacheTLS().getRef(), key);
+    lease.context->apply(src.data, src.step, dst.data, dst.step);
 }
 
 
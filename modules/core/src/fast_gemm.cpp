@@ -0,0 +1,143 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+// This file is modified from the ficus (https://github.com/vpisarev/ficus/blob/master/runtime/ficus/impl/gemm.impl.h).
+// Here is the original license:
+/*
+    This file is a part of ficus language project.
+    See ficus/LICENSE for the licensing terms
+*/
+
+#include "precomp.hpp"
+
+#define CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+#include "fast_gemm_kernels.simd.hpp"
+#include "fast_gemm_kernels.simd_declarations.hpp"
+#undef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+#include "fast_gemm_kernels.default.hpp"
+
+namespace cv { namespace hal {
+
+// Kernels are selected at runtime, the same way as the other dispatched core functions,
+// but all of them are compiled in (see ocv_add_dispatched_file_force_all in CMakeLists.txt)
+#if CV_TRY_NEON
+#define FAST_GEMM_DISPATCH_NEON(fn, args) if (checkHardwareSupport(CPU_NEON)) return opt_NEON::fn args; else
+#else
+#define FAST_GEMM_DISPATCH_NEON(fn, args)
+#endif
+#if CV_TRY_AVX2
+#define FAST_GEMM_DISPATCH_AVX2(fn, args) if (checkHardwareSupport(CPU_AVX2)) return opt_AVX2::fn args; else
+#else
+#define FAST_GEMM_DISPATCH_AVX2(fn, args)
+#endif
+#if CV_TRY_AVX
+#define FAST_GEMM_DISPATCH_AVX(fn, args) if (checkHardwareSupport(CPU_AVX)) return opt_AVX::fn args; else
+#else
+#define FAST_GEMM_DISPATCH_AVX(fn, args)
+#endif
+#if CV_TRY_LASX
+#define FAST_GEMM_DISPATCH_LASX(fn, args) if (checkHardwareSupport(CPU_LASX)) return opt_LASX::fn args; else
+#else
+#define FAST_GEMM_DISPATCH_LASX(fn, args)
+#endif
+
+#define FAST_GEMM_DISPATCH(fn, args) \
+    FAST_GEMM_DISPATCH_NEON(fn, args) \
+    FAST_GEMM_DISPATCH_AVX2(fn, args) \
+    FAST_GEMM_DISPATCH_AVX(fn, args) \
+    FAST_GEMM_DISPATCH_LASX(fn, args) \
+    return cpu_baseline::fn args
+
+size_t fastGemmPackBSize(int N, int K)
+{
+    FAST_GEMM_DISPATCH(fastGemmPackBSize, (N, K));
+}
+
+void fastGemmPackB(const float* B, int ldb0, int ldb1, int N, int K, float* packed_B)
+{
+    CV_INSTRUMENT_REGION();
+    FAST_GEMM_DISPATCH(fastGemmPackBKernel, ((const char*)B, (char*)packed_B, N, K, ldb0, ldb1, (int)sizeof(float)));
+}
+
+static void fast_gemm_thin(float alpha, float beta, int M, int N, int K,
+                           const char *a_, int lda0, int lda1,
+                           const char *b_, int ldb,
+                           char *c_, int ldc, bool multi_thread) {
+    const float* a = (const float*)a_;
+
+    auto fn = [&](const Range &r) {
+        for(int start = r.start ; start < r.end; start++ ) {
+            float* c_i = (float*)c_ + start * ldc;
+            if (beta == 0.f)
+                for(int j = 0; j < N; j++ ) c_i[j] = 0.f;
+            else if (beta != 1.f)
+                for(int j = 0; j < N; j++ ) c_i[j] *= beta;
+            for(int k = 0; k < K; k++ ) {
+                const float* b_k = (const float*)b_ + k * ldb;
+                float aval = alpha * a[start * lda0 + k * lda1];
+                for(int j = 0; j < N; j++ )
+                    c_i[j] += aval * b_k[j];
+            }
+        }
+    };
+
+    if (multi_thread) {
+        int total = M; // outer loops
+        int cost_per_thread = static_cast<int>(K * N); // inner loops
+        double nstripes = (size_t)total * cost_per_thread * (1 / 1024.0);
+        parallel_for_(Range(0, total), fn, nstripes);
+    } else {
+        fn(Range(0, M));
+    }
+}
+
+void fastGemm(int M, int N, int K, float alpha,
+              const float* A, int lda0, int lda1,
+              const float* B, int ldb0, int ldb1,
+              float beta, float* C, int ldc, bool multi_thread)
+{
+    CV_INSTRUMENT_REGION();
+
+    const char *a = (const char *)A;
+    const char *b = (const char *)B;
+    char *c = (char *)C;
+
+    if (ldb1 == 1 && (M <= 4 || (uint64_t)M * N * K <= 10000)) {
+        return fast_gemm_thin(alpha, beta, M, N, K, a, lda0, lda1, b, ldb0, c, ldc, multi_thread);
+    }
+
+    FAST_GEMM_DISPATCH(fastGemmKernel, (M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta,
+                                        c, ldc, (int)sizeof(float), multi_thread));
+}
+
+void fastGemm(int M, int N, int K, float alpha,
+              const float* A, int lda0, int lda1,
+              const float* packed_B, float beta, float* C, int ldc, bool multi_thread)
+{
+    CV_INSTRUMENT_REGION();
+    FAST_GEMM_DISPATCH(fastGemmKernel, (M, N, K, alpha, (const char*)A, lda0, lda1, (const char*)packed_B, beta,
+                                        (char*)C, ldc, (int)sizeof(float), multi_thread));
+}
+
+void fastGemmBatch(size_t batch, const size_t* A_offsets, const size_t* B_offsets, const size_t* C_offsets,
+                   int M, int N, int K, float alpha, const float* A, int lda0, int lda1,
+                   const float* B, int ldb0, int ldb1, float beta, float* C, int ldc)
+{
+    CV_INSTRUMENT_REGION();
+    FAST_GEMM_DISPATCH(fastGemmBatchKernel, (batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha,
+                                             (const char*)A, lda0, lda1, (const char*)B, ldb0, ldb1, beta,
+                                             (char*)C, ldc, (int)sizeof(float)));
+}
+
+void fastGemmBatch(size_t batch, const size_t* A_offsets, const size_t* packed_B_offsets, const size_t* C_offsets,
+                   int M, int N, int K, float alpha, const float* A, int lda0, int lda1,
+                   const float* packed_B, float beta, float* C, int ldc)
+{
+    CV_INSTRUMENT_REGION();
+    FAST_GEMM_DISPATCH(fastGemmBatchKernel, (batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha,
+                                             (const char*)A, lda0, lda1, (const char*)packed_B, beta,
+                                             (char*)C, ldc, (int)sizeof(float)));
+}
+
+}} // namespace cv::hal
@@ -59,7 +59,7 @@ static void fast_gemm_pack##N##suffix( int m, int k, const void* A_, \
             } \
         } else { \
             const styp* a_ptr[N]; \
-            for (int k = 0; k < N; k++) a_ptr[k] = A + lda0*(i+k < m ? i+k : i); \
+            for (int r = 0; r < N; r++) a_ptr[r] = A + lda0*(i+r < m ? i+r : i); \
             for( int j = 0; j < k*lda1; packA += N, j += lda1 ) \
             { \
                 FAST_GEMM_LOAD_TO_BUF_BORDERS_##N(styp); \
@@ -111,7 +111,7 @@ static void fast_gemm_pack##N##suffix( int m, int k, const void* A_, \
 #define FAST_GEMM_PACK_f32_12(src, dst) FAST_GEMM_PACK_COPY((src), (dst), 12)
 #define FAST_GEMM_PACK_f32_16(src, dst) FAST_GEMM_PACK_COPY((src), (dst), 16)
 
-namespace cv { namespace dnn {
+namespace cv {
 
 CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
 
@@ -909,7 +909,7 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
 
 CV_CPU_OPTIMIZATION_NAMESPACE_END
 
-}} // cv::dnn
+} // cv
 
 #undef FAST_GEMM_STORAGE
 #undef FAST_GEMM_MAX_STACKBUF
@@ -51,6 +51,7 @@ namespace cv
 {
 
 static int CV_KMEANS_PARALLEL_GRANULARITY = (int)utils::getConfigurationParameterSizeT("OPENCV_KMEANS_PARALLEL_GRANULARITY", 1000);
+static int CV_KMEANS_MINI_BATCH_SIZE = (int)utils::getConfigurationParameterSizeT("OPENCV_KMEANS_MINI_BATCH_SIZE", 0);  // 0 - auto
 
 static void generateRandomCenter(int dims, const Vec2f* box, float* center, RNG& rng)
 {
@@ -223,6 +224,200 @@ private:
     const Mat& centers;
 };
 
+
+/*
+Hamerly (2010) "Making k-means even faster":
+labels are updated using the upper bound of the distance to the assigned center and the lower bound
+of the distance to the second closest center. Most of the samples keep their labels without
+distance computations after the first few iterations.
+All the bounds are Euclidean distances (not squared).
+The bounds are stored in double precision and widened by the rounding error of the float distance
+computation (see hamerlyMargin()), so the labels are exactly the same as the labels of Lloyd's iterations.
+*/
+
+/** Relative error bound of the Euclidean distance computed by hal::normL2Sqr_ */
+static inline double hamerlyMargin(int dims)
+{
+    return (dims + 2) * (double)FLT_EPSILON;
+}
+
+class KMeansHamerlyComputer : public ParallelLoopBody
+{
+public:
+    KMeansHamerlyComputer(double *distances_, int *labels_, double *upper_, double *lower_,
+                          const Mat& data_, const Mat& centers_, const double *halfDist_, bool fullScan_)
+        : distances(distances_), labels(labels_), upper(upper_), lower(lower_),
+          data(data_), centers(centers_), halfDist(halfDist_), fullScan(fullScan_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        const int K = centers.rows;
+        const int dims = centers.cols;
+        const double margin = hamerlyMargin(dims);
+
+        for (int i = range.start; i < range.end; ++i)
+        {
+            const float *sample = data.ptr<float>(i);
+            if (!fullScan)
+            {
+                // skip the sample only if the computed distance to the assigned center is certainly
+                // smaller than the computed distances to all the other centers (ties are resolved by the full scan)
+                const int a = labels[i];
+                const double bound = std::max(halfDist[a], lower[i]) * (1 - margin);
+                if (upper[i] * (1 + margin) < bound)
+                    continue;
+                // tighten the upper bound
+                double d = hal::normL2Sqr_(sample, centers.ptr<float>(a), dims);
+                upper[i] = std::sqrt(d) * (1 + margin);
+                distances[i] = d;
+                if (upper[i] * (1 + margin) < bound)
+                    continue;
+            }
+
+            int k_best = 0;
+            double min_dist = DBL_MAX, min_dist2 = DBL_MAX;
+            for (int k = 0; k < K; k++)
+            {
+                const double dist = hal::normL2Sqr_(sample, centers.ptr<float>(k), dims);
+                if (min_dist > dist)
+                {
+                    min_dist2 = min_dist;
+                    min_dist = dist;
+                    k_best = k;
+                }
+                else if (min_dist2 > dist)
+                    min_dist2 = dist;
+            }
+
+            distances[i] = min_dist;
+            labels[i] = k_best;
+            upper[i] = std::sqrt(min_dist) * (1 + margin);
+            lower[i] = K > 1 ? std::sqrt(min_dist2) * (1 - margin) : DBL_MAX;
+        }
+    }
+
+private:
+    KMeansHamerlyComputer& operator=(const KMeansHamerlyComputer&); // = delete
+
+    double *distances;
+    int *labels;
+    double *upper;
+    double *lower;
+    const Mat& data;
+    const Mat& centers;
+    const double *halfDist;
+    const bool fullScan;
+};
+
+/** Computes half of the distance from each center to its closest neighbour center */
+class KMeansCenterDistanceComputer : public ParallelLoopBody
+{
+public:
+    KMeansCenterDistanceComputer(double *halfDist_, const Mat& centers_)
+        : halfDist(halfDist_), centers(centers_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int K = centers.rows;
+        const int dims = centers.cols;
+        const double margin = hamerlyMargin(dims);
+        for (int k = range.start; k < range.end; k++)
+        {
+            double min_dist = DBL_MAX;
+            for (int k1 = 0; k1 < K; k1++)
+            {
+                if (k1 != k)
+                    min_dist = std::min(min_dist, (double)hal::normL2Sqr_(centers.ptr<float>(k), centers.ptr<float>(k1), dims));
+            }
+            halfDist[k] = K > 1 ? 0.5*std::sqrt(min_dist) * (1 - margin) : DBL_MAX;
+        }
+    }
+
+private:
+    KMeansCenterDistanceComputer& operator=(const KMeansCenterDistanceComputer&); // = delete
+
+    double *halfDist;
+    const Mat& centers;
+};
+
+/** Shifts the distance bounds after centers update */
+static void updateHamerlyBounds(const Mat& centers, const Mat& old_centers, const int* labels,
+                                double* upper, double* lower, double* shift, int N)
+{
+    CV_TRACE_FUNCTION();
+    const int K = centers.rows, dims = centers.cols;
+    const double margin = hamerlyMargin(dims);
+    int k_max = 0;
+    for (int k = 0; k < K; k++)
+    {
+        shift[k] = std::sqrt((double)hal::normL2Sqr_(centers.ptr<float>(k), old_centers.ptr<float>(k), dims)) * (1 + margin);
+        if (shift[k] > shift[k_max])
+            k_max = k;
+    }
+    double shift_max2 = 0;  // the largest shift of the centers except k_max
+    for (int k = 0; k < K; k++)
+    {
+        if (k != k_max)
+            shift_max2 = std::max(shift_max2, shift[k]);
+    }
+    for (int i = 0; i < N; i++)
+    {
+        const int a = labels[i];
+        upper[i] += shift[a];
+        lower[i] -= a == k_max ? shift_max2 : shift[k_max];
+    }
+}
+
+/*
+Sculley (2010) "Web-scale k-means clustering":
+centers are updated by small random batches of samples with the per-center learning rate.
+*/
+static void kmeansMiniBatchIterations(const Mat& data, Mat& centers, int batchSize,
+                                      const TermCriteria& criteria, RNG& rng)
+{
+    CV_TRACE_FUNCTION();
+    const int N = data.rows, K = centers.rows, dims = centers.cols;
+    Mat batch(batchSize, dims, CV_32F);
+    std::vector<int> batchLabels(batchSize);
+    std::vector<double> batchDists(batchSize);
+    std::vector<int> counters(K, 0);
+    Mat prev_centers;
+
+    for (int iter = 0; iter < criteria.maxCount; iter++)
+    {
+        for (int i = 0; i < batchSize; i++)
+        {
+            const float* sample = data.ptr<float>(rng.uniform(0, N));
+            std::copy(sample, sample + dims, batch.ptr<float>(i));
+        }
+        parallel_for_(Range(0, batchSize),
+                      KMeansDistanceComputer<false>(batchDists.data(), batchLabels.data(), batch, centers),
+                      (double)divUp((size_t)(dims * batchSize * K), CV_KMEANS_PARALLEL_GRANULARITY));
+
+        centers.copyTo(prev_centers);
+        for (int i = 0; i < batchSize; i++)
+        {
+            const int k = batchLabels[i];
+            const float eta = 1.f/++counters[k];
+            const float* sample = batch.ptr<float>(i);
+            float* center = centers.ptr<float>(k);
+            for (int j = 0; j < dims; j++)
+                center[j] += (sample[j] - center[j])*eta;
+        }
+
+        double max_center_shift = 0;
+        for (int k = 0; k < K; k++)
+            max_center_shift = std::max(max_center_shift, (double)hal::normL2Sqr_(centers.ptr<float>(k), prev_centers.ptr<float>(k), dims));
+        if (iter > 0 && max_center_shift <= criteria.epsilon)
+            break;
+    }
+}
+
 }
 
 double cv::kmeans( InputArray _data, int K,
@@ -238,9 +433,13 @@ double cv::kmeans( InputArray _data, int K,
     const int dims = (isrow ? 1 : data0.cols)*data0.channels();
     const int type = data0.depth();
 
+    const bool useHamerly = (flags & KMEANS_HAMERLY) != 0;
+    const bool miniBatch = (flags & KMEANS_MINI_BATCH) != 0;
+
     attempts = std::max(attempts, 1);
     CV_Assert( data0.dims <= 2 && type == CV_32F && K > 0 );
     CV_CheckGE(N, K, "There can't be more clusters than elements");
+    CV_Assert( !(useHamerly && miniBatch) );
 
     Mat data(N, dims, CV_32F, data0.ptr(), isrow ? dims * sizeof(float) : static_cast<size_t>(data0.step));
 
@@ -285,10 +484,18 @@ double cv::kmeans( InputArray _data, int K,
     criteria.epsilon *= criteria.epsilon;
 
     if (criteria.type & TermCriteria::COUNT)
-        criteria.maxCount = std::min(std::max(criteria.maxCount, 2), 100);
+        criteria.maxCount = miniBatch ? std::max(criteria.maxCount, 2) : std::min(std::max(criteria.maxCount, 2), 100);
     else
         criteria.maxCount = 100;
 
+    // Hamerly's bounds: distance to the assigned center, to the second closest center,
+    // half distance from the center to the closest other center, center shifts
+    cv::AutoBuffer<double, 1> upper(useHamerly ? N : 0), lower(useHamerly ? N : 0);
+    cv::AutoBuffer<double, 64> halfDist(K), shift(K);
+
+    int batchSize = CV_KMEANS_MINI_BATCH_SIZE > 0 ? CV_KMEANS_MINI_BATCH_SIZE : std::max(1024, K*4);
+    batchSize = std::min(batchSize, N);
+
     if (K == 1)
     {
         attempts = 1;
@@ -296,7 +503,7 @@ double cv::kmeans( InputArray _data, int K,
     }
 
     cv::AutoBuffer<Vec2f, 64> box(dims);
-    if (!(flags & KMEANS_PP_CENTERS))
+    if (!(flags & KMEANS_PP_CENTERS) && !miniBatch)
     {
         {
             const float* sample = data.ptr<float>(0);
@@ -319,7 +526,55 @@ double cv::kmeans( InputArray _data, int K,
     for (int a = 0; a < attempts; a++)
     {
         double compactness = 0;
+        bool boundsValid = false;
 
+        if (miniBatch)
+        {
+            if (a == 0 && (flags & KMEANS_USE_INITIAL_LABELS))
+            {
+                centers = Scalar(0);
+                for (int k = 0; k < K; k++)
+                    counters[k] = 0;
+                for (int i = 0; i < N; i++)
+                {
+                    const float* sample = data.ptr<float>(i);
+                    float* center = centers.ptr<float>(labels[i]);
+                    for (int j = 0; j < dims; j++)
+                        center[j] += sample[j];
+                    counters[labels[i]]++;
+                }
+                for (int k = 0; k < K; k++)
+                {
+                    float* center = centers.ptr<float>(k);
+                    if (counters[k] == 0)
+                        data.row(rng.uniform(0, N)).copyTo(centers.row(k));
+                    else
+                        for (int j = 0; j < dims; j++)
+                            center[j] /= counters[k];
+                }
+            }
+            else
+            {
+                // initial centers are selected from a random subset of the samples
+                const int initSize = std::min(N, std::max(batchSize*3, K));
+                Mat subset(initSize, dims, CV_32F);
+                for (int i = 0; i < initSize; i++)
+                    data.row(rng.uniform(0, N)).copyTo(subset.row(i));
+                if (flags & KMEANS_PP_CENTERS)
+                    generateCentersPP(subset, centers, K, rng, SPP_TRIALS);
+                else
+                {
+                    for (int k = 0; k < K; k++)
+                        subset.row(rng.uniform(0, initSize)).copyTo(centers.row(k));
+                }
+            }
+
+            kmeansMiniBatchIterations(data, centers, batchSize, criteria, rng);
+
+            parallel_for_(Range(0, N), KMeansDistanceComputer<false>(dists.data(), labels, data, centers), (double)divUp((size_t)(dims * N * K), CV_KMEANS_PARALLEL_GRANULARITY));
+            compactness = sum(Mat(Size(N, 1), CV_64F, &dists[0]))[0];
+        }
+        else
         for (int iter = 0; ;)
         {
             double max_center_shift = iter == 0 ? DBL_MAX : 0.0;
@@ -394,6 +649,12 @@ double cv::kmeans( InputArray _data, int K,
                     counters[max_k]--;
                     counters[k]++;
                     labels[farthest_i] = k;
+                    if (useHamerly)
+                    {
+                        // force full update of the moved sample
+                        upper[farthest_i] = DBL_MAX;
+                        lower[farthest_i] = 0;
+                    }
 
                     const float* sample = data.ptr<float>(farthest_i);
                     float* cur_center = centers.ptr<float>(k);
@@ -425,6 +686,9 @@ double cv::kmeans( InputArray _data, int K,
                         max_center_shift = std::max(max_center_shift, dist);
                     }
                 }
+
+                if (useHamerly && boundsValid)
+                    updateHamerlyBounds(centers, old_centers, labels, upper.data(), lower.data(), shift.data(), N);
             }
 
             bool isLastIter = (++iter == MAX(criteria.maxCount, 2) || max_center_shift <= criteria.epsilon);
@@ -436,6 +700,14 @@ double cv::kmeans( InputArray _data, int K,
                 compactness = sum(Mat(Size(N, 1), CV_64F, &dists[0]))[0];
                 break;
             }
+            else if (useHamerly)
+            {
+                // assign labels, the first pass computes all the distances to initialize the bounds
+                if (boundsValid)
+                    parallel_for_(Range(0, K), KMeansCenterDistanceComputer(halfDist.data(), centers), (double)divUp((size_t)(dims * K * K), CV_KMEANS_PARALLEL_GRANULARITY));
+                parallel_for_(Range(0, N), KMeansHamerlyComputer(dists.data(), labels, upper.data(), lower.data(), data, centers, halfDist.data(), !boundsValid), (double)divUp((size_t)(dims * N * K), CV_KMEANS_PARALLEL_GRANULARITY));
+                boundsValid = true;
+            }
             else
             {
                 // assign labels
@@ -42,6 +42,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include <opencv2/core/utils/configuration.private.hpp>
 #include <opencv2/core/utils/logger.hpp>
 
 #include "opencl_kernels_core.hpp"
@@ -277,12 +278,60 @@ static bool ocl_gemm( InputArray matA, InputArray matB, double alpha,
 
 namespace hal {
 
+// minimal M*N*K of single precision GEMM which is processed by the packed kernels (0 - disabled)
+static size_t getGemmPackedThreshold()
+{
+    static size_t value = utils::getConfigurationParameterSizeT("OPENCV_CORE_GEMM_PACKED_THRESHOLD", 64*64*64);
+    return value;
+}
+
+static bool gemm32fPacked(const float* src1, size_t src1_step, const float* src2, size_t src2_step,
+                          float alpha, const float* src3, size_t src3_step, float beta, float* dst, size_t dst_step,
+                          int m_a, int n_a, int n_d, int flags)
+{
+    const size_t threshold = getGemmPackedThreshold();
+    const int M = (flags & GEMM_1_T) ? n_a : m_a;
+    const int K = (flags & GEMM_1_T) ? m_a : n_a;
+    const int N = n_d;
+    if (threshold == 0 || (uint64_t)M * N * K < threshold || M < 8 || N < 8)
+        return false;
+    const size_t esz = sizeof(float);
+    if (src1_step % esz != 0 || src2_step % esz != 0 || dst_step % esz != 0 || src3_step % esz != 0)
+        return false;
+    const bool haveC = src3 && beta != 0.f;
+    if (haveC && (flags & GEMM_3_T) && src3 == dst)
+        return false;
+
+    // the packed kernels accumulate into destination, so it is initialized by op(C) first
+    if (haveC && (src3 != dst || src3_step != dst_step))
+    {
+        Mat C = (flags & GEMM_3_T) ? Mat(N, M, CV_32F, (void*)src3, src3_step) : Mat(M, N, CV_32F, (void*)src3, src3_step);
+        Mat D(M, N, CV_32F, dst, dst_step);
+        if (flags & GEMM_3_T)
+            transpose(C, D);
+        else
+            C.copyTo(D);
+    }
+
+    int lda0 = (int)(src1_step / esz), lda1 = 1;
+    if (flags & GEMM_1_T)
+        std::swap(lda0, lda1);
+    int ldb0 = (int)(src2_step / esz), ldb1 = 1;
+    if (flags & GEMM_2_T)
+        std::swap(ldb0, ldb1);
+    fastGemm(M, N, K, alpha, src1, lda0, lda1, src2, ldb0, ldb1,
+             haveC ? beta : 0.f, dst, (int)(dst_step / esz), true);
+    return true;
+}
+
 void gemm32f(const float* src1, size_t src1_step, const float* src2, size_t src2_step,
              float alpha, const float* src3, size_t src3_step, float beta, float* dst, size_t dst_step,
              int m_a, int n_a, int n_d, int flags)
 {
     CV_INSTRUMENT_REGION();
     CALL_HAL(gemm32f, cv_hal_gemm32f, src1, src1_step, src2, src2_step, alpha, src3, src3_step, beta, dst, dst_step, m_a, n_a, n_d, flags)
+    if (gemm32fPacked(src1, src1_step, src2, src2_step, alpha, src3, src3_step, beta, dst, dst_step, m_a, n_a, n_d, flags))
+        return;
 #ifdef CV_GEMM_BASELINE_ONLY
     CV_CPU_CALL_BASELINE(gemm32f, (src1, src1_step, src2, src2_step, alpha, src3, src3_step, beta, dst, dst_step, m_a, n_a, n_d, flags));
 #else
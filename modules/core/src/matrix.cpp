@@ -4,6 +4,8 @@
 
 #include "precomp.hpp"
 #include "bufferpool.impl.hpp"
+#include "opencv2/core/utils/allocator_pool.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
 
 namespace cv {
 
@@ -179,7 +181,8 @@ public:
 static
 MatAllocator*& getDefaultAllocatorMatRef()
 {
-    static MatAllocator* g_matAllocator = Mat::getStdAllocator();
+    static MatAllocator* g_matAllocator = utils::getConfigurationParameterBool("OPENCV_ALLOC_POOL", false)
+            ? utils::getPoolAllocator() : Mat::getStdAllocator();
     return g_matAllocator;
 }
 
@@ -200,6 +200,144 @@ static MatOp_Initializer* getGlobalMatOpInitializer()
     CV_SINGLETON_LAZY_INIT(MatOp_Initializer, new MatOp_Initializer())
 }
 
+namespace detail {
+
+/** Fused element-wise expression: operands and program in postfix notation.
+ *
+ * Program is evaluated by blocks of elements (block data stays in L1 cache),
+ * so the whole expression is computed in a single pass over memory.
+ */
+struct MatExprFusedData
+{
+    enum
+    {
+        OP_LOAD = 0,  //!< push operand 'arg'
+        OP_AFFINE,    //!< x*alpha + gamma
+        OP_ADD,       //!< x*alpha + y*beta + gamma
+        OP_MUL,       //!< x*y*alpha
+        OP_DIV,       //!< x*alpha/y
+        OP_RECIP,     //!< alpha/x
+        OP_ABS,       //!< |x|
+        OP_MIN,       //!< min(x, y)
+        OP_MAX,       //!< max(x, y)
+        OP_CMP        //!< compare(x, gamma) with cmpop 'arg', 8U mask result (last instruction only)
+    };
+
+    struct Instr
+    {
+        int op;
+        int arg;
+        double alpha, beta, gamma;
+    };
+
+    std::vector<Mat> operands;
+    std::vector<Instr> program;
+
+    static const int MAX_OPERANDS = 16;
+    static const int MAX_STACK = 8;
+    static const int BLOCK_SIZE = 256;  // elements
+
+    bool isMask() const { return !program.empty() && program.back().op == OP_CMP; }
+};
+
+} // namespace detail
+
+/** Keeps fused data in MatExpr::c, so MatExpr layout is not changed: 1x1 header over the data object
+ * with reference counted UMatData owning it.
+ */
+class MatExprFusedDataAllocator CV_FINAL : public MatAllocator
+{
+public:
+    typedef detail::MatExprFusedData Data;
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data, size_t* step, AccessFlag flags, UMatUsageFlags usageFlags) const CV_OVERRIDE
+    {
+        return Mat::getDefaultAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        return u != 0;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        delete (Ptr<Data>*)u->userdata;
+        u->userdata = 0;
+        delete u;
+    }
+
+    Mat wrap(const Ptr<Data>& d) const
+    {
+        Mat m(1, 1, CV_8U, (void*)d.get());
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = m.data;
+        u->size = 1;
+        u->flags |= UMatData::USER_ALLOCATED;
+        u->userdata = new Ptr<Data>(d);
+        u->refcount = 1;
+        m.u = u;
+        return m;
+    }
+
+    const Data& get(const Mat& holder) const
+    {
+        CV_DbgAssert(holder.u && holder.u->currAllocator == this);
+        return **(const Ptr<Data>*)holder.u->userdata;
+    }
+};
+
+static const MatExprFusedDataAllocator& getMatExprFusedDataAllocator()
+{
+    CV_SINGLETON_LAZY_INIT_REF(MatExprFusedDataAllocator, new MatExprFusedDataAllocator())
+}
+
+class MatOp_Fused CV_FINAL : public MatOp
+{
+public:
+    typedef detail::MatExprFusedData Data;
+
+    MatOp_Fused() {}
+    virtual ~MatOp_Fused() {}
+
+    bool elementWise(const MatExpr& /*expr*/) const CV_OVERRIDE { return true; }
+    void assign(const MatExpr& expr, Mat& m, int type=-1) const CV_OVERRIDE;
+
+    void roi(const MatExpr& expr, const Range& rowRange, const Range& colRange, MatExpr& res) const CV_OVERRIDE;
+    void diag(const MatExpr& expr, int d, MatExpr& res) const CV_OVERRIDE;
+
+    Size size(const MatExpr& expr) const CV_OVERRIDE;
+    int type(const MatExpr& expr) const CV_OVERRIDE;
+
+    static bool isFusable(const MatExpr& e);
+    static bool makeExpr(MatExpr& res, int op, const MatExpr& e1, const MatExpr& e2,
+                         double alpha=1, double beta=1, double gamma=0);
+    static bool makeExpr(MatExpr& res, int op, const MatExpr& e,
+                         double alpha=1, double gamma=0, int arg=0);
+
+protected:
+    static bool append(const MatExpr& e, Data& d);
+    static int addOperand(const Mat& m, Data& d);
+    static void addInstr(Data& d, int op, int arg=0, double alpha=1, double beta=1, double gamma=0);
+    static bool finalize(MatExpr& res, const Ptr<Data>& d);
+
+    static void makeFused(MatExpr& res, const Ptr<Data>& d);
+    static const Data& data(const MatExpr& e) { return getMatExprFusedDataAllocator().get(e.c); }
+};
+
+static MatOp_Fused g_MatOp_Fused;
+
+void MatOp_Fused::makeFused(MatExpr& res, const Ptr<Data>& d)
+{
+    res = MatExpr(&g_MatOp_Fused, 0, d->operands[0], Mat(), getMatExprFusedDataAllocator().wrap(d));
+}
+
 static inline bool isIdentity(const MatExpr& e) { return e.op == &g_MatOp_Identity; }
 static inline bool isAddEx(const MatExpr& e) { return e.op == &g_MatOp_AddEx; }
 static inline bool isScaled(const MatExpr& e) { return isAddEx(e) && (!e.b.data || e.beta == 0) && e.s == Scalar(); }
@@ -212,6 +350,10 @@ static inline bool isSolve(const MatExpr& e) { return e.op == &g_MatOp_Solve; }
 //static inline bool isGEMM(const MatExpr& e) { return e.op == &g_MatOp_GEMM; }
 static inline bool isMatProd(const MatExpr& e) { return e.op == &g_MatOp_GEMM && (!e.c.data || e.beta == 0); }
 static inline bool isInitializer(const MatExpr& e) { return e.op == getGlobalMatOpInitializer(); }
+static inline bool isFused(const MatExpr& e) { return e.op == &g_MatOp_Fused; }
+// operands which are merged into MatOp_AddEx / MatOp_Bin expressions without evaluation
+static inline bool isSimpleSumOperand(const MatExpr& e) { return isIdentity(e) || (isAddEx(e) && (!e.b.data || e.beta == 0)); }
+static inline bool isSimpleMulOperand(const MatExpr& e) { return isIdentity(e) || isScaled(e) || isReciprocal(e); }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -327,6 +469,10 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( (!isSimpleSumOperand(e1) || !isSimpleSumOperand(e2)) &&
+        MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_ADD, e1, e2, 1, 1) )
+        return;
+
     if( this == e2.op )
     {
         double alpha = 1, beta = 1;
@@ -360,6 +506,10 @@ void MatOp::add(const MatExpr& expr1, const Scalar& s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr1) && s.isReal() &&
+        MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_AFFINE, expr1, 1, s[0]) )
+        return;
+
     Mat m1;
     expr1.op->assign(expr1, m1);
     MatOp_AddEx::makeExpr(res, m1, Mat(), 1, 0, s);
@@ -370,6 +520,10 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( (!isSimpleSumOperand(e1) || !isSimpleSumOperand(e2)) &&
+        MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_ADD, e1, e2, 1, -1) )
+        return;
+
     if( this == e2.op )
     {
         double alpha = 1, beta = -1;
@@ -403,6 +557,10 @@ void MatOp::subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && s.isReal() &&
+        MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_AFFINE, expr, -1, s[0]) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), -1, 0, s);
@@ -413,6 +571,10 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
 {
     CV_INSTRUMENT_REGION();
 
+    if( (!isSimpleMulOperand(e1) || !isSimpleMulOperand(e2)) &&
+        MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_MUL, e1, e2, scale) )
+        return;
+
     if( this == e2.op )
     {
         Mat m1, m2;
@@ -466,6 +628,9 @@ void MatOp::multiply(const MatExpr& expr, double s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_AFFINE, expr, s, 0) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), s, 0);
@@ -476,6 +641,10 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
 {
     CV_INSTRUMENT_REGION();
 
+    if( (!isSimpleMulOperand(e1) || !isSimpleMulOperand(e2)) &&
+        MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_DIV, e1, e2, scale) )
+        return;
+
     if( this == e2.op )
     {
         if( isReciprocal(e1) && isReciprocal(e2) )
@@ -518,6 +687,9 @@ void MatOp::divide(double s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_RECIP, expr, s) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, '/', m, Mat(), s);
@@ -528,6 +700,9 @@ void MatOp::abs(const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatOp_Fused::Data::OP_ABS, expr) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, 'a', m, Mat());
@@ -966,6 +1141,22 @@ MatExpr operator < (double s, const Mat& a)
     return e;
 }
 
+MatExpr operator < (const MatExpr& e, double s)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_LT) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_LT, (Mat)e, s);
+    return en;
+}
+
+MatExpr operator < (double s, const MatExpr& e)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_GT) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_GT, (Mat)e, s);
+    return en;
+}
+
 MatExpr operator <= (const Mat& a, const Mat& b)
 {
     checkOperandsExist(a, b);
@@ -990,6 +1181,22 @@ MatExpr operator <= (double s, const Mat& a)
     return e;
 }
 
+MatExpr operator <= (const MatExpr& e, double s)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_LE) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_LE, (Mat)e, s);
+    return en;
+}
+
+MatExpr operator <= (double s, const MatExpr& e)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_GE) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_GE, (Mat)e, s);
+    return en;
+}
+
 MatExpr operator == (const Mat& a, const Mat& b)
 {
     checkOperandsExist(a, b);
@@ -1014,6 +1221,22 @@ MatExpr operator == (double s, const Mat& a)
     return e;
 }
 
+MatExpr operator == (const MatExpr& e, double s)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_EQ) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_EQ, (Mat)e, s);
+    return en;
+}
+
+MatExpr operator == (double s, const MatExpr& e)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_EQ) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_EQ, (Mat)e, s);
+    return en;
+}
+
 MatExpr operator != (const Mat& a, const Mat& b)
 {
     checkOperandsExist(a, b);
@@ -1038,6 +1261,22 @@ MatExpr operator != (double s, const Mat& a)
     return e;
 }
 
+MatExpr operator != (const MatExpr& e, double s)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_NE) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_NE, (Mat)e, s);
+    return en;
+}
+
+MatExpr operator != (double s, const MatExpr& e)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_NE) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_NE, (Mat)e, s);
+    return en;
+}
+
 MatExpr operator >= (const Mat& a, const Mat& b)
 {
     checkOperandsExist(a, b);
@@ -1062,6 +1301,22 @@ MatExpr operator >= (double s, const Mat& a)
     return e;
 }
 
+MatExpr operator >= (const MatExpr& e, double s)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_GE) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_GE, (Mat)e, s);
+    return en;
+}
+
+MatExpr operator >= (double s, const MatExpr& e)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_LE) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_LE, (Mat)e, s);
+    return en;
+}
+
 MatExpr operator > (const Mat& a, const Mat& b)
 {
     checkOperandsExist(a, b);
@@ -1086,6 +1341,22 @@ MatExpr operator > (double s, const Mat& a)
     return e;
 }
 
+MatExpr operator > (const MatExpr& e, double s)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_GT) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_GT, (Mat)e, s);
+    return en;
+}
+
+MatExpr operator > (double s, const MatExpr& e)
+{
+    MatExpr en;
+    if( isIdentity(e) || !MatOp_Fused::makeExpr(en, MatOp_Fused::Data::OP_CMP, e, 1, s, CV_CMP_LT) )
+        MatOp_Cmp::makeExpr(en, CV_CMP_LT, (Mat)e, s);
+    return en;
+}
+
 MatExpr min(const Mat& a, const Mat& b)
 {
     CV_INSTRUMENT_REGION();
@@ -1714,6 +1985,493 @@ inline void MatOp_Initializer::makeExpr(MatExpr& res, int method, int ndims, con
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+typedef detail::MatExprFusedData FusedData;
+
+struct FusedCmpEQ { template<typename V> static inline V vop(const V& a, const V& b) { return v_eq(a, b); } template<typename T> static inline bool op(T a, T b) { return a == b; } };
+struct FusedCmpNE { template<typename V> static inline V vop(const V& a, const V& b) { return v_ne(a, b); } template<typename T> static inline bool op(T a, T b) { return a != b; } };
+struct FusedCmpLT { template<typename V> static inline V vop(const V& a, const V& b) { return v_lt(a, b); } template<typename T> static inline bool op(T a, T b) { return a < b; } };
+struct FusedCmpLE { template<typename V> static inline V vop(const V& a, const V& b) { return v_le(a, b); } template<typename T> static inline bool op(T a, T b) { return a <= b; } };
+struct FusedCmpGT { template<typename V> static inline V vop(const V& a, const V& b) { return v_gt(a, b); } template<typename T> static inline bool op(T a, T b) { return a > b; } };
+struct FusedCmpGE { template<typename V> static inline V vop(const V& a, const V& b) { return v_ge(a, b); } template<typename T> static inline bool op(T a, T b) { return a >= b; } };
+
+template<class Cmp> static void fusedCompare(const float* x, uchar* dst, int n, float t)
+{
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int w = VTraits<v_float32>::vlanes();
+    v_float32 vt = vx_setall_f32(t);
+    for( ; i <= n - 4*w; i += 4*w )
+    {
+        v_uint32 m0 = v_reinterpret_as_u32(Cmp::vop(vx_load(x + i), vt));
+        v_uint32 m1 = v_reinterpret_as_u32(Cmp::vop(vx_load(x + i + w), vt));
+        v_uint32 m2 = v_reinterpret_as_u32(Cmp::vop(vx_load(x + i + 2*w), vt));
+        v_uint32 m3 = v_reinterpret_as_u32(Cmp::vop(vx_load(x + i + 3*w), vt));
+        v_store(dst + i, v_pack(v_pack(m0, m1), v_pack(m2, m3)));
+    }
+#endif
+    for( ; i < n; i++ )
+        dst[i] = Cmp::op(x[i], t) ? (uchar)255 : (uchar)0;
+}
+
+template<class Cmp> static void fusedCompare(const double* x, uchar* dst, int n, double t)
+{
+    for( int i = 0; i < n; i++ )
+        dst[i] = Cmp::op(x[i], t) ? (uchar)255 : (uchar)0;
+}
+
+template<typename T> static void fusedCompare(int cmpop, const T* x, uchar* dst, int n, T t)
+{
+    switch( cmpop )
+    {
+    case CMP_EQ: fusedCompare<FusedCmpEQ>(x, dst, n, t); break;
+    case CMP_NE: fusedCompare<FusedCmpNE>(x, dst, n, t); break;
+    case CMP_LT: fusedCompare<FusedCmpLT>(x, dst, n, t); break;
+    case CMP_LE: fusedCompare<FusedCmpLE>(x, dst, n, t); break;
+    case CMP_GT: fusedCompare<FusedCmpGT>(x, dst, n, t); break;
+    case CMP_GE: fusedCompare<FusedCmpGE>(x, dst, n, t); break;
+    default: CV_Error(cv::Error::StsBadArg, "Unknown comparison method");
+    }
+}
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+static inline v_float32 fusedSetall(float v) { return vx_setall_f32(v); }
+#endif
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+static inline v_float64 fusedSetall(double v) { return vx_setall_f64(v); }
+#endif
+
+// processes the vectorizable head of the block, returns the number of processed elements
+template<typename T, typename V> static int fusedUnaryVec(const FusedData::Instr& ins, const T* x, T* y, int n)
+{
+    const int w = VTraits<V>::vlanes();
+    V va = fusedSetall((T)ins.alpha), vg = fusedSetall((T)ins.gamma);
+    int i = 0;
+    switch( ins.op )
+    {
+    case FusedData::OP_AFFINE:
+        for( ; i <= n - w; i += w )
+            v_store(y + i, v_add(v_mul(vx_load(x + i), va), vg));
+        break;
+    case FusedData::OP_RECIP:
+        for( ; i <= n - w; i += w )
+            v_store(y + i, v_div(va, vx_load(x + i)));
+        break;
+    case FusedData::OP_ABS:
+        for( ; i <= n - w; i += w )
+            v_store(y + i, v_abs(vx_load(x + i)));
+        break;
+    }
+    return i;
+}
+
+template<typename T, typename V> static int fusedBinaryVec(const FusedData::Instr& ins, const T* x, const T* y, T* z, int n)
+{
+    const int w = VTraits<V>::vlanes();
+    V va = fusedSetall((T)ins.alpha), vb = fusedSetall((T)ins.beta), vg = fusedSetall((T)ins.gamma);
+    int i = 0;
+    switch( ins.op )
+    {
+    case FusedData::OP_ADD:
+        for( ; i <= n - w; i += w )
+            v_store(z + i, v_add(v_add(v_mul(vx_load(x + i), va), v_mul(vx_load(y + i), vb)), vg));
+        break;
+    case FusedData::OP_MUL:
+        for( ; i <= n - w; i += w )
+            v_store(z + i, v_mul(v_mul(vx_load(x + i), va), vx_load(y + i)));
+        break;
+    case FusedData::OP_DIV:
+        for( ; i <= n - w; i += w )
+            v_store(z + i, v_div(v_mul(vx_load(x + i), va), vx_load(y + i)));
+        break;
+    case FusedData::OP_MIN:
+        for( ; i <= n - w; i += w )
+            v_store(z + i, v_min(vx_load(x + i), vx_load(y + i)));
+        break;
+    case FusedData::OP_MAX:
+        for( ; i <= n - w; i += w )
+            v_store(z + i, v_max(vx_load(x + i), vx_load(y + i)));
+        break;
+    }
+    return i;
+}
+
+static inline int fusedUnarySimd(const FusedData::Instr& ins, const float* x, float* y, int n)
+{
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    return fusedUnaryVec<float, v_float32>(ins, x, y, n);
+#else
+    CV_UNUSED(ins); CV_UNUSED(x); CV_UNUSED(y); CV_UNUSED(n);
+    return 0;
+#endif
+}
+
+static inline int fusedUnarySimd(const FusedData::Instr& ins, const double* x, double* y, int n)
+{
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+    return fusedUnaryVec<double, v_float64>(ins, x, y, n);
+#else
+    CV_UNUSED(ins); CV_UNUSED(x); CV_UNUSED(y); CV_UNUSED(n);
+    return 0;
+#endif
+}
+
+static inline int fusedBinarySimd(const FusedData::Instr& ins, const float* x, const float* y, float* z, int n)
+{
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    return fusedBinaryVec<float, v_float32>(ins, x, y, z, n);
+#else
+    CV_UNUSED(ins); CV_UNUSED(x); CV_UNUSED(y); CV_UNUSED(z); CV_UNUSED(n);
+    return 0;
+#endif
+}
+
+static inline int fusedBinarySimd(const FusedData::Instr& ins, const double* x, const double* y, double* z, int n)
+{
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+    return fusedBinaryVec<double, v_float64>(ins, x, y, z, n);
+#else
+    CV_UNUSED(ins); CV_UNUSED(x); CV_UNUSED(y); CV_UNUSED(z); CV_UNUSED(n);
+    return 0;
+#endif
+}
+
+template<typename T> static void fusedUnary(const FusedData::Instr& ins, const T* x, T* y, int n)
+{
+    const T alpha = (T)ins.alpha, gamma = (T)ins.gamma;
+    int i = fusedUnarySimd(ins, x, y, n);
+    switch( ins.op )
+    {
+    case FusedData::OP_AFFINE:
+        for( ; i < n; i++ )
+            y[i] = x[i]*alpha + gamma;
+        break;
+    case FusedData::OP_RECIP:
+        for( ; i < n; i++ )
+            y[i] = alpha/x[i];
+        break;
+    case FusedData::OP_ABS:
+        for( ; i < n; i++ )
+            y[i] = std::abs(x[i]);
+        break;
+    default:
+        CV_Error(cv::Error::StsInternal, "Invalid unary operation of fused expression");
+    }
+}
+
+template<typename T> static void fusedBinary(const FusedData::Instr& ins, const T* x, const T* y, T* z, int n)
+{
+    const T alpha = (T)ins.alpha, beta = (T)ins.beta, gamma = (T)ins.gamma;
+    int i = fusedBinarySimd(ins, x, y, z, n);
+    switch( ins.op )
+    {
+    case FusedData::OP_ADD:
+        for( ; i < n; i++ )
+            z[i] = x[i]*alpha + y[i]*beta + gamma;
+        break;
+    case FusedData::OP_MUL:
+        for( ; i < n; i++ )
+            z[i] = x[i]*alpha*y[i];
+        break;
+    case FusedData::OP_DIV:
+        for( ; i < n; i++ )
+            z[i] = x[i]*alpha/y[i];
+        break;
+    case FusedData::OP_MIN:
+        for( ; i < n; i++ )
+            z[i] = std::min(x[i], y[i]);
+        break;
+    case FusedData::OP_MAX:
+        for( ; i < n; i++ )
+            z[i] = std::max(x[i], y[i]);
+        break;
+    default:
+        CV_Error(cv::Error::StsInternal, "Invalid binary operation of fused expression");
+    }
+}
+
+static inline bool isFusedBinaryOp(int op)
+{
+    return op == FusedData::OP_ADD || op == FusedData::OP_MUL || op == FusedData::OP_DIV ||
+           op == FusedData::OP_MIN || op == FusedData::OP_MAX;
+}
+
+/** Evaluates the program over 'len' elements: by blocks, intermediate results are kept in stack buffers */
+template<typename T> static void runFusedProgram(const FusedData& d, const T* const* srcs, uchar* dst, int len)
+{
+    T buf[FusedData::MAX_STACK][FusedData::BLOCK_SIZE];
+    const T* stack[FusedData::MAX_STACK];
+    const int ninstr = (int)d.program.size();
+    const int esz = d.isMask() ? 1 : (int)sizeof(T);
+
+    for( int x = 0; x < len; x += FusedData::BLOCK_SIZE )
+    {
+        const int n = std::min(len - x, (int)FusedData::BLOCK_SIZE);
+        int sp = 0;
+        for( int i = 0; i < ninstr; i++ )
+        {
+            const FusedData::Instr& ins = d.program[i];
+            if( ins.op == FusedData::OP_LOAD )
+            {
+                stack[sp++] = srcs[ins.arg] + x;
+                continue;
+            }
+            if( ins.op == FusedData::OP_CMP )
+            {
+                fusedCompare(ins.arg, stack[sp - 1], dst + x, n, (T)ins.gamma);
+                break;
+            }
+            const bool binary = isFusedBinaryOp(ins.op);
+            if( binary )
+                sp--;
+            // the last instruction writes into the destination directly
+            T* out = i == ninstr - 1 ? (T*)(dst + (size_t)x*esz) : buf[sp - 1];
+            if( binary )
+                fusedBinary(ins, stack[sp - 1], stack[sp], out, n);
+            else
+                fusedUnary(ins, stack[sp - 1], out, n);
+            stack[sp - 1] = out;
+        }
+    }
+}
+
+template<typename T> class FusedExprInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    FusedExprInvoker(const FusedData& d_, Mat& dst_, int rowLen_, int chunk_)
+        : d(d_), dst(dst_), rowLen(rowLen_), chunk(chunk_), chunksPerRow((rowLen_ + chunk_ - 1)/chunk_)
+    {}
+
+    void operator()(const Range& r) const CV_OVERRIDE
+    {
+        const T* srcs[FusedData::MAX_OPERANDS];
+        const int nops = (int)d.operands.size();
+        const size_t desz = dst.elemSize1();
+        for( int task = r.start; task < r.end; task++ )
+        {
+            const int y = task / chunksPerRow, x0 = (task % chunksPerRow)*chunk;
+            const int len = std::min(rowLen - x0, chunk);
+            for( int k = 0; k < nops; k++ )
+                srcs[k] = d.operands[k].ptr<T>(y) + x0;
+            runFusedProgram<T>(d, srcs, dst.ptr(y) + x0*desz, len);
+        }
+    }
+
+protected:
+    const FusedData& d;
+    Mat& dst;
+    int rowLen, chunk, chunksPerRow;
+};
+
+template<typename T> static void evalFusedExpr(const FusedData& d, Mat& dst)
+{
+    const Mat& src0 = d.operands[0];
+    bool continuous = dst.isContinuous();
+    for( size_t k = 0; k < d.operands.size(); k++ )
+        continuous = continuous && d.operands[k].isContinuous();
+
+    const int rows = continuous ? 1 : src0.rows;
+    const int rowLen = (int)(continuous ? src0.total() : (size_t)src0.cols)*src0.channels();
+    const int chunk = 1 << 14;  // elements
+    const int tasks = rows*((rowLen + chunk - 1)/chunk);
+    FusedExprInvoker<T> invoker(d, dst, rowLen, chunk);
+    if( (size_t)rows*rowLen >= (size_t)(chunk*2) && tasks > 1 )
+        parallel_for_(Range(0, tasks), invoker);
+    else
+        invoker(Range(0, tasks));
+}
+
+bool MatOp_Fused::isFusable(const MatExpr& e)
+{
+    int depth = e.a.depth();
+    if( e.a.empty() || e.a.dims > 2 || (depth != CV_32F && depth != CV_64F) )
+        return false;
+    if( isFused(e) )
+        return !data(e).isMask();
+    // the second operand may be a scalar packed into a Mat, e.g. in A.mul(Scalar(...))
+    if( e.b.data && (e.b.type() != e.a.type() || e.b.size() != e.a.size()) )
+        return false;
+    if( isIdentity(e) || isAddEx(e) )
+        return true;
+    if( e.op == &g_MatOp_Bin )
+        return e.flags == '*' || e.flags == '/' || e.flags == 'a' || e.flags == 'm' || e.flags == 'M';
+    return false;
+}
+
+int MatOp_Fused::addOperand(const Mat& m, Data& d)
+{
+    for( size_t k = 0; k < d.operands.size(); k++ )
+    {
+        const Mat& o = d.operands[k];
+        if( o.data == m.data && o.step[0] == m.step[0] )
+            return (int)k;
+    }
+    d.operands.push_back(m);
+    return (int)d.operands.size() - 1;
+}
+
+void MatOp_Fused::addInstr(Data& d, int op, int arg, double alpha, double beta, double gamma)
+{
+    Data::Instr ins = { op, arg, alpha, beta, gamma };
+    d.program.push_back(ins);
+}
+
+bool MatOp_Fused::append(const MatExpr& e, Data& d)
+{
+    if( !isFusable(e) )
+        return false;
+    if( !d.operands.empty() && (e.a.type() != d.operands[0].type() || e.a.size() != d.operands[0].size()) )
+        return false;
+
+    double gamma = e.s[0];
+    const int cn = e.a.channels();
+    for( int i = 1; i < cn; i++ )
+        if( e.s[i] != gamma )
+            return false;
+
+    if( isFused(e) )
+    {
+        const Data& src = data(e);
+        for( size_t i = 0; i < src.program.size(); i++ )
+        {
+            Data::Instr ins = src.program[i];
+            if( ins.op == Data::OP_LOAD )
+                ins.arg = addOperand(src.operands[ins.arg], d);
+            d.program.push_back(ins);
+        }
+    }
+    else if( isIdentity(e) )
+        addInstr(d, Data::OP_LOAD, addOperand(e.a, d));
+    else if( isAddEx(e) )
+    {
+        addInstr(d, Data::OP_LOAD, addOperand(e.a, d));
+        if( e.b.data && e.beta != 0 )
+        {
+            addInstr(d, Data::OP_LOAD, addOperand(e.b, d));
+            addInstr(d, Data::OP_ADD, 0, e.alpha, e.beta, gamma);
+        }
+        else
+            addInstr(d, Data::OP_AFFINE, 0, e.alpha, 0, gamma);
+    }
+    else
+    {
+        addInstr(d, Data::OP_LOAD, addOperand(e.a, d));
+        if( e.b.data )
+            addInstr(d, Data::OP_LOAD, addOperand(e.b, d));
+        switch( e.flags )
+        {
+        case '*':
+            addInstr(d, Data::OP_MUL, 0, e.alpha);
+            break;
+        case '/':
+            addInstr(d, e.b.data ? Data::OP_DIV : Data::OP_RECIP, 0, e.alpha);
+            break;
+        case 'a':
+            if( e.b.data )
+                addInstr(d, Data::OP_ADD, 0, 1, -1, 0);
+            else
+                addInstr(d, Data::OP_AFFINE, 0, 1, 0, -gamma);
+            addInstr(d, Data::OP_ABS);
+            break;
+        case 'm':
+            addInstr(d, Data::OP_MIN);
+            break;
+        case 'M':
+            addInstr(d, Data::OP_MAX);
+            break;
+        }
+    }
+    return (int)d.operands.size() <= Data::MAX_OPERANDS;
+}
+
+bool MatOp_Fused::finalize(MatExpr& res, const Ptr<Data>& d)
+{
+    int sp = 0, maxsp = 0;
+    for( size_t i = 0; i < d->program.size(); i++ )
+    {
+        int op = d->program[i].op;
+        sp += op == Data::OP_LOAD ? 1 : isFusedBinaryOp(op) ? -1 : 0;
+        maxsp = std::max(maxsp, sp);
+    }
+    if( maxsp > Data::MAX_STACK || sp != 1 )
+        return false;
+    makeFused(res, d);
+    return true;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, int op, const MatExpr& e1, const MatExpr& e2,
+                           double alpha, double beta, double gamma)
+{
+    if( !isFusable(e1) || !isFusable(e2) )
+        return false;
+    Ptr<Data> d = makePtr<Data>();
+    if( !append(e1, *d) || !append(e2, *d) )
+        return false;
+    addInstr(*d, op, 0, alpha, beta, gamma);
+    return finalize(res, d);
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, int op, const MatExpr& e, double alpha, double gamma, int arg)
+{
+    if( !isFusable(e) )
+        return false;
+    Ptr<Data> d = makePtr<Data>();
+    if( !append(e, *d) )
+        return false;
+    addInstr(*d, op, arg, alpha, 0, gamma);
+    return finalize(res, d);
+}
+
+void MatOp_Fused::assign(const MatExpr& e, Mat& m, int _type) const
+{
+    CV_INSTRUMENT_REGION();
+
+    // keep references to operands, so they are not released if 'm' is one of them
+    Mat dref = e.c;
+    const Data& d = data(e);
+    const Mat& src0 = d.operands[0];
+    int dstType = type(e);
+    Mat temp, &dst = _type == -1 || _type == dstType ? m : temp;
+
+    dst.create(src0.size(), dstType);
+    if( src0.depth() == CV_32F )
+        evalFusedExpr<float>(d, dst);
+    else
+        evalFusedExpr<double>(d, dst);
+
+    if( dst.data != m.data )
+        dst.convertTo(m, _type);
+}
+
+void MatOp_Fused::roi(const MatExpr& e, const Range& rowRange, const Range& colRange, MatExpr& res) const
+{
+    Ptr<Data> d = makePtr<Data>(data(e));
+    for( size_t k = 0; k < d->operands.size(); k++ )
+        d->operands[k] = d->operands[k](rowRange, colRange);
+    makeFused(res, d);
+}
+
+void MatOp_Fused::diag(const MatExpr& e, int dd, MatExpr& res) const
+{
+    Ptr<Data> d = makePtr<Data>(data(e));
+    for( size_t k = 0; k < d->operands.size(); k++ )
+        d->operands[k] = d->operands[k].diag(dd);
+    makeFused(res, d);
+}
+
+Size MatOp_Fused::size(const MatExpr& e) const
+{
+    return data(e).operands[0].size();
+}
+
+int MatOp_Fused::type(const MatExpr& e) const
+{
+    const Data& d = data(e);
+    const Mat& src0 = d.operands[0];
+    return d.isMask() ? CV_8UC(src0.channels()) : src0.type();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 MatExpr Mat::t() const
 {
     CV_INSTRUMENT_REGION();
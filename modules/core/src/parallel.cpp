@@ -172,6 +172,28 @@ using namespace cv::parallel;
 
 namespace {
 
+    // thread-local parallel context, see ParallelForScope
+    struct ParallelScopeLimits
+    {
+        ParallelScopeLimits() : maxThreads(0), maxStripes(0) {}
+        int maxThreads;  // <= 0 - not limited
+        int maxStripes;  // <= 0 - not limited
+    };
+
+    static TLSData<ParallelScopeLimits>& getParallelScopeLimitsTLS()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(TLSData<ParallelScopeLimits>, new TLSData<ParallelScopeLimits>())
+    }
+
+    static inline int combineParallelLimits(int outer, int inner)
+    {
+        if (outer <= 0)
+            return inner;
+        if (inner <= 0)
+            return outer;
+        return std::min(outer, inner);
+    }
+
 #ifdef ENABLE_INSTRUMENTATION
     static void SyncNodes(cv::instr::InstrNode *pNode)
     {
@@ -210,6 +232,10 @@ namespace {
             double len = wholeRange.end - wholeRange.start;
             nstripes = cvRound(_nstripes <= 0 ? len : MIN(MAX(_nstripes, 1.), len));
 
+            scopeLimits = getParallelScopeLimitsTLS().getRef();
+            if (scopeLimits.maxStripes > 0)
+                nstripes = std::min(nstripes, scopeLimits.maxStripes);
+
             // propagate main thread state
             rng = cv::theRNG();
 #if OPENCV_SUPPORTS_FP_DENORMALS_HINT && OPENCV_IMPL_FP_HINTS
@@ -262,6 +288,7 @@ namespace {
         int nstripes;
         cv::RNG rng;
         mutable bool is_rng_used;
+        ParallelScopeLimits scopeLimits;
 #ifdef OPENCV_TRACE
         CV_TRACE_NS::details::Region* traceRootRegion;
         CV_TRACE_NS::details::TraceManagerThreadLocal* traceRootContext;
@@ -341,6 +368,9 @@ namespace {
 #if OPENCV_SUPPORTS_FP_DENORMALS_HINT && OPENCV_IMPL_FP_HINTS
             FPDenormalsIgnoreHintScope fp_denormals_scope(ctx.fp_denormals_base_state);
 #endif
+            ParallelScopeLimits& scopeLimits = getParallelScopeLimitsTLS().getRef();
+            const ParallelScopeLimits prevScopeLimits = scopeLimits;
+            scopeLimits = ctx.scopeLimits;
 
             cv::Range r;
             cv::Range wholeRange = ctx.wholeRange;
@@ -379,15 +409,43 @@ namespace {
             }
 #endif
 
+            scopeLimits = prevScopeLimits;
+
             if (!ctx.is_rng_used && !(cv::theRNG() == ctx.rng))
                 ctx.is_rng_used = true;
         }
         cv::Range stripeRange() const { return cv::Range(0, ctx.nstripes); }
+        const ParallelLoopBodyWrapperContext& context() const { return ctx; }
 
     protected:
         ParallelLoopBodyWrapperContext& ctx;
     };
 
+    // Runs stripes of the wrapped body by a fixed number of "thread slots", which pull stripes dynamically.
+    // Used to limit concurrency of a parallel_for_() call independently from the parallel backend.
+    class ParallelLoopBodyLimiter : public cv::ParallelLoopBody
+    {
+    public:
+        ParallelLoopBodyLimiter(const cv::ParallelLoopBody& stripesBody_, int nstripes_) :
+            stripesBody(stripesBody_), nstripes(nstripes_), nextStripe(0)
+        {
+        }
+        void operator()(const cv::Range& /*slots*/) const CV_OVERRIDE
+        {
+            for (;;)
+            {
+                int i = nextStripe.fetch_add(1);
+                if (i >= nstripes)
+                    break;
+                stripesBody(cv::Range(i, i + 1));
+            }
+        }
+    protected:
+        const cv::ParallelLoopBody& stripesBody;
+        const int nstripes;
+        mutable std::atomic<int> nextStripe;
+    };
+
 #if defined HAVE_TBB
     class ProxyLoopBody : public ParallelLoopBodyWrapper
     {
@@ -517,6 +575,16 @@ void parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, dou
     if (range.empty())
         return;
 
+    {
+        std::shared_ptr<ParallelForAPI>& api = getCurrentParallelForAPI();
+        if (api && dynamic_cast<ReentrantParallelForAPI*>(api.get()))
+        {
+            // backend handles nested and concurrent calls
+            parallel_for_impl(range, body, nstripes);
+            return;
+        }
+    }
+
     static std::atomic<bool> flagNestedParallelFor(false);
     bool isNotNestedRegion = !flagNestedParallelFor.load();
     if (isNotNestedRegion)
@@ -552,7 +620,8 @@ void parallel_for_cb(int start, int end, void* data)
 static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
 {
     using namespace cv::parallel;
-    if ((numThreads < 0 || numThreads > 1) && range.end - range.start > 1)
+    if ((numThreads < 0 || numThreads > 1) && range.end - range.start > 1 &&
+        getParallelScopeLimitsTLS().getRef().maxThreads != 1)
     {
         ParallelLoopBodyWrapperContext ctx(body, range, nstripes);
         ProxyLoopBody pbody(ctx);
@@ -563,6 +632,17 @@ static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody
             return;
         }
 
+        const int scopeMaxThreads = ctx.scopeLimits.maxThreads;
+        if (scopeMaxThreads > 0 && scopeMaxThreads < stripeRange.end - stripeRange.start)
+        {
+            // ParallelForScope: no more than scopeMaxThreads stripes are processed at the same time
+            CV_CheckEQ(stripeRange.start, 0, "");
+            ParallelLoopBodyLimiter limiter(pbody, stripeRange.end);
+            parallel_for_impl(cv::Range(0, scopeMaxThreads), limiter, scopeMaxThreads);
+            ctx.finalize();  // propagate exceptions if exists
+            return;
+        }
+
         std::shared_ptr<ParallelForAPI>& api = getCurrentParallelForAPI();
         if (api)
         {
@@ -631,7 +711,18 @@ static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody
 }
 
 
+static int getNumThreads_();
+
 int getNumThreads(void)
+{
+    int n = getNumThreads_();
+    const int scopeMaxThreads = getParallelScopeLimitsTLS().getRef().maxThreads;
+    if (scopeMaxThreads > 0)
+        n = std::max(1, std::min(n, scopeMaxThreads));
+    return n;
+}
+
+static int getNumThreads_()
 {
     std::shared_ptr<ParallelForAPI>& api = getCurrentParallelForAPI();
     if (api)
@@ -713,6 +804,22 @@ unsigned defaultNumberOfThreads()
     return result;
 }
 
+ParallelForScope::ParallelForScope(int maxThreads, int maxStripes)
+{
+    ParallelScopeLimits& limits = getParallelScopeLimitsTLS().getRef();
+    prevMaxThreads_ = limits.maxThreads;
+    prevMaxStripes_ = limits.maxStripes;
+    limits.maxThreads = combineParallelLimits(limits.maxThreads, maxThreads);
+    limits.maxStripes = combineParallelLimits(limits.maxStripes, maxStripes);
+}
+
+ParallelForScope::~ParallelForScope()
+{
+    ParallelScopeLimits& limits = getParallelScopeLimitsTLS().getRef();
+    limits.maxThreads = prevMaxThreads_;
+    limits.maxStripes = prevMaxStripes_;
+}
+
 void setNumThreads( int threads_ )
 {
     CV_UNUSED(threads_);
@@ -12,8 +12,20 @@ extern int numThreads;
 
 std::shared_ptr<ParallelForAPI>& getCurrentParallelForAPI();
 
+/** Builtin backends which handle concurrent and nested parallel_for() calls by themselves.
+ *
+ * Calls are forwarded to such backends without serialization of nested parallel regions.
+ */
+class ReentrantParallelForAPI : public ParallelForAPI
+{
+};
+
 #ifndef BUILD_PLUGIN
 
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendWorkStealing();
+#endif
+
 #ifdef HAVE_TBB
 std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendTBB();
 #endif
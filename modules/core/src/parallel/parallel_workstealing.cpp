@@ -0,0 +1,420 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "../precomp.hpp"
+
+#if !defined(BUILD_PLUGIN) && !defined(OPENCV_DISABLE_THREAD_SUPPORT)
+
+#include "parallel.hpp"
+#include "../parallel_impl.hpp"  // defaultNumberOfThreads()
+
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/logger.hpp>
+#include <opencv2/core/utils/tls.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+//
+// Work-stealing parallel_for() backend
+//
+// Each worker thread owns a deque of tasks. A task is a range of stripes of some parallel_for() job.
+// Executing thread splits the range in halves, pushes right halves into the back of its own deque and
+// processes the leftmost stripe. Idle threads steal tasks from the front of other deques (the largest ranges).
+// Threads which wait for job completion (including callers of nested parallel_for() and application
+// threads outside of the pool) execute available tasks instead of blocking, so independent jobs are
+// processed concurrently and nested parallel regions don't fall back to serial execution.
+//
+// Threads outside of the pool borrow one of the spare deques for the duration of their outermost
+// parallel_for() call, so concurrent callers never share a deque or a getThreadNum() value.
+// setNumThreads() waits until such calls are completed before the pool is recreated.
+//
+
+namespace cv { namespace parallel { namespace workstealing {
+
+static int CV_WORKSTEALING_ACTIVE_WAIT = (int)utils::getConfigurationParameterSizeT("OPENCV_PARALLEL_WORKSTEALING_ACTIVE_WAIT", 1000);  // iterations
+
+struct Job
+{
+    Job(int tasks, ParallelForAPI::FN_parallel_for_body_cb_t callback_, void* callback_data_)
+        : callback(callback_), callback_data(callback_data_), pending(tasks)
+    {}
+
+    const ParallelForAPI::FN_parallel_for_body_cb_t callback;
+    void* const callback_data;
+    std::atomic<int> pending;  // number of not completed stripes
+};
+
+struct Task
+{
+    Job* job;
+    int begin;
+    int end;
+};
+
+class TaskDeque
+{
+public:
+    void push(const Task& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+
+    // owner side: LIFO order keeps recently split (cache-hot) ranges on the same thread
+    bool pop(Task& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+            return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    // thief side: FIFO order takes the largest ranges
+    bool steal(Task& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+            return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+protected:
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+struct ThreadSlot
+{
+    ThreadSlot() : index(-1), depth(0), worker(false) {}
+    int index;    // deque index, -1 for threads outside of the pool which don't run a job
+    int depth;    // nesting level of parallel_for() calls of a thread outside of the pool
+    bool worker;
+};
+
+class ParallelForBackend CV_FINAL : public ReentrantParallelForAPI
+{
+public:
+    ParallelForBackend()
+        : numThreads(0), numWorkers(0), activeJobs(0), reconfiguring(false)
+        , stopping(false), queuedTasks(0), sleepingWorkers(0), stealCounter(0)
+    {
+        CV_LOG_INFO(NULL, "Initializing work-stealing parallel backend");
+        startWorkers((int)defaultNumberOfThreads());
+    }
+
+    ~ParallelForBackend() CV_OVERRIDE
+    {
+        stopWorkers();
+    }
+
+    void parallel_for(int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data) CV_OVERRIDE
+    {
+        if (tasks <= 0)
+            return;
+        ThreadSlot& self = tlsSlot.getRef();
+        if (self.worker || self.depth > 0)
+        {
+            // nested call, the pool is kept alive by the outermost job
+            run(self, tasks, body_callback, callback_data);
+            return;
+        }
+        JobScope scope(*this, self);
+        run(self, tasks, body_callback, callback_data);
+    }
+
+    // Workers return 1..numThreads-1. The first thread outside of the pool gets 0, concurrent
+    // callers outside of the pool get values starting from numThreads.
+    int getThreadNum() const CV_OVERRIDE
+    {
+        const ThreadSlot& self = tlsSlot.getRef();
+        if (self.worker)
+            return self.index + 1;
+        return self.index > numWorkers ? self.index : 0;
+    }
+
+    int getNumThreads() const CV_OVERRIDE
+    {
+        return numThreads;
+    }
+
+    int setNumThreads(int nThreads) CV_OVERRIDE
+    {
+        if (nThreads <= 0)
+            nThreads = (int)defaultNumberOfThreads();
+        const ThreadSlot& self = tlsSlot.getRef();
+        if (self.worker || self.depth > 0)
+        {
+            // waiting for completion of the running jobs would deadlock
+            if (nThreads != numThreads)
+                CV_LOG_WARNING(NULL, "core(parallel): can't change number of threads of work-stealing pool from a parallel region");
+            return numThreads;
+        }
+        std::unique_lock<std::mutex> lock(configMutex);
+        configCond.wait(lock, [&]() { return !reconfiguring; });
+        int oldNumThreads = numThreads;
+        if (nThreads != oldNumThreads)
+        {
+            reconfiguring = true;  // blocks new jobs
+            configCond.wait(lock, [&]() { return activeJobs == 0; });
+            stopWorkers();
+            startWorkers(nThreads);
+            reconfiguring = false;
+            lock.unlock();
+            configCond.notify_all();
+        }
+        return oldNumThreads;
+    }
+
+    const char* getName() const CV_OVERRIDE
+    {
+        return "workstealing";
+    }
+
+protected:
+    // registers the outermost parallel_for() call of a thread outside of the pool
+    struct JobScope
+    {
+        JobScope(ParallelForBackend& backend_, ThreadSlot& self_) : backend(backend_), self(self_) { backend.enterJob(self); }
+        ~JobScope() { backend.leaveJob(self); }
+        ParallelForBackend& backend;
+        ThreadSlot& self;
+    };
+
+    void enterJob(ThreadSlot& self)
+    {
+        std::unique_lock<std::mutex> lock(configMutex);
+        configCond.wait(lock, [&]() { return !reconfiguring && (workers.empty() || !freeSlots.empty()); });
+        activeJobs++;
+        if (!workers.empty())
+        {
+            self.index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        self.depth = 1;
+    }
+
+    void leaveJob(ThreadSlot& self)
+    {
+        {
+            std::lock_guard<std::mutex> lock(configMutex);
+            if (self.index >= 0)
+                freeSlots.push_back(self.index);
+            self.index = -1;
+            self.depth = 0;
+            activeJobs--;
+        }
+        configCond.notify_all();
+    }
+
+    void run(ThreadSlot& self, int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data)
+    {
+        if (tasks == 1 || self.index < 0)
+        {
+            body_callback(0, tasks, callback_data);
+            return;
+        }
+        Job job(tasks, body_callback, callback_data);
+        TaskDeque& queue = *queues[self.index];
+        Task task = { &job, 0, tasks };
+        execute(task, queue);
+        wait(job, queue, self.index);
+    }
+
+    void startWorkers(int nThreads)
+    {
+        CV_Assert(workers.empty());
+        numThreads = std::max(1, nThreads);
+        numWorkers = numThreads - 1;
+        stopping = false;
+        queues.clear();
+        freeSlots.clear();
+        // workers' deques are followed by numThreads spare deques for threads outside of the pool,
+        // further callers wait in enterJob() for a free one
+        for (int i = 0; i < numWorkers + numThreads; i++)
+            queues.push_back(std::make_shared<TaskDeque>());
+        for (int i = numWorkers + numThreads - 1; i >= numWorkers; i--)
+            freeSlots.push_back(i);
+        for (int i = 0; i < numWorkers; i++)
+            workers.push_back(std::thread(&ParallelForBackend::workerLoop, this, i));
+        CV_LOG_DEBUG(NULL, "core(parallel): work-stealing pool: " << numWorkers << " worker threads");
+    }
+
+    void stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCond.notify_all();
+        for (size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+        workers.clear();
+    }
+
+    void push(TaskDeque& queue, const Task& task)
+    {
+        queue.push(task);
+        queuedTasks.fetch_add(1);
+        if (sleepingWorkers.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+            }
+            sleepCond.notify_one();
+        }
+    }
+
+    bool pop(TaskDeque& queue, Task& task)
+    {
+        if (queue.pop(task))
+        {
+            queuedTasks.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    bool steal(int slot, Task& task)
+    {
+        if (queuedTasks.load(std::memory_order_relaxed) <= 0)
+            return false;
+        const int n = (int)queues.size();
+        const int start = (int)(stealCounter.fetch_add(1, std::memory_order_relaxed) % (unsigned)n);
+        for (int i = 0; i < n; i++)
+        {
+            int victim = (start + i) % n;
+            if (victim == slot)
+                continue;
+            if (queues[victim]->steal(task))
+            {
+                queuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void execute(Task task, TaskDeque& queue)
+    {
+        while (task.end - task.begin > 1)
+        {
+            int mid = task.begin + (task.end - task.begin) / 2;
+            Task right = { task.job, mid, task.end };
+            push(queue, right);
+            task.end = mid;
+        }
+        Job& job = *task.job;
+        job.callback(task.begin, task.end, job.callback_data);
+        int done = task.end - task.begin;
+        if (job.pending.fetch_sub(done) == done)
+        {
+            // job object is owned by the waiting thread and may be destroyed right after this point
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+            }
+            doneCond.notify_all();
+        }
+    }
+
+    // executes available tasks (of any job) until the job is completed
+    void wait(Job& job, TaskDeque& queue, int slot)
+    {
+        int spin = 0;
+        while (job.pending.load() > 0)
+        {
+            Task task;
+            if (pop(queue, task) || steal(slot, task))
+            {
+                execute(task, queue);
+                spin = 0;
+                continue;
+            }
+            if (spin++ < CV_WORKSTEALING_ACTIVE_WAIT)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCond.wait(lock, [&]() { return job.pending.load() <= 0; });
+        }
+    }
+
+    void workerLoop(int index)
+    {
+        (void)cv::utils::getThreadID();  // notify OpenCV about new thread
+        ThreadSlot& self = tlsSlot.getRef();
+        self.index = index;
+        self.worker = true;
+        TaskDeque& queue = *queues[index];
+        int spin = 0;
+        for (;;)
+        {
+            Task task;
+            if (pop(queue, task) || steal(index, task))
+            {
+                execute(task, queue);
+                spin = 0;
+                continue;
+            }
+            if (stopping)
+                break;
+            if (spin++ < CV_WORKSTEALING_ACTIVE_WAIT)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            spin = 0;
+            sleepingWorkers.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepCond.wait(lock, [&]() { return stopping || queuedTasks.load() > 0; });
+            }
+            sleepingWorkers.fetch_sub(1);
+        }
+        self.index = -1;
+        self.worker = false;
+    }
+
+    std::atomic<int> numThreads;
+    int numWorkers;
+    std::vector<std::thread> workers;
+    std::vector< std::shared_ptr<TaskDeque> > queues;  // workers' deques + deques of threads outside of the pool
+    TLSData<ThreadSlot> tlsSlot;
+
+    std::mutex configMutex;
+    std::condition_variable configCond;  // reconfiguration and free deques of threads outside of the pool
+    std::vector<int> freeSlots;  // guarded by configMutex
+    int activeJobs;              // guarded by configMutex
+    bool reconfiguring;          // guarded by configMutex
+
+    std::atomic<bool> stopping;
+    std::atomic<int> queuedTasks;
+    std::atomic<int> sleepingWorkers;
+    std::atomic<unsigned> stealCounter;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCond;  // idle workers
+
+    std::mutex doneMutex;
+    std::condition_variable doneCond;  // threads waiting for job completion
+};
+
+} // namespace workstealing
+
+std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendWorkStealing()
+{
+    static std::shared_ptr<workstealing::ParallelForBackend> g_instance = std::make_shared<workstealing::ParallelForBackend>();
+    return g_instance;
+}
+
+}}  // namespace
+
+#endif  // !BUILD_PLUGIN && !OPENCV_DISABLE_THREAD_SUPPORT
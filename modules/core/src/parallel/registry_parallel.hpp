@@ -16,6 +16,7 @@ struct ParallelBackendInfo
                       // >10000 - prioritized list (OPENCV_PARALLEL_PRIORITY_LIST)
     std::string name;
     std::shared_ptr<IParallelBackendFactory> backendFactory;
+    bool explicitOnly;  // not used by default, activated by name (OPENCV_PARALLEL_BACKEND / setParallelForBackend()) or via priority list
 };
 
 const std::vector<ParallelBackendInfo>& getParallelBackendsInfo();
@@ -13,16 +13,17 @@ namespace cv { namespace parallel {
 #if OPENCV_HAVE_FILESYSTEM_SUPPORT && defined(PARALLEL_ENABLE_PLUGINS)
 #define DECLARE_DYNAMIC_BACKEND(name) \
 ParallelBackendInfo { \
-    1000, name, createPluginParallelBackendFactory(name) \
+    1000, name, createPluginParallelBackendFactory(name), false \
 },
 #else
 #define DECLARE_DYNAMIC_BACKEND(name) /* nothing */
 #endif
 
-#define DECLARE_STATIC_BACKEND(name, createBackendAPI) \
+#define DECLARE_STATIC_BACKEND_(name, createBackendAPI, explicitOnly) \
 ParallelBackendInfo { \
-    1000, name, std::make_shared<cv::parallel::StaticBackendFactory>([=] () -> std::shared_ptr<cv::parallel::ParallelForAPI> { return createBackendAPI(); }) \
+    1000, name, std::make_shared<cv::parallel::StaticBackendFactory>([=] () -> std::shared_ptr<cv::parallel::ParallelForAPI> { return createBackendAPI(); }), explicitOnly \
 },
+#define DECLARE_STATIC_BACKEND(name, createBackendAPI) DECLARE_STATIC_BACKEND_(name, createBackendAPI, false)
 
 static
 std::vector<ParallelBackendInfo>& getBuiltinParallelBackendsInfo()
@@ -41,6 +42,10 @@ std::vector<ParallelBackendInfo>& getBuiltinParallelBackendsInfo()
 #elif defined(PARALLEL_ENABLE_PLUGINS)
         DECLARE_DYNAMIC_BACKEND("OPENMP")  // TODO Intel OpenMP?
 #endif
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        DECLARE_STATIC_BACKEND_("WORKSTEALING", createParallelBackendWorkStealing, true)
+#endif
     };
     return g_backends;
 }
@@ -127,6 +132,7 @@ protected:
                 if (name == info.name)
                 {
                     info.priority = priority;
+                    info.explicitOnly = false;
                     CV_LOG_DEBUG(NULL, "core(parallel): New backend priority: '" << name << "' => " << info.priority);
                     found = true;
                     hasChanges = true;
@@ -136,7 +142,7 @@ protected:
             if (!found)
             {
                 CV_LOG_INFO(NULL, "core(parallel): Adding parallel backend (plugin): '" << name << "'");
-                enabledBackends.push_back(ParallelBackendInfo{priority, name, createPluginParallelBackendFactory(name)});
+                enabledBackends.push_back(ParallelBackendInfo{priority, name, createPluginParallelBackendFactory(name), false});
                 hasChanges = true;
             }
         }
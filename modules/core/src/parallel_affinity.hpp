@@ -0,0 +1,77 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#ifndef OPENCV_CORE_PARALLEL_AFFINITY_HPP
+#define OPENCV_CORE_PARALLEL_AFFINITY_HPP
+
+// Helpers of the thread placement of the pthreads pool (OPENCV_THREAD_POOL_AFFINITY), see parallel_impl.cpp.
+// Header-only to be reused by tests.
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cv { namespace details {
+
+/** Parses CPU list in the sysfs format ("0-3,8,10-11"). Returns empty vector on errors. */
+static inline std::vector<int> parseCPUList(const std::string& list, int max_cpu)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        int first = -1, last = -1;
+        int n = sscanf(item.c_str(), "%d-%d", &first, &last);
+        if (n == 1)
+            last = first;
+        if (n < 1 || first < 0 || last < first || last >= max_cpu)
+            return std::vector<int>();
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+/** Index of the CPU set (NUMA node or single CPU) of a worker thread.
+ * @param slot thread index in the pool: 1..num_threads-1 for worker threads.
+ * The thread which calls parallel_for_() (slot 0) is never bound.
+ */
+static inline size_t getAffinitySetIndex(unsigned slot, unsigned num_threads, size_t num_sets, bool is_numa)
+{
+    const unsigned num_workers = std::max(1u, num_threads - 1);
+    const unsigned worker = std::min(std::max(1u, slot), num_workers) - 1;
+    return is_numa
+        ? (size_t)worker * num_sets / num_workers  // contiguous groups of threads per node
+        : worker % num_sets;
+}
+
+/** Number of static task blocks of a job: one block per worker thread. */
+static inline unsigned getStaticBlockCount(unsigned num_threads)
+{
+    return std::max(1u, num_threads - 1);
+}
+
+/** Tasks [begin, end) of the block. Blocks are contiguous and their sizes differ by one at most. */
+static inline void getStaticBlockRange(int task_count, unsigned num_blocks, unsigned block, int& begin, int& end)
+{
+    begin = (int)((long long)task_count * block / num_blocks);
+    end = (int)((long long)task_count * (block + 1) / num_blocks);
+}
+
+/** Block which is visited at step 'b' by the thread of 'slot'.
+ * Worker threads start from their own block (slot - 1) and then help with the following blocks.
+ * The unbound calling thread (slot 0) owns no block and helps from the last block backwards.
+ */
+static inline unsigned getStaticBlockVisitOrder(unsigned slot, unsigned num_blocks, unsigned b)
+{
+    if (slot == 0)
+        return num_blocks - 1 - b;
+    return (slot - 1 + b) % num_blocks;
+}
+
+}} // namespace
+
+#endif // OPENCV_CORE_PARALLEL_AFFINITY_HPP
@@ -7,6 +7,8 @@
 #include "parallel_impl.hpp"
 
 #ifdef HAVE_PTHREADS_PF
+#include "parallel_affinity.hpp"
+
 #include <pthread.h>
 
 #include <opencv2/core/utils/configuration.private.hpp>
@@ -25,6 +27,12 @@
 
 #include <atomic>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <fstream>
+#define CV_HAVE_THREAD_AFFINITY 1
+#endif
+
 // Spin lock's OS-level yield
 #ifdef DECLARE_CV_YIELD
 DECLARE_CV_YIELD
@@ -79,6 +87,110 @@ static int CV_MAIN_THREAD_ACTIVE_WAIT = (int)utils::getConfigurationParameterSiz
 
 static int CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT = (int)utils::getConfigurationParameterSizeT("OPENCV_THREAD_POOL_ACTIVE_WAIT_THREADS_LIMIT", 0); // number of real cores
 
+/** Placement of worker threads, OPENCV_THREAD_POOL_AFFINITY:
+ * - "" or "none": threads are not pinned (default)
+ * - "numa": worker threads are distributed over NUMA nodes in contiguous groups and bound to CPUs of their node
+ * - CPU list ("0-7,16-23"): worker threads are pinned to CPUs of the list (round-robin)
+ *
+ * If placement is enabled, tasks (stripes) of jobs are statically assigned to worker threads (with work stealing
+ * of the remaining tasks), so the same stripes of consecutive parallel_for_() calls are processed on the same
+ * CPU / NUMA node which has touched the related memory first. The thread which calls parallel_for_() is not
+ * bound (it is an application thread) and owns no tasks, it only helps with the remaining ones.
+ */
+class ThreadAffinity
+{
+public:
+    static const ThreadAffinity& instance()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(ThreadAffinity, new ThreadAffinity())
+    }
+
+    bool isEnabled() const { return !cpu_sets.empty(); }
+
+    /** @brief Binds the calling worker thread
+     * @param slot worker thread index in the pool (1..N-1)
+     * @param num_threads number of threads in the pool (including the thread which calls parallel_for_())
+     */
+    bool bindCurrentThread(unsigned slot, unsigned num_threads) const
+    {
+        if (!isEnabled())
+            return false;
+        CV_DbgAssert(slot > 0);
+#ifdef CV_HAVE_THREAD_AFFINITY
+        const std::vector<int>& cpus = cpu_sets[details::getAffinitySetIndex(slot, num_threads, cpu_sets.size(), is_numa)];
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (size_t i = 0; i < cpus.size(); i++)
+            CPU_SET(cpus[i], &mask);
+        int res = sched_setaffinity(0, sizeof(mask), &mask);  // 0 - calling thread
+        if (res != 0)
+        {
+            CV_LOG_WARNING(NULL, "Thread: can't set CPU affinity for worker " << slot << ": errno=" << errno);
+            return false;
+        }
+        CV_LOG_VERBOSE(NULL, 1, "Thread: worker " << slot << " is bound to " << cpus.size() << " CPU(s), first=" << cpus[0]);
+        return true;
+#else
+        CV_UNUSED(slot); CV_UNUSED(num_threads);
+        return false;
+#endif
+    }
+
+protected:
+    ThreadAffinity() : is_numa(false)
+    {
+        const std::string mode = utils::getConfigurationParameterString("OPENCV_THREAD_POOL_AFFINITY", "");
+        if (mode.empty() || mode == "none")
+            return;
+#ifdef CV_HAVE_THREAD_AFFINITY
+        if (mode == "numa")
+        {
+            std::vector<int> nodes = details::parseCPUList(readFile("/sys/devices/system/node/online"), CPU_SETSIZE);
+            for (size_t i = 0; i < nodes.size(); i++)
+            {
+                std::vector<int> cpus = details::parseCPUList(readFile(cv::format("/sys/devices/system/node/node%d/cpulist", nodes[i]).c_str()), CPU_SETSIZE);
+                if (!cpus.empty())
+                    cpu_sets.push_back(cpus);
+            }
+            if (cpu_sets.size() <= 1)
+            {
+                CV_LOG_INFO(NULL, "OPENCV_THREAD_POOL_AFFINITY=numa: single NUMA node, thread placement is disabled");
+                cpu_sets.clear();
+                return;
+            }
+            is_numa = true;
+        }
+        else
+        {
+            std::vector<int> cpus = details::parseCPUList(mode, CPU_SETSIZE);
+            for (size_t i = 0; i < cpus.size(); i++)
+                cpu_sets.push_back(std::vector<int>(1, cpus[i]));
+            if (cpu_sets.empty())
+            {
+                CV_LOG_WARNING(NULL, "OPENCV_THREAD_POOL_AFFINITY: can't parse CPU list: '" << mode << "'");
+                return;
+            }
+        }
+        CV_LOG_INFO(NULL, "Thread pool: worker threads are bound to " << (is_numa ? "NUMA nodes" : "CPUs") << " (" << cpu_sets.size() << ")");
+#else
+        CV_LOG_WARNING(NULL, "OPENCV_THREAD_POOL_AFFINITY is not supported on this platform");
+#endif
+    }
+
+#ifdef CV_HAVE_THREAD_AFFINITY
+    static std::string readFile(const char* filename)
+    {
+        std::ifstream ifs(filename);
+        std::string content;
+        std::getline(ifs, content);
+        return content;
+    }
+#endif
+
+    std::vector< std::vector<int> > cpu_sets;  // per NUMA node or per CPU
+    bool is_numa;
+};
+
 class WorkerThread;
 class ParallelJob;
 
@@ -206,6 +318,8 @@ public:
 
     Ptr<ParallelJob> job;
 
+    unsigned affinity_num_threads;  // pool size used for the current thread placement (0 - not bound)
+
     pthread_mutex_t mutex;
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
     volatile bool isActive;
@@ -218,7 +332,8 @@ public:
         posix_thread(0),
         is_created(false),
         stop_thread(false),
-        has_wake_signal(false)
+        has_wake_signal(false),
+        affinity_num_threads(0)
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
         , isActive(true)
 #endif
@@ -299,6 +414,18 @@ public:
         active_thread_count.store(0, std::memory_order_relaxed);
         completed_thread_count.store(0, std::memory_order_relaxed);
         dummy0_[0] = 0, dummy1_[0] = 0, dummy2_[0] = 0; // compiler warning
+        if (ThreadAffinity::instance().isEnabled())
+        {
+            // static assignment: block of tasks per worker thread of the pool
+            const unsigned num_blocks = details::getStaticBlockCount(thread_pool.num_threads);
+            blocks = std::vector<TaskBlock>(num_blocks);
+            for (unsigned i = 0; i < num_blocks; i++)
+            {
+                int begin = 0;
+                details::getStaticBlockRange(range.size(), num_blocks, i, begin, blocks[i].end);
+                blocks[i].next.store(begin, std::memory_order_relaxed);
+            }
+        }
     }
 
     ~ParallelJob()
@@ -306,8 +433,11 @@ public:
         CV_LOG_VERBOSE(NULL, 5, "ParallelJob::~ParallelJob(" << (void*)this << ")");
     }
 
-    unsigned execute(bool is_worker_thread)
+    /** @param slot index of the thread in the pool: 0 - main thread, worker id + 1 - worker threads */
+    unsigned execute(bool is_worker_thread, unsigned slot)
     {
+        if (!blocks.empty())
+            return executeStatic(is_worker_thread, slot);
         unsigned executed_tasks = 0;
         const int task_count = range.size();
         const int remaining_multiplier = std::min(nstripes,
@@ -327,14 +457,49 @@ public:
             int end_id = std::min(task_count, id + chunk_size);
             CV_LOG_VERBOSE(NULL, 9, "Thread: job " << start_id << "-" << end_id);
 
-            //TODO: if (not pending exception)
-            {
-                body.operator()(Range(range.start + start_id, range.start + end_id));
-            }
-            if (is_worker_thread && is_completed)
+            executeTasks(is_worker_thread, start_id, end_id);
+        }
+        return executed_tasks;
+    }
+
+    // tasks [start_id, end_id) of the job
+    void executeTasks(bool is_worker_thread, int start_id, int end_id)
+    {
+        //TODO: if (not pending exception)
+        {
+            body.operator()(Range(range.start + start_id, range.start + end_id));
+        }
+        if (is_worker_thread && is_completed)
+        {
+            CV_LOG_ERROR(NULL, "\t\t\t\tBUG! Job: " << (void*)this << " " << start_id << " " << active_thread_count << " " << completed_thread_count);
+            CV_Assert(!is_completed); // TODO Dbg this
+        }
+    }
+
+    // process own block of tasks first, then help with blocks of other threads
+    unsigned executeStatic(bool is_worker_thread, unsigned slot)
+    {
+        unsigned executed_tasks = 0;
+        const unsigned num_blocks = (unsigned)blocks.size();
+        for (unsigned b = 0; b < num_blocks; b++)
+        {
+            const unsigned block_idx = details::getStaticBlockVisitOrder(slot, num_blocks, b);
+            TaskBlock& block = blocks[block_idx];
+            for (;;)
             {
-                CV_LOG_ERROR(NULL, "\t\t\t\tBUG! Job: " << (void*)this << " " << id << " " << active_thread_count << " " << completed_thread_count);
-                CV_Assert(!is_completed); // TODO Dbg this
+                // the calling thread takes single tasks to leave most of the block to its owner
+                int chunk_size = slot == 0 ? 1 : std::max(1, (block.end - block.next.load(std::memory_order_relaxed)) / 4);
+                int id = block.next.fetch_add(chunk_size, std::memory_order_seq_cst);
+                if (id >= block.end)
+                    break; // no more free tasks in this block
+
+                int start_id = id;
+                int end_id = std::min(block.end, id + chunk_size);
+                current_task.fetch_add(end_id - start_id, std::memory_order_seq_cst);
+                executed_tasks += end_id - start_id;
+                CV_LOG_VERBOSE(NULL, 9, "Thread: job " << start_id << "-" << end_id << " (block " << block_idx << ")");
+
+                executeTasks(is_worker_thread, start_id, end_id);
             }
         }
         return executed_tasks;
@@ -356,6 +521,15 @@ public:
 
     std::atomic<bool> is_completed;
 
+    struct TaskBlock
+    {
+        TaskBlock() : next(0), end(0) { dummy_[0] = 0; }
+        std::atomic<int> next;  // next free task of the block
+        int end;
+        int64 dummy_[7];  // avoid cache-line reusing for the same atomics
+    };
+    std::vector<TaskBlock> blocks;  // static assignment of tasks to threads (see ThreadAffinity), empty if disabled
+
     // TODO exception handling
 };
 
@@ -432,14 +606,20 @@ void WorkerThread::thread_body()
                 CV_LOG_VERBOSE(NULL, 5, "Thread: job size=" << j->range.size() << " done=" << j->current_task);
                 if (j->current_task < j->range.size())
                 {
+                    if (affinity_num_threads != thread_pool.num_threads && ThreadAffinity::instance().isEnabled())
+                    {
+                        // pool size is changed, so thread placement should be updated too
+                        ThreadAffinity::instance().bindCurrentThread(id + 1, thread_pool.num_threads);
+                        affinity_num_threads = thread_pool.num_threads;
+                    }
                     int other = j->active_thread_count.fetch_add(1, std::memory_order_seq_cst);
                     CV_LOG_VERBOSE(NULL, 5, "Thread: processing new job (with " << other << " other threads)"); CV_UNUSED(other);
 #ifdef CV_PROFILE_THREADS
                     stat.threadExecuteStart = getTickCount();
-                    stat.executedTasks = j->execute(true);
+                    stat.executedTasks = j->execute(true, id + 1);
                     stat.threadExecuteStop = getTickCount();
 #else
-                    j->execute(true);
+                    j->execute(true, id + 1);
 #endif
                     int completed = j->completed_thread_count.fetch_add(1, std::memory_order_seq_cst) + 1;
                     int active = j->active_thread_count.load(std::memory_order_acquire);
@@ -644,10 +824,10 @@ void ThreadPool::run(const Range& range, const ParallelLoopBody& body, double ns
                 ParallelJob& j = *(this->job);
 #ifdef CV_PROFILE_THREADS
                 threads_stat[0].threadExecuteStart = getTickCount();
-                threads_stat[0].executedTasks = j.execute(false);
+                threads_stat[0].executedTasks = j.execute(false, 0);
                 threads_stat[0].threadExecuteStop = getTickCount();
 #else
-                j.execute(false);
+                j.execute(false, 0);
 #endif
                 CV_Assert(j.current_task >= j.range.size());
                 CV_LOG_VERBOSE(NULL, 5, "MainThread: complete self-tasks: " << j.active_thread_count << " " << j.completed_thread_count);
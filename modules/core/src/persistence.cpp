@@ -433,6 +433,10 @@ void FileStorage::Impl::init() {
     fmt = 0;
     file = 0;
     gzfile = 0;
+    blobfile = 0;
+    blobofs = 0;
+    blobtmpname.clear();
+    blobmap.release();
     empty_stream = true;
 
     strbufv.clear();
@@ -542,6 +546,9 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
     if (mem_mode && append)
         CV_Error(cv::Error::StsBadFlag, "FileStorage::APPEND and FileStorage::MEMORY are not currently compatible");
 
+    if (mem_mode && write_mode && (_flags & FileStorage::RAW_BLOBS))
+        CV_Error(cv::Error::StsBadFlag, "FileStorage::RAW_BLOBS and FileStorage::MEMORY are not compatible");
+
     flags = _flags;
 
     if (!mem_mode) {
@@ -726,6 +733,10 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
             write_stack.back().indent = 4;
             emitter_do_not_use_direct_dereference = createJSONEmitter(this);
         }
+        if ((flags & FileStorage::RAW_BLOBS) && !openBlobFile(append)) {
+            release();
+            return false;
+        }
         is_opened = true;
     } else {
         const size_t buf_size0 = 40;
@@ -929,6 +940,7 @@ void FileStorage::Impl::closeFile() {
     else if (gzfile)
         gzclose(gzfile);
 #endif
+    closeBlobFile();
     file = 0;
     gzfile = 0;
     strbuf = 0;
@@ -0,0 +1,311 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "persistence_impl.hpp"
+
+#include <opencv2/core/utils/logger.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#undef NOMINMAX
+#define NOMINMAX
+#include <windows.h>
+#define OPENCV_HAVE_FS_MMAP 1
+#elif defined __linux__ || defined __APPLE__ || defined __HAIKU__ || defined __FreeBSD__ || defined __GNU__ || defined __QNX__
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define OPENCV_HAVE_FS_MMAP 1
+#endif
+
+namespace cv
+{
+
+// Layout of the companion file of RAW_BLOBS storages:
+// BLOB_ALIGN bytes of header (signature, zero padded), then data blocks aligned to BLOB_ALIGN.
+static const size_t BLOB_ALIGN = 64;
+static const char blob_signature[] = "%OPENCV-BLOB:1.0\n";
+
+static std::string blobFileName(const std::string& filename)
+{
+    // gzip compression level may be cut from the name by the '\0' character, see FileStorage::Impl::open
+    return std::string(filename.c_str()) + ".blob";
+}
+
+/** Read-only view of the whole companion file.
+
+The file is mapped as copy-on-write, so matrices which point into the mapping may be modified
+without changing the file. Without mmap support the file is loaded into memory.
+*/
+class MappedBlobFile
+{
+public:
+    MappedBlobFile() : data_(0), size_(0)
+#ifdef _WIN32
+        , hFile(INVALID_HANDLE_VALUE), hMap(NULL)
+#endif
+    {}
+
+    ~MappedBlobFile() { close(); }
+
+    bool open(const std::string& name)
+    {
+        close();
+#if defined _WIN32
+        // FILE_SHARE_DELETE: a rewritten storage replaces the file while it is mapped, see closeBlobFile()
+        hFile = CreateFileA(name.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(hFile, &sz) || sz.QuadPart == 0)
+            return false;
+        size_ = (size_t)sz.QuadPart;
+        hMap = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (hMap == NULL)
+            return false;
+        data_ = (uchar*)MapViewOfFile(hMap, FILE_MAP_COPY, 0, 0, 0);
+        return data_ != 0;
+#elif defined OPENCV_HAVE_FS_MMAP
+        int fd = ::open(name.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        size_ = (size_t)st.st_size;
+        void* addr = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference to the file
+        if (addr == MAP_FAILED)
+        {
+            size_ = 0;
+            return false;
+        }
+        data_ = (uchar*)addr;
+        return true;
+#else
+        FILE* f = fopen(name.c_str(), "rb");
+        if (!f)
+            return false;
+        fseek(f, 0, SEEK_END);
+        long sz = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        if (sz > 0)
+        {
+            size_ = (size_t)sz;
+            data_ = (uchar*)fastMalloc(size_);
+            if (fread(data_, 1, size_, f) != size_)
+                close();
+        }
+        fclose(f);
+        return data_ != 0;
+#endif
+    }
+
+    void close()
+    {
+#if defined _WIN32
+        if (data_)
+            UnmapViewOfFile(data_);
+        if (hMap != NULL)
+            CloseHandle(hMap);
+        if (hFile != INVALID_HANDLE_VALUE)
+            CloseHandle(hFile);
+        hMap = NULL;
+        hFile = INVALID_HANDLE_VALUE;
+#elif defined OPENCV_HAVE_FS_MMAP
+        if (data_)
+            munmap(data_, size_);
+#else
+        fastFree(data_);
+#endif
+        data_ = 0;
+        size_ = 0;
+    }
+
+    uchar* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uchar* data_;
+    size_t size_;
+#ifdef _WIN32
+    HANDLE hFile;
+    HANDLE hMap;
+#endif
+
+    MappedBlobFile(const MappedBlobFile&); // = delete
+    MappedBlobFile& operator=(const MappedBlobFile&); // = delete
+};
+
+/** Owner of UMatData objects of matrices which point into a mapped companion file.
+
+Each UMatData keeps a reference to the mapping (in `userdata`), so the file stays mapped
+while any of the loaded matrices is alive.
+*/
+class MappedBlobAllocator CV_FINAL : public MatAllocator
+{
+public:
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data, size_t* step, AccessFlag flags, UMatUsageFlags usageFlags) const CV_OVERRIDE
+    {
+        return Mat::getDefaultAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        return u != 0;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        delete (Ptr<MappedBlobFile>*)u->userdata;
+        u->userdata = 0;
+        delete u;
+    }
+
+    UMatData* wrap(const Ptr<MappedBlobFile>& file, uchar* data, size_t size) const
+    {
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = size;
+        u->flags |= UMatData::USER_ALLOCATED;
+        u->userdata = new Ptr<MappedBlobFile>(file);
+        return u;
+    }
+};
+
+static const MappedBlobAllocator& getMappedBlobAllocator()
+{
+    CV_SINGLETON_LAZY_INIT_REF(MappedBlobAllocator, new MappedBlobAllocator())
+}
+
+bool FileStorage::Impl::openBlobFile(bool append)
+{
+    std::string name = blobFileName(filename);
+    // The existing file may be mapped by the matrices loaded from it (in this or other processes),
+    // so it is never truncated: a new file is written aside and replaces it in closeBlobFile().
+    // Appending keeps the mapped part of the file unchanged.
+    blobtmpname = append ? std::string() : name + ".tmp";
+    const std::string& path = append ? name : blobtmpname;
+    blobfile = fopen(path.c_str(), append ? "ab" : "wb");
+    if (!blobfile)
+    {
+        CV_LOG_ERROR(NULL, "Can't open file: '" << path << "' in " << (append ? "append" : "write") << " mode");
+        blobtmpname.clear();
+        return false;
+    }
+    fseek(blobfile, 0, SEEK_END);
+    blobofs = (size_t)ftell(blobfile);
+    if (blobofs == 0)
+    {
+        char header[BLOB_ALIGN] = {0};
+        memcpy(header, blob_signature, sizeof(blob_signature) - 1);
+        if (fwrite(header, 1, BLOB_ALIGN, blobfile) != BLOB_ALIGN)
+        {
+            fclose(blobfile);
+            blobfile = 0;
+            if (!blobtmpname.empty())
+                remove(blobtmpname.c_str());
+            blobtmpname.clear();
+            return false;
+        }
+        blobofs = BLOB_ALIGN;
+    }
+    return true;
+}
+
+void FileStorage::Impl::closeBlobFile()
+{
+    if (!blobfile)
+        return;
+    bool ok = fclose(blobfile) == 0;
+    blobfile = 0;
+    if (blobtmpname.empty())
+        return;
+
+    // the old file stays valid for the existing mappings until they are released
+    std::string name = blobFileName(filename);
+#ifdef _WIN32
+    ok = ok && MoveFileExA(blobtmpname.c_str(), name.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = ok && rename(blobtmpname.c_str(), name.c_str()) == 0;
+#endif
+    if (!ok)
+    {
+        CV_LOG_ERROR(NULL, "Can't replace file: '" << name << "' by '" << blobtmpname << "'");
+        remove(blobtmpname.c_str());
+    }
+    blobtmpname.clear();
+}
+
+size_t FileStorage::Impl::writeBlob(const Mat& m)
+{
+    CV_Assert(blobfile);
+    static const char zeros[BLOB_ALIGN] = {0};
+    size_t ofs = alignSize(blobofs, (int)BLOB_ALIGN);
+    if (ofs > blobofs && fwrite(zeros, 1, ofs - blobofs, blobfile) != ofs - blobofs)
+        CV_Error(cv::Error::StsError, "Can't write data to the blob file");
+
+    const Mat* arrays[] = {&m, 0};
+    uchar* ptrs[1] = {};
+    NAryMatIterator it(arrays, ptrs);
+    size_t planesz = it.size*m.elemSize();
+
+    for (size_t i = 0; i < it.nplanes; i++, ++it)
+    {
+        if (fwrite(ptrs[0], 1, planesz, blobfile) != planesz)
+            CV_Error(cv::Error::StsError, "Can't write data to the blob file");
+    }
+    blobofs = ofs + m.total()*m.elemSize();
+    return ofs;
+}
+
+Mat FileStorage::Impl::readBlob(int64_t offset, int dims, const int* sizes, int type)
+{
+    if (blobmap.empty())
+    {
+        if (mem_mode || filename.empty())
+            CV_Error(cv::Error::StsNotImplemented, "Matrices with raw blob data can't be read from memory buffer");
+        std::string name = blobFileName(filename);
+        Ptr<MappedBlobFile> mapped = makePtr<MappedBlobFile>();
+        if (!mapped->open(name))
+            CV_Error(cv::Error::StsError, "Can't open blob file: '" + name + "'");
+        if (mapped->size() < BLOB_ALIGN || memcmp(mapped->data(), blob_signature, sizeof(blob_signature) - 1) != 0)
+            CV_Error(cv::Error::StsError, "Invalid blob file: '" + name + "'");
+        blobmap = mapped;
+    }
+
+    CV_Assert(0 < dims && dims <= CV_MAX_DIM);
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = 0; i < dims; i++)
+    {
+        if (sizes[i] <= 0)
+            CV_Error(cv::Error::StsOutOfRange, "Invalid size of matrix with raw blob data");
+        if (total > std::numeric_limits<size_t>::max() / (size_t)sizes[i])
+            CV_Error(cv::Error::StsOutOfRange, "Matrix with raw blob data is too big");
+        total *= (size_t)sizes[i];
+    }
+    if (offset < (int64_t)BLOB_ALIGN || offset % BLOB_ALIGN != 0 ||
+        (uint64_t)offset > blobmap->size() || total > blobmap->size() - (size_t)offset)
+        CV_Error(cv::Error::StsOutOfRange, "Invalid offset of matrix data in the blob file");
+
+    uchar* data = blobmap->data() + offset;
+    Mat m(dims, sizes, type, data);
+    m.u = getMappedBlobAllocator().wrap(blobmap, data, total);
+    m.u->refcount = 1;
+    return m;
+}
+
+} // namespace cv
@@ -14,6 +14,8 @@
 namespace cv
 {
 
+class MappedBlobFile;
+
 enum Base64State{
     Uncertain,
     NotUse,
@@ -87,6 +89,14 @@ public:
 
     void writeRawDataBase64(const void* _data, size_t len, const char* dt );
 
+    bool openBlobFile( bool append );
+
+    void closeBlobFile();
+
+    size_t writeBlob( const Mat& m );
+
+    Mat readBlob( int64_t offset, int dims, const int* sizes, int type );
+
     String releaseAndGetString();
 
     FileNode getFirstTopLevelNode() const;
@@ -192,6 +202,11 @@ public:
     FILE* file;
     gzFile gzfile;
 
+    FILE* blobfile;           //!< companion file of RAW_BLOBS storage (writing)
+    size_t blobofs;
+    std::string blobtmpname;  //!< written instead of the companion file, renamed over it on closing
+    Ptr<MappedBlobFile> blobmap; //!< mapping of the companion file (reading)
+
     bool is_opened;
     bool dummy_eof;
     bool write_mode;
@@ -3,7 +3,7 @@
 // of this distribution and at http://opencv.org/license.html
 
 #include "precomp.hpp"
-#include "persistence.hpp"
+#include "persistence_impl.hpp"
 
 namespace cv
 {
@@ -18,6 +18,12 @@ void write( FileStorage& fs, const String& name, const Mat& m )
         fs << "rows" << m.rows;
         fs << "cols" << m.cols;
         fs << "dt" << fs::encodeFormat( m.type(), dt, sizeof(dt) );
+        if( fs.p->blobfile && !m.empty() )
+        {
+            fs << "blob" << (int64_t)fs.p->writeBlob(m);
+            fs.endWriteStruct();
+            return;
+        }
         fs << "data" << "[:";
         for( int i = 0; i < m.rows; i++ )
             fs.writeRaw(dt, m.ptr(i), m.cols*m.elemSize());
@@ -31,6 +37,12 @@ void write( FileStorage& fs, const String& name, const Mat& m )
         fs.writeRaw( "i", m.size.p, m.dims*sizeof(int) );
         fs << "]";
         fs << "dt" << fs::encodeFormat( m.type(), dt, sizeof(dt) );
+        if( fs.p->blobfile )
+        {
+            fs << "blob" << (int64_t)fs.p->writeBlob(m);
+            fs.endWriteStruct();
+            return;
+        }
         fs << "data" << "[:";
         const Mat* arrays[] = {&m, 0};
         uchar* ptrs[1] = {};
@@ -129,24 +141,36 @@ void read(const FileNode& node, Mat& m, const Mat& default_mat)
 
     elem_type = fs::decodeSimpleFormat( dt.c_str() );
 
+    int sizes[CV_MAX_DIM] = {0}, dims;
     read(node["rows"], rows, -1);
     if( rows >= 0 )
     {
         read(node["cols"], cols, -1);
-        m.create(rows, cols, elem_type);
+        dims = 2;
+        sizes[0] = rows;
+        sizes[1] = cols;
     }
     else
     {
-        int sizes[CV_MAX_DIM] = {0}, dims;
         FileNode sizes_node = node["sizes"];
         CV_Assert( !sizes_node.empty() );
 
         dims = (int)sizes_node.size();
+        CV_Assert( 0 < dims && dims <= CV_MAX_DIM );
         sizes_node.readRaw("i", sizes, dims*sizeof(sizes[0]));
+    }
 
-        m.create(dims, sizes, elem_type);
+    // data of RAW_BLOBS storages points into the mapped companion file, see FileStorage::Impl::readBlob
+    FileNode blob_node = node["blob"];
+    if( !blob_node.empty() )
+    {
+        CV_Assert( node.fs );
+        m = node.fs->readBlob( (int64_t)blob_node, dims, sizes, elem_type );
+        return;
     }
 
+    m.create(dims, sizes, elem_type);
+
     FileNode data_node = node["data"];
     CV_Assert(!data_node.empty());
 
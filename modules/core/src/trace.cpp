@@ -10,6 +10,8 @@
 
 #include <opencv2/core/opencl/ocl_defs.hpp>
 
+#include "utils/trace_chrome.hpp"
+
 #include <cstdarg> // va_start
 
 #include <sstream>
@@ -80,6 +82,30 @@ static const cv::String& getParameterTraceLocation()
     return param_traceLocation;
 }
 
+enum TraceFormat
+{
+    TRACE_FORMAT_TXT = 0,     //!< OpenCV text format (per-thread files), see modules/ts/misc/trace_profiler.py
+    TRACE_FORMAT_CHROME = 1,  //!< Chrome Trace Event format (single JSON file), chrome://tracing or https://ui.perfetto.dev
+};
+
+static TraceFormat parseTraceFormat(std::string format)
+{
+    std::transform(format.begin(), format.end(), format.begin(), ::tolower);
+    if (format == "chrome" || format == "json" || format == "perfetto")
+        return TRACE_FORMAT_CHROME;
+    if (format != "txt" && format != "text")
+        CV_LOG_WARNING(NULL, "Trace: unknown OPENCV_TRACE_FORMAT='" << format << "'. Using 'txt'");
+    return TRACE_FORMAT_TXT;
+}
+
+static TraceFormat getParameterTraceFormat()
+{
+    static TraceFormat param_traceFormat = parseTraceFormat(utils::getConfigurationParameterString("OPENCV_TRACE_FORMAT", "txt"));
+    return param_traceFormat;
+}
+
+static size_t param_traceBufferSize = utils::getConfigurationParameterSizeT("OPENCV_TRACE_BUFFER_SIZE", 65536);  // events per thread
+
 #ifdef HAVE_OPENCL
 static bool param_synchronizeOpenCL = utils::getConfigurationParameterBool("OPENCV_TRACE_SYNC_OPENCL", false);
 #endif
@@ -191,6 +217,26 @@ public:
 };
 
 
+bool TraceStorage::putRegionEnter(const Region& region) const
+{
+    TraceMessage msg;
+    msg.formatRegionEnter(region);
+    return put(msg);
+}
+
+bool TraceStorage::putRegionLeave(const Region& region, const RegionStatistics& result) const
+{
+    TraceMessage msg;
+    msg.formatRegionLeave(region, result);
+    return put(msg);
+}
+
+// arguments are not stored in text format
+bool TraceStorage::putRegionArg(const Region&, const TraceArg&, const char*) const { return false; }
+bool TraceStorage::putRegionArg(const Region&, const TraceArg&, int64) const { return false; }
+bool TraceStorage::putRegionArg(const Region&, const TraceArg&, double) const { return false; }
+
+
 #ifdef OPENCV_WITH_ITT
 static __itt_domain* domain = NULL;
 
@@ -322,11 +368,7 @@ void Region::Impl::enterRegion(TraceManagerThreadLocal& ctx)
 
     TraceStorage* s = ctx.getStorage();
     if (s)
-    {
-        TraceMessage msg;
-        msg.formatRegionEnter(region);
-        s->put(msg);
-    }
+        s->putRegionEnter(region);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -369,11 +411,7 @@ void Region::Impl::leaveRegion(TraceManagerThreadLocal& ctx)
 #endif
     TraceStorage* s = ctx.getStorage();
     if (s)
-    {
-        TraceMessage msg;
-        msg.formatRegionLeave(region, result);
-        s->put(msg);
-    }
+        s->putRegionLeave(region, result);
 
     if (location.flags & REGION_FLAG_FUNCTION)
     {
@@ -801,13 +839,87 @@ public:
 };
 
 
+/**
+ * Chrome Trace Event format writer, see ChromeTraceFile
+ */
+class ChromeTraceWriter CV_FINAL : public TraceStorage
+{
+public:
+    const cv::Ptr<ChromeTraceFile> file;
+
+    ChromeTraceWriter(const std::string& filename) :
+        file(cv::makePtr<ChromeTraceFile>(filename))
+    {
+    }
+
+    bool put(const TraceMessage& /*msg*/) const CV_OVERRIDE
+    {
+        return false;  // text messages are not used
+    }
+};
+
+/**
+ * Per-thread storage of Chrome trace events, see ChromeTraceEventBuffer
+ */
+class ChromeTraceThreadStorage CV_FINAL : public TraceStorage
+{
+    mutable ChromeTraceEventBuffer buffer;
+
+public:
+    ChromeTraceThreadStorage(const cv::Ptr<ChromeTraceWriter>& writer, int threadID, size_t capacity) :
+        buffer(writer->file, threadID, capacity)
+    {
+    }
+
+    bool put(const TraceMessage& /*msg*/) const CV_OVERRIDE
+    {
+        return false;  // text messages are not used
+    }
+
+    bool putRegionEnter(const Region& region) const CV_OVERRIDE
+    {
+        const Region::Impl& impl = *region.pImpl;
+        buffer.regionEnter(impl.global_region_id, impl.beginTimestamp, impl.location.name,
+                (impl.location.flags & REGION_FLAG_APP_CODE) != 0);
+        return true;
+    }
+
+    bool putRegionLeave(const Region& region, const RegionStatistics& result) const CV_OVERRIDE
+    {
+        const Region::Impl& impl = *region.pImpl;
+        buffer.regionLeave(impl.global_region_id, impl.endTimestamp, (int)result.currentSkippedRegions);
+        return true;
+    }
+
+    bool putRegionArg(const Region& region, const TraceArg& arg, const char* value) const CV_OVERRIDE
+    {
+        return buffer.regionArg(region.pImpl->global_region_id, arg.name,
+                std::string("\"") + ChromeTraceEventBuffer::escape(value) + "\"");
+    }
+    bool putRegionArg(const Region& region, const TraceArg& arg, int64 value) const CV_OVERRIDE
+    {
+        return buffer.regionArg(region.pImpl->global_region_id, arg.name, cv::format("%lld", (long long int)value));
+    }
+    bool putRegionArg(const Region& region, const TraceArg& arg, double value) const CV_OVERRIDE
+    {
+        return buffer.regionArg(region.pImpl->global_region_id, arg.name, cv::format("%.17g", value));
+    }
+};
+
+
 TraceStorage* TraceManagerThreadLocal::getStorage() const
 {
     // TODO configuration option for stdout/single trace file
     if (storage.empty())
     {
         TraceStorage* global = getTraceManager().trace_storage.get();
-        if (global)
+        if (global && getParameterTraceFormat() == TRACE_FORMAT_CHROME)
+        {
+            cv::Ptr<ChromeTraceWriter> writer = getTraceManager().trace_storage.dynamicCast<ChromeTraceWriter>();
+            CV_Assert(writer);
+            storage.reset(new ChromeTraceThreadStorage(writer, threadID, param_traceBufferSize));
+        }
+        else if (global)
         {
             const std::string filepath = cv::format("%s-%03d.txt", getParameterTraceLocation().c_str(), threadID).c_str();
             TraceMessage msg;
@@ -844,7 +956,12 @@ TraceManager::TraceManager()
     activated = getParameterTraceEnable();
 
     if (activated)
-        trace_storage.reset(new SyncTraceStorage(std::string(getParameterTraceLocation()) + ".txt"));
+    {
+        if (getParameterTraceFormat() == TRACE_FORMAT_CHROME)
+            trace_storage.reset(new ChromeTraceWriter(std::string(getParameterTraceLocation()) + ".json"));
+        else
+            trace_storage.reset(new SyncTraceStorage(std::string(getParameterTraceLocation()) + ".txt"));
+    }
 
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
@@ -1071,6 +1188,9 @@ void traceArg(const TraceArg& arg, const char* value)
     initTraceArg(ctx, arg);
     if (!value)
         value = "<null>";
+    TraceStorage* s = ctx.getStorage();
+    if (s)
+        s->putRegionArg(*region, arg, value);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -1086,6 +1206,9 @@ void traceArg(const TraceArg& arg, int value)
         return;
     CV_Assert(region->pImpl);
     initTraceArg(ctx, arg);
+    TraceStorage* s = ctx.getStorage();
+    if (s)
+        s->putRegionArg(*region, arg, (int64)value);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -1103,6 +1226,9 @@ void traceArg(const TraceArg& arg, int64 value)
         return;
     CV_Assert(region->pImpl);
     initTraceArg(ctx, arg);
+    TraceStorage* s = ctx.getStorage();
+    if (s)
+        s->putRegionArg(*region, arg, value);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -1120,6 +1246,9 @@ void traceArg(const TraceArg& arg, double value)
         return;
     CV_Assert(region->pImpl);
     initTraceArg(ctx, arg);
+    TraceStorage* s = ctx.getStorage();
+    if (s)
+        s->putRegionArg(*region, arg, value);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
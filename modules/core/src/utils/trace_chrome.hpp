@@ -0,0 +1,235 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_TRACE_CHROME_HPP
+#define OPENCV_CORE_TRACE_CHROME_HPP
+
+#if 1 // if not already in precompiled headers
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#endif
+
+#include <opencv2/core/utility.hpp>
+
+namespace cv {
+namespace utils {
+namespace trace {
+namespace details {
+
+/**
+ * Chrome Trace Event format file (JSON Object Format)
+ *
+ * Events are produced by per-thread ChromeTraceEventBuffer objects and are written in batches.
+ */
+class ChromeTraceFile
+{
+    std::ofstream out;
+    cv::Mutex mutex;
+    bool empty;
+public:
+    const std::string name;
+
+    ChromeTraceFile(const std::string& filename) :
+        out(filename.c_str(), std::ios::trunc),
+        empty(true),
+        name(filename)
+    {
+        out << "{\"otherData\":{\"description\":\"OpenCV trace file\",\"version\":\"1.0\"},"
+               "\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    }
+    ~ChromeTraceFile()
+    {
+        cv::AutoLock l(mutex);
+        out << "\n]}" << std::endl;
+        out.close();
+    }
+
+    /** @param events comma-prefixed list of JSON objects */
+    bool write(const std::string& events)
+    {
+        if (events.empty())
+            return true;
+        cv::AutoLock l(mutex);
+        out << (empty ? events.c_str() + 1 : events.c_str());
+        empty = false;
+        return true;
+    }
+};
+
+/**
+ * Per-thread buffer of Chrome trace events.
+ *
+ * Buffer is filled by the owner thread only (without locks) and it is passed to the file when it is full.
+ * Region arguments are merged into "E" events (viewers merge arguments of "B" and "E" events).
+ */
+class ChromeTraceEventBuffer
+{
+    struct Event
+    {
+        char phase;  // 'B' / 'E'
+        long long timestamp;  // ns
+        const char* name;  // static storage, 'B' events only
+        bool app;
+        int args;  // index in 'args' or -1
+    };
+    struct OpenRegion
+    {
+        long long id;
+        std::string args;
+    };
+
+    const cv::Ptr<ChromeTraceFile> file;
+    const int threadID;
+    const size_t capacity;
+    std::vector<Event> events;
+    std::vector<std::string> args;
+    std::vector<OpenRegion> openRegions;
+    std::string buf;
+
+public:
+    ChromeTraceEventBuffer(const cv::Ptr<ChromeTraceFile>& file_, int threadID_, size_t capacity_) :
+        file(file_),
+        threadID(threadID_),
+        capacity(std::max((size_t)16, capacity_))
+    {
+        events.reserve(capacity);
+        file->write(cv::format(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"OpenCVThread-%03d\"}}",
+                threadID, threadID));
+    }
+    ~ChromeTraceEventBuffer()
+    {
+        flush();
+    }
+
+    /** @param name region name with static storage duration */
+    void regionEnter(long long id, long long timestamp, const char* name, bool app)
+    {
+        OpenRegion r;
+        r.id = id;
+        openRegions.push_back(r);
+        push('B', timestamp, name, app, -1);
+    }
+
+    void regionLeave(long long id, long long timestamp, int skippedRegions)
+    {
+        int argsIdx = -1;
+        OpenRegion* r = findOpenRegion(id);
+        if (r)
+        {
+            if (skippedRegions)
+                appendArg(r->args, "skipped", cv::format("%d", skippedRegions));
+            if (!r->args.empty())
+            {
+                argsIdx = (int)args.size();
+                args.push_back(std::string());
+                args.back().swap(r->args);
+            }
+            openRegions.erase(openRegions.begin() + (r - &openRegions[0]), openRegions.end());
+        }
+        push('E', timestamp, NULL, false, argsIdx);
+    }
+
+    /** @param value JSON value */
+    bool regionArg(long long id, const char* name, const std::string& value)
+    {
+        OpenRegion* r = findOpenRegion(id);
+        if (!r)
+            return false;
+        appendArg(r->args, name, value);
+        return true;
+    }
+
+    void flush()
+    {
+        if (events.empty())
+            return;
+        buf.clear();
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            const Event& e = events[i];
+            char tmp[256];
+            int n = snprintf(tmp, sizeof(tmp), ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%lld.%03d",
+                    e.phase, threadID, e.timestamp / 1000, (int)(e.timestamp % 1000));
+            buf.append(tmp, std::min((size_t)n, sizeof(tmp) - 1));
+            if (e.phase == 'B')
+            {
+                buf += ",\"name\":\"";
+                buf += escape(e.name);
+                buf += "\",\"cat\":\"";
+                buf += e.app ? "app" : "opencv";
+                buf += "\"";
+            }
+            if (e.args >= 0)
+            {
+                buf += ",\"args\":{";
+                buf += args[e.args];
+                buf += "}";
+            }
+            buf += "}";
+        }
+        events.clear();
+        args.clear();
+        file->write(buf);
+    }
+
+    static std::string escape(const char* str)
+    {
+        std::string result;
+        for (; str && *str; str++)
+        {
+            const char c = *str;
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+                result += c;
+            }
+            else if ((unsigned char)c < 0x20)
+                result += cv::format("\\u%04x", (int)c);
+            else
+                result += c;
+        }
+        return result;
+    }
+
+protected:
+    void push(char phase, long long timestamp, const char* name, bool app, int argsIdx)
+    {
+        Event e;
+        e.phase = phase;
+        e.timestamp = timestamp;
+        e.name = name;
+        e.app = app;
+        e.args = argsIdx;
+        events.push_back(e);
+        if (events.size() >= capacity)
+            flush();
+    }
+
+    OpenRegion* findOpenRegion(long long id)
+    {
+        for (size_t i = openRegions.size(); i > 0; i--)
+        {
+            if (openRegions[i - 1].id == id)
+                return &openRegions[i - 1];
+        }
+        return NULL;
+    }
+
+    static void appendArg(std::string& dst, const char* name, const std::string& value)
+    {
+        if (!dst.empty())
+            dst += ",";
+        dst += "\"";
+        dst += escape(name);
+        dst += "\":";
+        dst += value;
+    }
+};
+
+}}}} // namespace
+
+#endif // OPENCV_CORE_TRACE_CHROME_HPP
@@ -2,6 +2,7 @@
 // It is subject to the license terms in the LICENSE file found in the top-level directory
 // of this distribution and at http://opencv.org/license.html.
 #include "test_precomp.hpp"
+#include "opencv2/core/utils/allocator_pool.hpp"
 
 namespace opencv_test { namespace {
 
@@ -141,4 +142,123 @@ TEST_F(AllocatorTest, DummyAllocator)
     EXPECT_EQ(2, DummyAllocator::deallocations);
 }
 
+TEST(PoolAllocator, reuse_buffers)
+{
+    cv::MatAllocator* pool = cv::utils::getPoolAllocator();
+    cv::BufferPoolController* controller = pool->getBufferPoolController();
+    ASSERT_TRUE(controller != nullptr);
+    const size_t maxReservedSize = controller->getMaxReservedSize();
+    controller->setMaxReservedSize(16 << 20);
+    controller->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, controller->getReservedSize());
+    cv::utils::resetPoolAllocatorStatistics();
+
+    const uchar* first_ptr = NULL;
+    for (int iter = 0; iter < 10; iter++)
+    {
+        cv::Mat m;
+        m.allocator = pool;
+        m.create(480, 641, CV_8UC3);
+        EXPECT_EQ(pool, m.allocator);
+        m.setTo(cv::Scalar::all(iter));
+        if (iter == 0)
+            first_ptr = m.data;
+        else
+            EXPECT_EQ(first_ptr, m.data);
+    }
+
+    cv::utils::PoolAllocatorStatistics stats = cv::utils::getPoolAllocatorStatistics();
+    EXPECT_EQ((uint64_t)1, stats.misses);
+    EXPECT_EQ((uint64_t)9, stats.hits);
+    EXPECT_EQ((uint64_t)0, stats.evictions);
+    EXPECT_GE(stats.retainedSize, (size_t)480*641*3);
+    EXPECT_EQ(stats.retainedSize, controller->getReservedSize());
+
+    controller->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, controller->getReservedSize());
+    controller->setMaxReservedSize(maxReservedSize);
+}
+
+TEST(PoolAllocator, limit)
+{
+    cv::MatAllocator* pool = cv::utils::getPoolAllocator();
+    cv::BufferPoolController* controller = pool->getBufferPoolController();
+    const size_t maxReservedSize = controller->getMaxReservedSize();
+    controller->freeAllReservedBuffers();
+    controller->setMaxReservedSize(1 << 20);
+    cv::utils::resetPoolAllocatorStatistics();
+
+    {
+        cv::Mat a, b;
+        a.allocator = b.allocator = pool;
+        a.create(700, 1000, CV_8UC1);
+        b.create(700, 1000, CV_8UC1);
+    }
+    // only one buffer fits into the pool
+    cv::utils::PoolAllocatorStatistics stats = cv::utils::getPoolAllocatorStatistics();
+    EXPECT_EQ((uint64_t)2, stats.misses);
+    EXPECT_EQ((uint64_t)1, stats.evictions);
+    EXPECT_LE(controller->getReservedSize(), (size_t)(1 << 20));
+
+    controller->setMaxReservedSize(0);
+    EXPECT_EQ((size_t)0, controller->getReservedSize());
+    controller->setMaxReservedSize(maxReservedSize);
+}
+
+TEST(PoolAllocator, usage)
+{
+    cv::MatAllocator* pool = cv::utils::getPoolAllocator();
+    cv::utils::resetPoolAllocatorStatistics();
+    cv::utils::PoolAllocatorStatistics stats = cv::utils::getPoolAllocatorStatistics();
+    const uint64_t base = stats.currentUsage;
+    EXPECT_EQ(base, stats.peakUsage);
+
+    {
+        cv::Mat a, b;
+        a.allocator = b.allocator = pool;
+        a.create(100, 100, CV_8UC1);
+        b.create(200, 100, CV_8UC1);
+        stats = cv::utils::getPoolAllocatorStatistics();
+        EXPECT_EQ(base + 30000, stats.currentUsage);
+        EXPECT_EQ(base + 30000, stats.peakUsage);
+        a.release();
+        stats = cv::utils::getPoolAllocatorStatistics();
+        EXPECT_EQ(base + 20000, stats.currentUsage);
+        EXPECT_EQ(base + 30000, stats.peakUsage);
+
+        cv::utils::resetPoolAllocatorStatistics();
+        stats = cv::utils::getPoolAllocatorStatistics();
+        EXPECT_EQ(base + 20000, stats.peakUsage);
+
+        // user-allocated data is not accounted
+        uchar buf[16];
+        cv::Mat c(4, 4, CV_8UC1, buf);
+        c.allocator = pool;
+        stats = cv::utils::getPoolAllocatorStatistics();
+        EXPECT_EQ(base + 20000, stats.currentUsage);
+    }
+    stats = cv::utils::getPoolAllocatorStatistics();
+    EXPECT_EQ(base, stats.currentUsage);
+    EXPECT_EQ(base + 20000, stats.peakUsage);
+    pool->getBufferPoolController()->freeAllReservedBuffers();
+}
+
+TEST(PoolAllocator, parallel)
+{
+    cv::MatAllocator* pool = cv::utils::getPoolAllocator();
+    cv::Mat::setDefaultAllocator(pool);
+    cv::parallel_for_(cv::Range(0, 64), [&](const cv::Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            cv::Mat src(100 + i, 200, CV_32FC1, cv::Scalar::all(i)), dst;
+            cv::add(src, src, dst);
+            EXPECT_EQ(pool, dst.u->currAllocator);
+            EXPECT_EQ(0, cv::countNonZero(dst != 2.0f * i));
+        }
+    });
+    cv::Mat::setDefaultAllocator(cv::Mat::getStdAllocator());
+    pool->getBufferPoolController()->freeAllReservedBuffers();
+}
+
 }} // namespace
@@ -2,6 +2,7 @@
 // It is subject to the license terms in the LICENSE file found in the top-level directory
 // of this distribution and at http://opencv.org/license.html.
 #include "test_precomp.hpp"
+#include <opencv2/core/parallel/parallel_backend.hpp>
 
 namespace opencv_test { namespace {
 
@@ -983,4 +984,103 @@ protected:
 TEST(Core_DFT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDFT); test.safe_run(); }
 TEST(Core_DCT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDCT); test.safe_run(); }
 
+TEST(Core_DFT, plan)
+{
+    const int flags_list[] = { 0, DFT_COMPLEX_OUTPUT, DFT_ROWS, DFT_INVERSE | DFT_SCALE, DFT_INVERSE | DFT_REAL_OUTPUT };
+    for (int iter = 0; iter < 20; iter++)
+    {
+        RNG& rng = theRNG();
+        int depth = rng.uniform(0, 2) ? CV_64F : CV_32F;
+        int cn = rng.uniform(1, 3);
+        int flags = flags_list[rng.uniform(0, 5)];
+        if ((flags & DFT_REAL_OUTPUT) && cn == 1)
+            cn = 2;
+        Size sz(rng.uniform(2, 40), rng.uniform(2, 40));
+        Mat src(sz, CV_MAKETYPE(depth, cn)), expected;
+        randu(src, -1., 1.);
+        cv::dft(src, expected, flags);
+
+        DFTPlan plan(sz, src.type(), flags);
+        ASSERT_EQ(expected.type(), plan.dstType());
+        for (int k = 0; k < 2; k++)  // reused plan
+        {
+            Mat dst;
+            plan.apply(src, dst);
+            EXPECT_LE(cvtest::norm(dst, expected, NORM_INF), 1e-4) << "size=" << sz << " flags=" << flags;
+        }
+        if (plan.dstType() == src.type())
+        {
+            Mat inplace = src.clone();
+            plan.apply(inplace, inplace);
+            EXPECT_LE(cvtest::norm(inplace, expected, NORM_INF), 1e-4) << "size=" << sz << " flags=" << flags;
+        }
+    }
+    Mat wrongSize(10, 10, CV_32FC1);
+    DFTPlan plan(Size(8, 8), CV_32FC1);
+    Mat dst;
+    EXPECT_ANY_THROW(plan.apply(wrongSize, dst));
+}
+
+typedef testing::TestWithParam<tuple<perf::MatType, int> > Core_DFT_Parallel;
+
+TEST_P(Core_DFT_Parallel, matches_serial)
+{
+    const int type = get<0>(GetParam());
+    const int flags = get<1>(GetParam());
+    Mat src(360, 480, type), serial, parallel;
+    randu(src, -1., 1.);
+    {
+        ParallelForScope scope(1);
+        cv::dft(src, serial, flags);
+    }
+    cv::dft(src, parallel, flags);
+    EXPECT_EQ(0, cvtest::norm(serial, parallel, NORM_INF));
+
+    // in-place
+    Mat inplace = src.clone();
+    if (serial.type() == src.type())
+    {
+        cv::dft(inplace, inplace, flags);
+        EXPECT_EQ(0, cvtest::norm(serial, inplace, NORM_INF));
+    }
+}
+
+// transforms of the same size started from tasks of a work-stealing backend: the waiting thread of
+// one transform executes the others, so they must not share the cached context
+TEST(Core_DFT, parallel_nested_same_size)
+{
+    const int prevNumThreads = cv::getNumThreads();
+    if (!cv::parallel::setParallelForBackend("WORKSTEALING"))
+        throw SkipTestException("work-stealing backend is not available");
+    cv::setNumThreads(4);
+
+    const int n = 8;
+    std::vector<Mat> src(n), expected(n), dst(n);
+    for (int i = 0; i < n; i++)
+    {
+        src[i].create(360, 480, CV_32FC2);
+        randu(src[i], -1., 1.);
+        ParallelForScope scope(1);
+        cv::dft(src[i], expected[i]);
+    }
+    for (int iter = 0; iter < 3; iter++)
+    {
+        parallel_for_(Range(0, n), [&](const Range& r)
+        {
+            for (int i = r.start; i < r.end; i++)
+                cv::dft(src[i], dst[i]);
+        });
+        for (int i = 0; i < n; i++)
+            EXPECT_EQ(0, cvtest::norm(expected[i], dst[i], NORM_INF)) << "iter=" << iter << " i=" << i;
+    }
+
+    cv::parallel::setParallelForBackend("");
+    cv::setNumThreads(prevNumThreads);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_DFT_Parallel, testing::Combine(
+    testing::Values(CV_32FC1, CV_32FC2, CV_64FC1, CV_64FC2),
+    testing::Values(0, (int)DFT_COMPLEX_OUTPUT, (int)DFT_ROWS, (int)(DFT_INVERSE | DFT_SCALE))
+));
+
 }} // namespace
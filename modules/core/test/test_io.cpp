@@ -2108,4 +2108,177 @@ INSTANTIATE_TEST_CASE_P(Core_InputOutput,
     FileStorage_exact_type, Values(".yml", ".xml", ".json")
 );
 
+typedef testing::TestWithParam<const char*> FileStorage_raw_blobs;
+TEST_P(FileStorage_raw_blobs, write_read)
+{
+    const std::string fname = cv::tempfile(GetParam());
+    const std::string blobname = fname + ".blob";
+
+    Mat m2d(17, 33, CV_32FC3), m8u(5, 7, CV_8UC1), big(64, 80, CV_64F);
+    randu(m2d, -100, 100);
+    randu(m8u, 0, 255);
+    randu(big, -1, 1);
+    Mat roi = big(Rect(3, 5, 11, 13)); // not continuous
+    const int sizes[] = {3, 4, 5};
+    Mat mnd(3, sizes, CV_16SC2);
+    randu(mnd, -1000, 1000);
+
+    {
+        FileStorage fs(fname, FileStorage::WRITE | FileStorage::RAW_BLOBS);
+        ASSERT_TRUE(fs.isOpened());
+        fs << "m2d" << m2d;
+        fs << "n" << 5;
+        fs << "m8u" << m8u;
+        fs << "roi" << roi;
+        fs << "mnd" << mnd;
+        fs << "empty" << Mat();
+        fs.release();
+    }
+
+    Mat r2d, r8u, rroi, rnd, rempty;
+    {
+        FileStorage fs(fname, FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        EXPECT_TRUE(fs["m2d"]["data"].empty());
+        EXPECT_FALSE(fs["m2d"]["blob"].empty());
+        fs["m2d"] >> r2d;
+        fs["m8u"] >> r8u;
+        fs["roi"] >> rroi;
+        fs["mnd"] >> rnd;
+        fs["empty"] >> rempty;
+        EXPECT_EQ(5, (int)fs["n"]);
+
+        // the same block is mapped, not copied
+        Mat r2d_again;
+        fs["m2d"] >> r2d_again;
+        EXPECT_EQ(r2d.data, r2d_again.data);
+    }
+
+    // matrices keep the mapping alive after release()
+    EXPECT_EQ(0, cvtest::norm(m2d, r2d, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(m8u, r8u, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(roi, rroi, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(mnd, rnd, NORM_INF));
+    EXPECT_TRUE(rempty.empty());
+    EXPECT_EQ(0u, (size_t)r2d.data % 64);
+    EXPECT_EQ(0u, (size_t)r8u.data % 64);
+    EXPECT_TRUE(rroi.isContinuous());
+    EXPECT_EQ(3, rnd.dims);
+
+    // the mapping is private, the file is not changed
+    r2d.setTo(Scalar::all(0));
+    {
+        FileStorage fs(fname, FileStorage::READ);
+        Mat r = fs["m2d"].mat();
+        EXPECT_EQ(0, cvtest::norm(m2d, r, NORM_INF));
+    }
+
+    r2d.release();
+    r8u.release();
+    rroi.release();
+    rnd.release();
+    EXPECT_EQ(0, remove(fname.c_str()));
+    EXPECT_EQ(0, remove(blobname.c_str()));
+}
+
+TEST_P(FileStorage_raw_blobs, append)
+{
+    const std::string fname = cv::tempfile(GetParam());
+    Mat a(10, 10, CV_8UC1, Scalar::all(1)), b(3, 100, CV_32SC1, Scalar::all(-5));
+    {
+        FileStorage fs(fname, FileStorage::WRITE | FileStorage::RAW_BLOBS);
+        fs << "a" << a;
+    }
+    {
+        FileStorage fs(fname, FileStorage::APPEND | FileStorage::RAW_BLOBS);
+        fs << "b" << b;
+    }
+    {
+        FileStorage fs(fname, FileStorage::READ);
+        EXPECT_EQ(0, cvtest::norm(a, fs["a"].mat(), NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(b, fs["b"].mat(), NORM_INF));
+    }
+    EXPECT_EQ(0, remove(fname.c_str()));
+    EXPECT_EQ(0, remove((fname + ".blob").c_str()));
+}
+
+TEST_P(FileStorage_raw_blobs, rewrite_loaded)
+{
+    const std::string fname = cv::tempfile(GetParam());
+    const std::string blobname = fname + ".blob";
+    Mat w(512, 512, CV_32FC1);
+    randu(w, -1, 1);
+    {
+        FileStorage fs(fname, FileStorage::WRITE | FileStorage::RAW_BLOBS);
+        fs << "w" << w;
+    }
+    Mat loaded;
+    {
+        FileStorage fs(fname, FileStorage::READ);
+        loaded = fs["w"].mat();
+    }
+    // the storage is rewritten while the loaded matrix still points into the mapped file
+    Mat small(2, 2, CV_32FC1, Scalar::all(7));
+    {
+        FileStorage fs(fname, FileStorage::WRITE | FileStorage::RAW_BLOBS);
+        fs << "w" << small;
+    }
+    EXPECT_EQ(0, cvtest::norm(w, loaded, NORM_INF));
+    {
+        FileStorage fs(fname, FileStorage::READ);
+        EXPECT_EQ(0, cvtest::norm(small, fs["w"].mat(), NORM_INF));
+    }
+    EXPECT_NE(0, remove((blobname + ".tmp").c_str()));  // replaced the companion file
+
+    loaded.release();
+    EXPECT_EQ(0, remove(fname.c_str()));
+    EXPECT_EQ(0, remove(blobname.c_str()));
+}
+
+TEST(Core_InputOutput, FileStorage_raw_blobs_invalid_sizes)
+{
+    const std::string fname = cv::tempfile(".yml");
+    const std::string blobname = fname + ".blob";
+    {
+        FileStorage fs(fname, FileStorage::WRITE | FileStorage::RAW_BLOBS);
+        fs << "m" << Mat(10, 10, CV_32FC1, Scalar::all(1));
+    }
+    const int64_t ofs = 64;
+    const char* const headers[] = {
+        "rows: 0\n   cols: 10\n",
+        "rows: 10\n   cols: -1\n",
+        "rows: 11\n   cols: 10\n",                          // exceeds the blob file
+        "sizes: [ 65536, 65536, 65536, 65536 ]\n",             // size_t overflow
+        "sizes: [ 2147483647, 2147483647, 2147483647 ]\n"
+    };
+    for (size_t i = 0; i < sizeof(headers)/sizeof(headers[0]); i++)
+    {
+        {
+            std::ofstream f(fname.c_str());
+            f << "%YAML:1.0\nm: !!opencv-matrix\n   " << headers[i]
+              << "   dt: f\n   blob: " << ofs << "\n";
+        }
+        FileStorage fs(fname, FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        Mat m;
+        EXPECT_ANY_THROW(fs["m"] >> m) << headers[i];
+    }
+    EXPECT_EQ(0, remove(fname.c_str()));
+    EXPECT_EQ(0, remove(blobname.c_str()));
+}
+
+INSTANTIATE_TEST_CASE_P(Core_InputOutput,
+    FileStorage_raw_blobs, Values(".yml", ".xml", ".json")
+);
+
+TEST(Core_InputOutput, FileStorage_raw_blobs_memory)
+{
+    EXPECT_ANY_THROW(FileStorage(".yml", FileStorage::WRITE | FileStorage::MEMORY | FileStorage::RAW_BLOBS));
+
+    const std::string content = "%YAML:1.0\nm: !!opencv-matrix\n   rows: 1\n   cols: 1\n   dt: u\n   blob: 64\n";
+    FileStorage fs(content, FileStorage::READ | FileStorage::MEMORY);
+    Mat m;
+    EXPECT_ANY_THROW(fs["m"] >> m);
+}
+
 }} // namespace
@@ -2771,6 +2771,50 @@ TEST(Core_SolvePoly, accuracy) { Core_SolvePolyTest test; test.safe_run(); }
 TEST(Core_Phase, accuracy32f) { Core_PhaseTest test(CV_32FC1); test.safe_run(); }
 TEST(Core_Phase, accuracy64f) { Core_PhaseTest test(CV_64FC1); test.safe_run(); }
 
+typedef testing::TestWithParam<int> Core_GEMM_Packed;
+
+TEST_P(Core_GEMM_Packed, accuracy)
+{
+    const int flags = GetParam();
+    const int M = 150, N = 97, K = 211;
+    Mat A = (flags & GEMM_1_T) ? Mat(K, M, CV_32F) : Mat(M, K, CV_32F);
+    Mat B = (flags & GEMM_2_T) ? Mat(N, K, CV_32F) : Mat(K, N, CV_32F);
+    Mat C = (flags & GEMM_3_T) ? Mat(N, M, CV_32F) : Mat(M, N, CV_32F);
+    cv::randu(A, -1, 1);
+    cv::randu(B, -1, 1);
+    cv::randu(C, -1, 1);
+
+    Mat A64, B64, C64, ref, dst;
+    A.convertTo(A64, CV_64F);
+    B.convertTo(B64, CV_64F);
+    C.convertTo(C64, CV_64F);
+    cv::gemm(A64, B64, 0.5, C64, -2, ref, flags);
+    ref.convertTo(ref, CV_32F);
+
+    cv::gemm(A, B, 0.5, C, -2, dst, flags);
+    ASSERT_EQ(CV_32F, dst.type());
+    EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), 1e-4);
+
+    // no C, ROI operands
+    Mat Abig(A.rows + 2, A.cols + 3, CV_32F, Scalar::all(100)), Dbig(M + 1, N + 5, CV_32F, Scalar::all(7));
+    A.copyTo(Abig(Rect(1, 2, A.cols, A.rows)));
+    Mat D = Dbig(Rect(2, 1, N, M));
+    cv::gemm(Abig(Rect(1, 2, A.cols, A.rows)), B, 0.5, noArray(), 0, D, flags & ~GEMM_3_T);
+    cv::gemm(A64, B64, 0.5, noArray(), 0, ref, flags & ~GEMM_3_T);
+    ref.convertTo(ref, CV_32F);
+    EXPECT_LE(cvtest::norm(D, ref, NORM_INF), 1e-4);
+    EXPECT_EQ(0, cvtest::norm(Dbig.row(0), Mat(1, N + 5, CV_32F, Scalar::all(7)), NORM_INF));
+
+    // in-place accumulation into C
+    Mat Cin = C.clone();
+    cv::gemm(A64, B64, 1, C64, 1, ref, flags);
+    ref.convertTo(ref, CV_32F);
+    cv::gemm(A, B, 1, Cin, 1, Cin, flags);
+    EXPECT_LE(cvtest::norm(Cin, ref, NORM_INF), 1e-4);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_GEMM_Packed, testing::Range(0, 8));
+
 TEST(Core_SVD, flt)
 {
     float a[] = {
@@ -2987,6 +3031,52 @@ TEST(Core_KMeans, bad_input)
     }
 }
 
+TEST(Core_KMeans, hamerly_same_as_lloyd)
+{
+    const int N = 5000, dims = 8, K = 40;
+    const TermCriteria crit(TermCriteria::COUNT + TermCriteria::EPS, 50, 1e-4);
+    Mat data(N, dims, CV_32F);
+    cv::randn(data, Scalar::all(0), Scalar::all(10));
+    for (int flags = 0; flags <= KMEANS_PP_CENTERS; flags += KMEANS_PP_CENTERS)
+    {
+        Mat labels0, centers0, labels1, centers1;
+        theRNG().state = 0x12345678;
+        double compactness0 = kmeans(data, K, labels0, crit, 2, flags, centers0);
+        theRNG().state = 0x12345678;
+        double compactness1 = kmeans(data, K, labels1, crit, 2, flags | KMEANS_HAMERLY, centers1);
+
+        EXPECT_EQ(compactness0, compactness1);
+        EXPECT_EQ(0, cvtest::norm(centers0, centers1, NORM_INF));
+        EXPECT_EQ(0, countNonZero(labels0 != labels1));
+    }
+}
+
+TEST(Core_KMeans, mini_batch)
+{
+    const int N = 20000, dims = 4, K = 8;
+    Mat gt_centers(K, dims, CV_32F), data(N, dims, CV_32F);
+    cv::randu(gt_centers, Scalar::all(-100), Scalar::all(100));
+    cv::randn(data, Scalar::all(0), Scalar::all(1));
+    for (int i = 0; i < N; i++)
+        data.row(i) += gt_centers.row(i % K);
+
+    Mat labels, centers, labels_full, centers_full;
+    const TermCriteria crit(TermCriteria::COUNT + TermCriteria::EPS, 200, 1e-3);
+    double compactness_full = kmeans(data, K, labels_full, crit, 3, KMEANS_PP_CENTERS, centers_full);
+    double compactness = kmeans(data, K, labels, crit, 3, KMEANS_PP_CENTERS | KMEANS_MINI_BATCH, centers);
+
+    ASSERT_EQ(N, labels.rows);
+    ASSERT_EQ(K, centers.rows);
+    EXPECT_LE(compactness, compactness_full * 1.05);
+
+    double expected = 0;
+    for (int i = 0; i < N; i++)
+        expected += cvtest::norm(data.row(i), centers.row(labels.at<int>(i)), NORM_L2SQR);
+    EXPECT_NEAR(expected, compactness, expected * 1e-6);
+
+    EXPECT_ANY_THROW(kmeans(data, K, labels, crit, 1, KMEANS_MINI_BATCH | KMEANS_HAMERLY, centers));
+}
+
 TEST(CovariationMatrixVectorOfMat, accuracy)
 {
     unsigned int col_problem_size = 8, row_problem_size = 8, vector_size = 16;
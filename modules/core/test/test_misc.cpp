@@ -5,12 +5,23 @@
 #include <cmath>
 
 #include "opencv2/core/utils/logger.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
 
 #include <opencv2/core/utils/fp_control_utils.hpp>
+#include <opencv2/core/parallel/parallel_backend.hpp>
 
+#include "../src/parallel_affinity.hpp"
+
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <set>
 #include <thread>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 namespace opencv_test { namespace {
 
 TEST(Core_OutputArrayCreate, _1997)
@@ -304,6 +315,331 @@ TEST(Core_Parallel, propagate_fp_denormals_ignore_hint)
     }
 }
 
+class NestedParallelLoopBody : public cv::ParallelLoopBody
+{
+public:
+    NestedParallelLoopBody(cv::Mat_<int>& dst) : dst_(dst) {}
+    void operator()(const cv::Range& r) const CV_OVERRIDE
+    {
+        for (int y = r.start; y < r.end; y++)
+        {
+            cv::Mat_<int>& dst = dst_;
+            parallel_for_(cv::Range(0, dst.cols), [&](const cv::Range& rx)
+            {
+                for (int x = rx.start; x < rx.end; x++)
+                    dst(y, x) = y * 1000 + x;
+            });
+        }
+    }
+protected:
+    cv::Mat_<int>& dst_;
+};
+
+static void checkNestedParallelLoopResult(const cv::Mat_<int>& dst)
+{
+    int errors = 0;
+    for (int y = 0; y < dst.rows; y++)
+        for (int x = 0; x < dst.cols; x++)
+            errors += dst(y, x) != y * 1000 + x;
+    EXPECT_EQ(0, errors);
+}
+
+TEST(Core_Parallel, workstealing_backend)
+{
+    const int prevNumThreads = cv::getNumThreads();
+    if (!cv::parallel::setParallelForBackend("WORKSTEALING"))
+        throw SkipTestException("work-stealing backend is not available");
+    cv::setNumThreads(4);
+    EXPECT_EQ(4, cv::getNumThreads());
+
+    // nested regions
+    cv::Mat_<int> dst(64, 333, 0);
+    EXPECT_NO_THROW(parallel_for_(cv::Range(0, dst.rows), NestedParallelLoopBody(dst)));
+    checkNestedParallelLoopResult(dst);
+
+    // concurrent calls from application threads
+    std::vector<cv::Mat_<int> > results(3);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        cv::Mat_<int>& result = results[i];
+        result.create(50 + (int)i, 200);
+        result.setTo(0);
+        threads.push_back(std::thread([&result]() {
+            parallel_for_(cv::Range(0, result.rows), NestedParallelLoopBody(result));
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    for (size_t i = 0; i < results.size(); i++)
+        checkNestedParallelLoopResult(results[i]);
+
+    // exceptions
+    Mat dst2(1000, 100, CV_8SC1, Scalar::all(0));
+    EXPECT_THROW(parallel_for_(cv::Range(0, dst2.rows), ThrowErrorParallelLoopBody(dst2, dst2.rows / 2)), cv::Exception);
+
+    cv::parallel::setParallelForBackend("");
+    cv::setNumThreads(prevNumThreads);
+}
+
+class ConcurrencyCheckerParallelLoopBody : public cv::ParallelLoopBody
+{
+public:
+    ConcurrencyCheckerParallelLoopBody() : active(0), maxActive(0), calls(0) {}
+    void operator()(const cv::Range& /*r*/) const CV_OVERRIDE
+    {
+        int n = ++active;
+        int prev = maxActive.load();
+        while (n > prev && !maxActive.compare_exchange_weak(prev, n)) {}
+        calls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        active--;
+    }
+    mutable std::atomic<int> active;
+    mutable std::atomic<int> maxActive;
+    mutable std::atomic<int> calls;
+};
+
+TEST(Core_Parallel, scope_limit)
+{
+    const int prevNumThreads = cv::getNumThreads();
+    cv::setNumThreads(4);
+    {
+        cv::ParallelForScope scope(2);
+        EXPECT_LE(cv::getNumThreads(), 2);
+        ConcurrencyCheckerParallelLoopBody body;
+        parallel_for_(cv::Range(0, 64), body);
+        EXPECT_EQ(64, body.calls.load());
+        EXPECT_LE(body.maxActive.load(), 2);
+        {
+            cv::ParallelForScope nested(3);  // can't extend outer budget
+            EXPECT_LE(cv::getNumThreads(), 2);
+        }
+        {
+            cv::ParallelForScope serial(1);
+            EXPECT_EQ(1, cv::getNumThreads());
+            ConcurrencyCheckerParallelLoopBody serialBody;
+            parallel_for_(cv::Range(0, 16), serialBody);
+            EXPECT_EQ(1, serialBody.maxActive.load());
+        }
+    }
+    {
+        cv::ParallelForScope scope(0, 5);
+        ConcurrencyCheckerParallelLoopBody body;
+        parallel_for_(cv::Range(0, 100), body);
+        EXPECT_LE(body.calls.load(), 5);
+    }
+    {
+        // budget is applied to nested regions executed by worker threads
+        cv::ParallelForScope scope(2);
+        cv::Mat_<int> dst(16, 100, 0);
+        parallel_for_(cv::Range(0, dst.rows), NestedParallelLoopBody(dst));
+        checkNestedParallelLoopResult(dst);
+
+        Mat dst2(1000, 100, CV_8SC1, Scalar::all(0));
+        EXPECT_THROW(parallel_for_(cv::Range(0, dst2.rows), ThrowErrorParallelLoopBody(dst2, dst2.rows / 2)), cv::Exception);
+    }
+    EXPECT_EQ(4, cv::getNumThreads());
+    cv::setNumThreads(prevNumThreads);
+}
+
+TEST(Core_Parallel, workstealing_backend_external_threads)
+{
+    const int prevNumThreads = cv::getNumThreads();
+    if (!cv::parallel::setParallelForBackend("WORKSTEALING"))
+        throw SkipTestException("work-stealing backend is not available");
+    cv::setNumThreads(3);
+
+    // concurrent callers outside of the pool don't share thread numbers
+    const int ncallers = 3;
+    std::vector<std::thread> threads;
+    std::vector<std::set<int> > callerIds(ncallers);
+    std::atomic<int> inside(0);
+    for (int t = 0; t < ncallers; t++)
+    {
+        std::set<int>& ids = callerIds[t];
+        threads.push_back(std::thread([&ids, &inside]() {
+            const std::thread::id caller = std::this_thread::get_id();
+            std::mutex mutex;
+            bool first = true;
+            parallel_for_(cv::Range(0, 64), [&](const cv::Range&)
+            {
+                if (std::this_thread::get_id() != caller)
+                    return;
+                if (first)
+                {
+                    // keep all callers inside of their jobs at the same time
+                    first = false;
+                    inside++;
+                    for (int i = 0; i < 2000 && inside.load() < ncallers; i++)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(cv::getThreadNum());
+            });
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    std::set<int> allIds;
+    for (int t = 0; t < ncallers; t++)
+    {
+        ASSERT_EQ((size_t)1, callerIds[t].size());
+        int id = *callerIds[t].begin();
+        EXPECT_TRUE(id == 0 || id >= cv::getNumThreads()) << id;
+        allIds.insert(id);
+    }
+    EXPECT_EQ((size_t)ncallers, allIds.size());
+
+    // reconfiguration while other threads run jobs
+    std::atomic<bool> done(false);
+    std::vector<cv::Mat_<int> > results(2);
+    threads.clear();
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        cv::Mat_<int>& result = results[i];
+        result.create(40, 100);
+        threads.push_back(std::thread([&result, &done]() {
+            while (!done)
+            {
+                result.setTo(0);
+                parallel_for_(cv::Range(0, result.rows), NestedParallelLoopBody(result));
+                checkNestedParallelLoopResult(result);
+            }
+        }));
+    }
+    for (int i = 0; i < 20; i++)
+        cv::setNumThreads(2 + i % 3);
+    done = true;
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    // can't be reconfigured from a parallel region
+    cv::setNumThreads(4);
+    parallel_for_(cv::Range(0, 2), [&](const cv::Range&) { cv::setNumThreads(2); });
+    EXPECT_EQ(4, cv::getNumThreads());
+
+    cv::parallel::setParallelForBackend("");
+    cv::setNumThreads(prevNumThreads);
+}
+
+TEST(Core_Parallel, affinity_parse_cpu_list)
+{
+    std::vector<int> cpus = cv::details::parseCPUList("0-3,8,10-11", 64);
+    const int expected[] = {0, 1, 2, 3, 8, 10, 11};
+    EXPECT_EQ(std::vector<int>(expected, expected + 7), cpus);
+    EXPECT_EQ(std::vector<int>(1, 5), cv::details::parseCPUList("5", 64));
+    EXPECT_TRUE(cv::details::parseCPUList("3-1", 64).empty());
+    EXPECT_TRUE(cv::details::parseCPUList("0,x", 64).empty());
+    EXPECT_TRUE(cv::details::parseCPUList("0-64", 64).empty());
+}
+
+TEST(Core_Parallel, affinity_static_partition)
+{
+    const int task_counts[] = {1, 3, 7, 64, 1000};
+    for (unsigned num_threads = 1; num_threads <= 9; num_threads++)
+    {
+        const unsigned num_blocks = cv::details::getStaticBlockCount(num_threads);
+        EXPECT_EQ(std::max(1u, num_threads - 1), num_blocks);  // caller owns no block
+        for (size_t k = 0; k < sizeof(task_counts)/sizeof(task_counts[0]); k++)
+        {
+            const int task_count = task_counts[k];
+            int prev_end = 0;
+            for (unsigned i = 0; i < num_blocks; i++)
+            {
+                int begin = -1, end = -1;
+                cv::details::getStaticBlockRange(task_count, num_blocks, i, begin, end);
+                EXPECT_EQ(prev_end, begin);
+                EXPECT_LE(begin, end);
+                EXPECT_LE(end - begin, task_count / (int)num_blocks + 1);
+                EXPECT_GE(end - begin, task_count / (int)num_blocks);
+                prev_end = end;
+            }
+            EXPECT_EQ(task_count, prev_end);
+        }
+        // each thread visits all blocks, workers start from their own block
+        for (unsigned slot = 0; slot < num_threads; slot++)
+        {
+            std::vector<int> visited(num_blocks, 0);
+            for (unsigned b = 0; b < num_blocks; b++)
+            {
+                unsigned block = cv::details::getStaticBlockVisitOrder(slot, num_blocks, b);
+                ASSERT_LT(block, num_blocks);
+                visited[block]++;
+            }
+            EXPECT_EQ(std::vector<int>(num_blocks, 1), visited);
+            if (slot > 0)
+            {
+                EXPECT_EQ(slot - 1, cv::details::getStaticBlockVisitOrder(slot, num_blocks, 0));
+            }
+        }
+    }
+}
+
+TEST(Core_Parallel, affinity_placement)
+{
+    // NUMA: contiguous groups of workers per node, all nodes are used
+    for (unsigned num_threads = 2; num_threads <= 17; num_threads++)
+    {
+        for (size_t num_nodes = 2; num_nodes <= 4; num_nodes++)
+        {
+            size_t prev = 0;
+            std::set<size_t> used;
+            for (unsigned slot = 1; slot < num_threads; slot++)
+            {
+                size_t node = cv::details::getAffinitySetIndex(slot, num_threads, num_nodes, true);
+                ASSERT_LT(node, num_nodes);
+                EXPECT_GE(node, prev);
+                prev = node;
+                used.insert(node);
+            }
+            EXPECT_EQ(std::min((size_t)(num_threads - 1), num_nodes), used.size());
+        }
+    }
+    // CPU list: round-robin starting from the first CPU
+    for (unsigned slot = 1; slot < 8; slot++)
+        EXPECT_EQ((size_t)(slot - 1) % 3, cv::details::getAffinitySetIndex(slot, 8, 3, false));
+}
+
+#if defined(__linux__)
+// OPENCV_THREAD_POOL_AFFINITY=<CPU list> should be set to run this test
+TEST(Core_Parallel, affinity_binding)
+{
+    const std::string mode = cv::utils::getConfigurationParameterString("OPENCV_THREAD_POOL_AFFINITY", "");
+    if (mode.empty() || mode == "none" || mode == "numa" || std::string(cv::currentParallelFramework()) != "pthreads")
+        throw SkipTestException("OPENCV_THREAD_POOL_AFFINITY=<CPU list> with pthreads backend is required");
+    const std::vector<int> cpus = cv::details::parseCPUList(mode, CPU_SETSIZE);
+    ASSERT_FALSE(cpus.empty());
+
+    cpu_set_t caller_mask;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(caller_mask), &caller_mask));
+    const std::thread::id caller = std::this_thread::get_id();
+    std::mutex mutex;
+    int unbound_workers = 0, caller_changes = 0;
+    for (int iter = 0; iter < 3; iter++)
+    {
+        parallel_for_(cv::Range(0, 256), [&](const cv::Range&)
+        {
+            cpu_set_t mask;
+            CV_Assert(sched_getaffinity(0, sizeof(mask), &mask) == 0);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (std::this_thread::get_id() == caller)
+                caller_changes += CPU_EQUAL(&mask, &caller_mask) ? 0 : 1;
+            else
+            {
+                // workers are pinned to a single CPU of the list
+                bool listed = false;
+                for (size_t i = 0; i < cpus.size(); i++)
+                    listed |= CPU_ISSET(cpus[i], &mask) != 0;
+                unbound_workers += (CPU_COUNT(&mask) == 1 && listed) ? 0 : 1;
+            }
+        });
+    }
+    EXPECT_EQ(0, unbound_workers);
+    EXPECT_EQ(0, caller_changes);  // application thread is not bound
+}
+#endif
+
 TEST(Core_Version, consistency)
 {
     // this test verifies that OpenCV version loaded in runtime
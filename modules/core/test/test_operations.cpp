@@ -1620,4 +1620,109 @@ INSTANTIATE_TEST_CASE_P(/* */, Core_Arith_Regression24163,
     )
 );
 
+typedef testing::TestWithParam<perf::MatType> Core_MatExpr_Fused;
+
+TEST_P(Core_MatExpr_Fused, elementwise_chains)
+{
+    const int type = GetParam();
+    const double eps = CV_MAT_DEPTH(type) == CV_32F ? 1e-4 : 1e-10;
+    Mat big_a(256, 300, type), big_b(256, 300, type), big_c(256, 300, type);
+    theRNG().fill(big_a, RNG::UNIFORM, 0.5, 2);
+    theRNG().fill(big_b, RNG::UNIFORM, 0.5, 2);
+    theRNG().fill(big_c, RNG::UNIFORM, 0.5, 2);
+
+    for (int roi = 0; roi < 2; roi++)
+    {
+        Rect r = roi ? Rect(3, 5, 251, 200) : Rect(0, 0, 300, 256);
+        Mat a = big_a(r), b = big_b(r), c = big_c(r);
+        Mat t1, t2, expected;
+
+        // (a + b) * 0.5 - c
+        Mat res = (a + b)*0.5 - c;
+        cv::addWeighted(a, 0.5, b, 0.5, 0, t1);
+        cv::subtract(t1, c, expected);
+        EXPECT_LE(cvtest::norm(res, expected, NORM_INF), eps);
+
+        // a.mul(b) + c*2 + 1
+        res = a.mul(b) + c*2 + 1;
+        cv::multiply(a, b, t1);
+        cv::addWeighted(t1, 1, c, 2, 1, expected);
+        EXPECT_LE(cvtest::norm(res, expected, NORM_INF), eps);
+
+        // 3 / (abs(a - b) + 1)
+        res = 3 / (abs(a - b) + 1);
+        cv::absdiff(a, b, t1);
+        cv::add(t1, Scalar::all(1), t1);
+        cv::divide(3, t1, expected);
+        EXPECT_LE(cvtest::norm(res, expected, NORM_INF), eps);
+
+        // min(a, b) / (c * 2 - a)
+        res = min(a, b) / (c*2 - a);
+        cv::min(a, b, t1);
+        cv::addWeighted(c, 2, a, -1, 0, t2);
+        cv::divide(t1, t2, expected);
+        EXPECT_LE(cvtest::norm(res, expected, NORM_INF), eps * 100);
+
+        // mask of fused expression
+        Mat mask = abs(a - b) * 2 > 0.5;
+        cv::absdiff(a, b, t1);
+        t1.convertTo(t1, -1, 2);
+        cv::compare(t1, 0.5, expected, CMP_GT);
+        ASSERT_EQ(expected.type(), mask.type());
+        // scaling by 2 and a + b*2 are exact up to the final rounding, so masks match exactly
+        EXPECT_EQ(0, cvtest::norm(mask, expected, NORM_INF));
+        mask = 1.5 <= a + b*2;
+        cv::addWeighted(a, 1, b, 2, 0, t1);
+        cv::compare(t1, 1.5, expected, CMP_GE);
+        EXPECT_EQ(0, cvtest::norm(mask, expected, NORM_INF));
+
+        // conversion of the result and in-place evaluation
+        if (a.channels() == 1)
+        {
+            Mat_<double> res64 = a.mul(b) - c;
+            cv::multiply(a, b, t1);
+            cv::subtract(t1, c, expected);
+            expected.convertTo(t2, CV_64F);
+            EXPECT_LE(cvtest::norm(res64, t2, NORM_INF), eps);
+        }
+
+        Mat inplace = a.clone();
+        inplace = (inplace + b).mul(c) - inplace;
+        cv::add(a, b, t1);
+        cv::multiply(t1, c, t1);
+        cv::subtract(t1, a, expected);
+        EXPECT_LE(cvtest::norm(inplace, expected, NORM_INF), eps);
+
+        // ROI of lazy expression
+        Mat sub = ((a + b).mul(c))(Rect(1, 2, 30, 40));
+        cv::add(a, b, t1);
+        cv::multiply(t1, c, expected);
+        EXPECT_LE(cvtest::norm(sub, expected(Rect(1, 2, 30, 40)), NORM_INF), eps);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_MatExpr_Fused, testing::Values(CV_32FC1, CV_32FC3, CV_64FC1, CV_64FC2));
+
+TEST(Core_MatExpr, fused_integer_saturation)
+{
+    // integer expressions are evaluated step by step with saturation of intermediate results
+    Mat a(4, 4, CV_8UC1, Scalar(200)), b(4, 4, CV_8UC1, Scalar(100));
+    Mat res = (a + b) - b;
+    EXPECT_EQ(155, res.at<uchar>(0, 0));
+}
+
+TEST(Core_MatExpr, fused_mul_scalar)
+{
+    // A.mul(Scalar) keeps the scalar as a small matrix operand, it must not be fused
+    Mat a(88, 140, CV_32FC1), b(88, 140, CV_32FC1);
+    randu(a, 1, 2);
+    randu(b, 1, 2);
+    Scalar s(0.5, 0.5, 0.5, 0.5);
+    Mat res = a.mul(s).mul(a*3 - 2*b);
+    Mat ref, c = a*3 - 2*b;
+    cv::multiply(a, s, ref);
+    cv::multiply(ref, c, ref);
+    EXPECT_LE(cvtest::norm(res, ref, NORM_INF), 1e-5);
+}
+
 }} // namespace
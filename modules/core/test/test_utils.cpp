@@ -10,6 +10,8 @@
 
 #include "opencv2/core/utils/filesystem.private.hpp"
 
+#include "../src/utils/trace_chrome.hpp"
+
 #ifndef OPENCV_DISABLE_THREAD_SUPPORT
 #include "test_utils_tls.impl.hpp"
 #endif
@@ -495,4 +497,98 @@ TEST_P(BufferArea, bad)
 INSTANTIATE_TEST_CASE_P(/**/, BufferArea, testing::Values(true, false));
 
 
+TEST(Core_Trace, chrome_trace_format)
+{
+    using namespace cv::utils::trace::details;
+    const std::string fname = cv::tempfile(".json");
+    {
+        cv::Ptr<ChromeTraceFile> file = cv::makePtr<ChromeTraceFile>(fname);
+        // small buffers are flushed several times
+        ChromeTraceEventBuffer t1(file, 1, 16), t2(file, 2, 16);
+        for (int i = 0; i < 20; i++)
+        {
+            const long long ts = 1000000 + i * 10000;
+            t1.regionEnter(2 * i, ts, "outer \"region\"", true);
+            t1.regionEnter(2 * i + 1, ts + 1500, "inner", false);
+            t2.regionEnter(1000 + i, ts + 2001, "parallel_for_body", false);
+            EXPECT_TRUE(t1.regionArg(2 * i + 1, "range", "\"0-10\""));
+            EXPECT_TRUE(t1.regionArg(2 * i, "index", cv::format("%d", i)));
+            EXPECT_FALSE(t1.regionArg(-1, "unknown", "0"));
+            t1.regionLeave(2 * i + 1, ts + 3000, 0);
+            t2.regionLeave(1000 + i, ts + 4000, 0);
+            t1.regionLeave(2 * i, ts + 5000, i == 5 ? 7 : 0);
+        }
+    }
+
+    FileStorage fs(fname, FileStorage::READ);
+    ASSERT_TRUE(fs.isOpened());
+    EXPECT_EQ("ns", (std::string)fs["displayTimeUnit"]);
+    FileNode events = fs["traceEvents"];
+    ASSERT_TRUE(events.isSeq());
+    EXPECT_EQ((size_t)(2 + 20 * 6), events.size());
+
+    std::map<int, std::vector<std::string> > stacks;
+    std::map<int, double> last_ts;
+    std::set<int> named_threads;
+    int begin_events = 0, end_events = 0, outer_args = 0, skipped = 0;
+    for (FileNodeIterator it = events.begin(); it != events.end(); ++it)
+    {
+        FileNode e = *it;
+        ASSERT_TRUE(e.isMap());
+        const std::string ph = (std::string)e["ph"];
+        EXPECT_EQ(1, (int)e["pid"]);
+        ASSERT_TRUE(e["tid"].isInt());
+        const int tid = (int)e["tid"];
+        if (ph == "M")
+        {
+            EXPECT_EQ("thread_name", (std::string)e["name"]);
+            EXPECT_EQ(cv::format("OpenCVThread-%03d", tid), (std::string)e["args"]["name"]);
+            named_threads.insert(tid);
+            continue;
+        }
+        ASSERT_TRUE(e["ts"].isReal() || e["ts"].isInt()) << ph;
+        const double ts = (double)e["ts"];  // microseconds
+        EXPECT_GE(ts, last_ts[tid]);
+        last_ts[tid] = ts;
+        std::vector<std::string>& stack = stacks[tid];
+        if (ph == "B")
+        {
+            begin_events++;
+            const std::string name = (std::string)e["name"];
+            const std::string cat = (std::string)e["cat"];
+            EXPECT_EQ(name == "outer \"region\"" ? "app" : "opencv", cat) << name;
+            stack.push_back(name);
+        }
+        else
+        {
+            ASSERT_EQ("E", ph);
+            end_events++;
+            ASSERT_FALSE(stack.empty());
+            const std::string name = stack.back();
+            stack.pop_back();
+            if (name == "inner")
+                EXPECT_EQ("0-10", (std::string)e["args"]["range"]);
+            else if (name == "outer \"region\"")
+            {
+                outer_args += e["args"]["index"].isInt() ? 1 : 0;
+                if (!e["args"]["skipped"].empty())
+                    skipped += (int)e["args"]["skipped"];
+            }
+            else
+                EXPECT_TRUE(e["args"].empty());
+        }
+    }
+    EXPECT_EQ(2u, named_threads.size());
+    EXPECT_EQ(60, begin_events);
+    EXPECT_EQ(60, end_events);
+    EXPECT_EQ(20, outer_args);
+    EXPECT_EQ(7, skipped);
+    EXPECT_TRUE(stacks[1].empty());
+    EXPECT_TRUE(stacks[2].empty());
+    EXPECT_DOUBLE_EQ(1000.0 + 19 * 10.0 + 5.0, last_ts[1]);
+    fs.release();
+    EXPECT_EQ(0, remove(fname.c_str()));
+}
+
+
 }} // namespace
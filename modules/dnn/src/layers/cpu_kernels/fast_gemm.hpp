@@ -17,32 +17,17 @@
 
 namespace cv { namespace dnn {
 
+// Kernels are selected by cv::hal::fastGemm* at runtime, the options only control threading
 struct FastGemmOpt {
-    bool use_avx;
-    bool use_avx2;
-    bool use_neon;
-    bool use_lasx;
     bool multi_thread;
 
     FastGemmOpt() {
-        use_avx = false;
-        use_avx2 = false;
-        use_neon = false;
-        use_lasx = false;
         multi_thread = false;
     }
 
     void init() {
-        use_avx = checkHardwareSupport(CPU_AVX);
-        use_avx2 = checkHardwareSupport(CPU_AVX2);
-        use_neon = checkHardwareSupport(CPU_NEON);
-        use_lasx = checkHardwareSupport(CPU_LASX);
         multi_thread = true;
     }
-
-    bool all() {
-        return use_avx || use_avx2 || use_neon || use_lasx;
-    }
 };
 
 struct MatMulHelper {
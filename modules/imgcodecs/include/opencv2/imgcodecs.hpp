@@ -92,9 +92,11 @@ enum ImwriteFlags {
        IMWRITE_JPEG_LUMA_QUALITY   = 5,  //!< Separate luma quality level, 0 - 100, default is -1 - don't use. If JPEG_LIB_VERSION < 70, Not supported.
        IMWRITE_JPEG_CHROMA_QUALITY = 6,  //!< Separate chroma quality level, 0 - 100, default is -1 - don't use. If JPEG_LIB_VERSION < 70, Not supported.
        IMWRITE_JPEG_SAMPLING_FACTOR = 7, //!< For JPEG, set sampling factor. See cv::ImwriteJPEGSamplingFactorParams.
+       IMWRITE_JPEG_THREADS        = 8,  //!< For JPEG, the number of horizontal bands encoded in parallel and joined into one baseline stream with restart markers between them (the restart interval is one band, IMWRITE_JPEG_RST_INTERVAL is ignored). 0 or 1 - single-threaded (default), negative - cv::getNumThreads(). Not used with IMWRITE_JPEG_PROGRESSIVE or IMWRITE_JPEG_OPTIMIZE.
        IMWRITE_PNG_COMPRESSION     = 16, //!< For PNG, it can be the compression level from 0 to 9. A higher value means a smaller size and longer compression time. If specified, strategy is changed to IMWRITE_PNG_STRATEGY_DEFAULT (Z_DEFAULT_STRATEGY). Default value is 1 (best speed setting).
        IMWRITE_PNG_STRATEGY        = 17, //!< One of cv::ImwritePNGFlags, default is IMWRITE_PNG_STRATEGY_RLE.
        IMWRITE_PNG_BILEVEL         = 18, //!< Binary level PNG, 0 or 1, default is 0.
+       IMWRITE_PNG_THREADS         = 19, //!< For PNG, the number of row segments filtered and deflated in parallel and joined into one zlib stream. 0 or 1 - single-threaded (default), negative - cv::getNumThreads(). Not used with IMWRITE_PNG_BILEVEL.
        IMWRITE_PXM_BINARY          = 32, //!< For PPM, PGM, or PBM, it can be a binary format flag, 0 or 1. Default value is 1.
        IMWRITE_EXR_TYPE            = (3 << 4) + 0 /* 48 */, //!< override EXR storage type (FLOAT (FP32) is default)
        IMWRITE_EXR_COMPRESSION     = (3 << 4) + 1 /* 49 */, //!< override EXR compression type (ZIP_COMPRESSION = 3 is default)
@@ -335,6 +337,41 @@ The image passing through the img parameter can be pre-allocated. The memory is
  */
 CV_EXPORTS_W void imread( const String& filename, OutputArray dst, int flags = IMREAD_COLOR_BGR );
 
+/** @brief Loads several images from files in parallel.
+
+The function imreadBatch decodes the files on the threads of the OpenCV parallel backend. Each thread
+reuses its decoder instances between the files it processes and between the calls, where the codec
+supports it (JPEG, PNG and WebP).
+@param filenames Names of the files to be loaded.
+@param mats Vector of the loaded images, resized to the number of files. The non-empty elements are
+used as preallocated outputs: their memory is reused if the size and the type match the loaded image,
+otherwise they are reallocated. The elements corresponding to the files that cannot be read are released.
+@param flags Flag that can take values of cv::ImreadModes
+@return The number of successfully loaded images.
+@sa cv::imread, cv::imdecodeBatch
+ */
+CV_EXPORTS_W int imreadBatch( const std::vector<String>& filenames, CV_IN_OUT std::vector<Mat>& mats, int flags = IMREAD_COLOR_BGR );
+
+/** @brief Loads a region of an image from a file, optionally reduced in size.
+
+The function is equivalent to cropping the result of cv::imread and resizing it to dsize, but the
+codecs that support it do only the work needed for the requested output:
+-   JPEG skips the rows and the columns outside of the region and uses DCT-domain downscaling by
+    1/2, 1/4 or 1/8 when the target size allows it.
+-   WebP decodes only the region and scales it in the decoder.
+-   TIFF decodes only the tiles or the strips intersecting the region, several of them in parallel, and
+    reads the smallest reduced-resolution level (SubIFD) of a pyramidal image that is not smaller than dsize.
+
+The remaining reduction, if any, is done with cv::resize. Other formats are decoded completely.
+@param filename Name of the file to be loaded.
+@param roi Region of the image as stored in the file, i.e. before the EXIF orientation is applied.
+An empty rectangle selects the whole image.
+@param dsize Size of the output image. An empty size keeps the size of the region.
+@param flags Flag that can take values of cv::ImreadModes. IMREAD_REDUCED_* flags are ignored, use dsize instead.
+@sa cv::imread, cv::imdecodeRegion
+ */
+CV_EXPORTS_W Mat imreadRegion( const String& filename, const Rect& roi, const Size& dsize = Size(), int flags = IMREAD_COLOR_BGR );
+
 /** @brief Loads a multi-page image from a file.
 
 The function imreadmulti loads a multi-page image from the specified file into a vector of Mat objects.
@@ -475,6 +512,45 @@ failure the function returns empty cv::Mat object, but does not release user-pro
 */
 CV_EXPORTS Mat imdecode( InputArray buf, int flags, Mat* dst);
 
+/** @overload
+@param buf Input array or vector of bytes.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@param dst The decoded image. If it is not empty, it must have the size and the type of the decoded
+image (after the IMREAD_REDUCED_* reduction and the EXIF orientation are applied), otherwise the
+function logs an error and returns false. The image is written into its memory: dst is never
+reallocated, so it can wrap user-owned memory, e.g. pinned or shared buffers. Continuous matrices are
+decoded into directly; strided views and rotated images receive the result with one extra copy.
+@return true if the image has been decoded. In case of failure the content of a preallocated dst is undefined.
+*/
+CV_EXPORTS_AS(imdecodeInto) bool imdecode( InputArray buf, int flags, InputOutputArray dst );
+
+/** @brief Reads several images from buffers in memory in parallel.
+
+The function imdecodeBatch is the batch counterpart of cv::imdecode: the buffers are decoded on the
+threads of the OpenCV parallel backend and each thread reuses its decoder instances between the
+buffers and between the calls, where the codec supports it.
+@param bufs Vector of the encoded images, each one is an input array or vector of bytes.
+@param mats Vector of the decoded images, resized to the number of buffers. The non-empty elements are
+used as preallocated outputs: their memory is reused if the size and the type match the decoded image,
+otherwise they are reallocated. The elements corresponding to the buffers that cannot be decoded are released.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@return The number of successfully decoded images.
+@sa cv::imdecode, cv::imreadBatch
+*/
+CV_EXPORTS_W int imdecodeBatch( InputArrayOfArrays bufs, CV_IN_OUT std::vector<Mat>& mats, int flags = IMREAD_COLOR_BGR );
+
+/** @brief Reads a region of an image from a buffer in memory, optionally reduced in size.
+
+The function is the in-memory counterpart of cv::imreadRegion.
+@param buf Input array or vector of bytes.
+@param roi Region of the image as stored in the buffer, i.e. before the EXIF orientation is applied.
+An empty rectangle selects the whole image.
+@param dsize Size of the output image. An empty size keeps the size of the region.
+@param flags The same flags as in cv::imread, see cv::ImreadModes. IMREAD_REDUCED_* flags are ignored.
+@sa cv::imdecode, cv::imreadRegion
+*/
+CV_EXPORTS_W Mat imdecodeRegion( InputArray buf, const Rect& roi, const Size& dsize = Size(), int flags = IMREAD_COLOR_BGR );
+
 /** @brief Reads a multi-page image from a buffer in memory.
 
 The function imdecodemulti reads a multi-page image from the specified buffer in the memory. If the buffer is too short or
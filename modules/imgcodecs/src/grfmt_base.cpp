@@ -97,6 +97,24 @@ int BaseImageDecoder::setScale( const int& scale_denom )
     return temp;
 }
 
+void BaseImageDecoder::resetBaseState()
+{
+    m_width = m_height = 0;
+    m_type = -1;
+    m_scale_denom = 1;
+    m_filename = String();
+    m_buf.release();
+    m_use_rgb = false;
+    m_exif = ExifReader();
+    m_frame_count = 1;
+    m_animation = Animation();
+}
+
+bool BaseImageDecoder::setDecodeRegion( const Rect&, Size& )
+{
+    return false;
+}
+
 void BaseImageDecoder::setRGB(bool useRGB)
 {
     m_use_rgb = useRGB;
@@ -92,6 +92,17 @@ public:
      */
     virtual int setScale(const int& scale_denom);
 
+    /**
+     * @brief Restrict decoding to a region of the image, optionally reduced in size.
+     * Must be called after readHeader(). On success width() and height() return the size that readData()
+     * will produce, and readData() decodes only the data needed for the region.
+     * @param roi The region in the coordinates of the image described by the header.
+     * @param size On input, the requested size of the decoded region. On output, the size readData() will
+     * produce: not smaller than the requested size and not larger than the region.
+     * @return true if the decoder supports region decoding, false otherwise (the whole image is decoded then).
+     */
+    virtual bool setDecodeRegion(const Rect& roi, Size& size);
+
     /**
      * @brief Read the image header to extract basic properties (width, height, type).
      * This is a pure virtual function that must be implemented by derived classes.
@@ -141,7 +152,21 @@ public:
      */
     virtual ImageDecoder newDecoder() const;
 
+    /**
+     * @brief Return the decoder to its initial state so that the instance can be used for another source.
+     * The default implementation does nothing and returns false, i.e. a new instance has to be
+     * created with newDecoder().
+     * @return true if the decoder has been reset, false otherwise.
+     */
+    virtual bool reset() { return false; }
+
 protected:
+    /**
+     * @brief Restore the members of the base class to their initial values, a helper for reset().
+     * The signature and the buffer support flag of the decoder are kept.
+     */
+    void resetBaseState();
+
     int m_width;          ///< Width of the image (set by readHeader).
     int m_height;         ///< Height of the image (set by readHeader).
     int m_type;           ///< Image type (e.g., color depth, channel order).
@@ -210,6 +210,7 @@ void  JpegDecoder::close()
 
     m_width = m_height = 0;
     m_type = -1;
+    m_roi = Rect();
 }
 
 ImageDecoder JpegDecoder::newDecoder() const
@@ -217,6 +218,14 @@ ImageDecoder JpegDecoder::newDecoder() const
     return makePtr<JpegDecoder>();
 }
 
+bool JpegDecoder::reset()
+{
+    close();
+    resetBaseState();
+    m_roi = Rect();
+    return true;
+}
+
 bool  JpegDecoder::readHeader()
 {
     volatile bool result = false;
@@ -263,6 +272,40 @@ bool  JpegDecoder::readHeader()
     return result;
 }
 
+bool JpegDecoder::setDecodeRegion( const Rect& roi, Size& size )
+{
+    if( !m_state || !m_width || !m_height )
+        return false;
+
+    CV_Assert( 0 <= roi.x && 0 < roi.width && roi.x + roi.width <= m_width &&
+               0 <= roi.y && 0 < roi.height && roi.y + roi.height <= m_height );
+
+    jpeg_decompress_struct* cinfo = &((JpegState*)m_state)->cinfo;
+    JpegErrorMgr* jerr = &((JpegState*)m_state)->jerr;
+
+    // the strongest DCT scaling that keeps the region not smaller than the requested size
+    const int scale0 = (int)cinfo->scale_denom;
+    int denom = 1;
+    while( scale0*denom < 8 && roi.width/(denom*2) >= size.width && roi.height/(denom*2) >= size.height )
+        denom *= 2;
+
+    if( setjmp( jerr->setjmp_buffer ) != 0 )
+        return false;
+
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = scale0*denom;
+    jpeg_calc_output_dimensions( cinfo );
+
+    int x0 = roi.x/denom, y0 = roi.y/denom;
+    int x1 = std::min((int)divUp(roi.x + roi.width, denom), (int)cinfo->output_width);
+    int y1 = std::min((int)divUp(roi.y + roi.height, denom), (int)cinfo->output_height);
+    m_roi = Rect(x0, y0, x1 - x0, y1 - y0);
+    m_width = m_roi.width;
+    m_height = m_roi.height;
+    size = m_roi.size();
+    return true;
+}
+
 #ifdef CV_MANUAL_JPEG_STD_HUFF_TABLES
 /***************************************************************************
  * following code is for supporting MJPEG image files
@@ -494,7 +537,27 @@ bool  JpegDecoder::readData( Mat& img )
 
             jpeg_start_decompress( cinfo );
 
-            if( doDirectRead)
+            // number of leading pixels of every decompressed row that lie outside of the decoded region
+            int xskip = 0;
+            JSAMPARRAY buffer = 0;
+
+            if( !m_roi.empty() )
+            {
+#ifdef LIBJPEG_TURBO_VERSION_NUMBER
+                JDIMENSION xoffset = (JDIMENSION)m_roi.x, width = (JDIMENSION)m_roi.width;
+                jpeg_crop_scanline( cinfo, &xoffset, &width );
+                xskip = m_roi.x - (int)xoffset;
+                if( jpeg_skip_scanlines( cinfo, (JDIMENSION)m_roi.y ) != (JDIMENSION)m_roi.y ) return false;
+#else
+                xskip = m_roi.x;
+                buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
+                                                      JPOOL_IMAGE, cinfo->output_width*4, 1 );
+                for( int iy = 0; iy < m_roi.y; iy++ )
+                    if (jpeg_read_scanlines( cinfo, buffer, 1 ) != 1) return false;
+#endif
+            }
+
+            if( doDirectRead && xskip == 0 && (int)cinfo->output_width == m_width )
             {
                 for( int iy = 0 ; iy < m_height; iy ++ )
                 {
@@ -504,43 +567,51 @@ bool  JpegDecoder::readData( Mat& img )
             }
             else
             {
-                JSAMPARRAY buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
-                                                                 JPOOL_IMAGE, m_width*4, 1 );
+                if( !buffer )
+                    buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
+                                                          JPOOL_IMAGE, cinfo->output_width*4, 1 );
+                const uchar* src = buffer[0] + xskip*cinfo->out_color_components;
 
                 for( int iy = 0 ; iy < m_height; iy ++ )
                 {
                     uchar* data = img.ptr<uchar>(iy);
                     if (jpeg_read_scanlines( cinfo, buffer, 1 ) != 1) return false;
 
-                    if( color )
+                    if( doDirectRead )
+                        memcpy( data, src, m_width*cinfo->out_color_components );
+                    else if( color )
                     {
                         if (m_use_rgb)
                         {
                             if( cinfo->out_color_components == 3 )
-                                icvCvt_BGR2RGB_8u_C3R( buffer[0], 0, data, 0, Size(m_width,1) );
+                                icvCvt_BGR2RGB_8u_C3R( src, 0, data, 0, Size(m_width,1) );
                             else
-                                icvCvt_CMYK2RGB_8u_C4C3R( buffer[0], 0, data, 0, Size(m_width,1) );
+                                icvCvt_CMYK2RGB_8u_C4C3R( src, 0, data, 0, Size(m_width,1) );
                         }
                         else
                         {
                             if( cinfo->out_color_components == 3 )
-                                icvCvt_RGB2BGR_8u_C3R( buffer[0], 0, data, 0, Size(m_width,1) );
+                                icvCvt_RGB2BGR_8u_C3R( src, 0, data, 0, Size(m_width,1) );
                             else
-                                icvCvt_CMYK2BGR_8u_C4C3R( buffer[0], 0, data, 0, Size(m_width,1) );
+                                icvCvt_CMYK2BGR_8u_C4C3R( src, 0, data, 0, Size(m_width,1) );
                         }
                     }
                     else
                     {
                         if( cinfo->out_color_components == 1 )
-                            memcpy( data, buffer[0], m_width );
+                            memcpy( data, src, m_width );
                         else
-                            icvCvt_CMYK2Gray_8u_C4C1R( buffer[0], 0, data, 0, Size(m_width,1) );
+                            icvCvt_CMYK2Gray_8u_C4C1R( src, 0, data, 0, Size(m_width,1) );
                     }
                 }
             }
 
             result = true;
-            jpeg_finish_decompress( cinfo );
+            // the rows below the decoded region are not decompressed at all
+            if( cinfo->output_scanline < cinfo->output_height )
+                jpeg_abort_decompress( cinfo );
+            else
+                jpeg_finish_decompress( cinfo );
         }
     }
 
@@ -612,10 +683,148 @@ ImageEncoder JpegEncoder::newEncoder() const
     return makePtr<JpegEncoder>();
 }
 
+// Locates the SOF and the SOS segments of a sequential JPEG stream; the entropy-coded data starts
+// right after the SOS segment
+static bool jpegFindScan( const std::vector<uchar>& stream, size_t& sof, size_t& sos, size_t& data )
+{
+    if( stream.size() < 4 || stream[0] != 0xFF || stream[1] != 0xD8 )
+        return false;
+    sof = 0;
+    for( size_t pos = 2; pos + 4 <= stream.size(); )
+    {
+        if( stream[pos] != 0xFF )
+            return false;
+        int marker = stream[pos + 1];
+        size_t length = ((size_t)stream[pos + 2] << 8) | stream[pos + 3];
+        if( marker == 0xC0 || marker == 0xC1 )
+            sof = pos;
+        if( marker == 0xDA )
+        {
+            sos = pos;
+            data = pos + 2 + length;
+            return sof != 0 && data + 2 <= stream.size();
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+/*
+ * Encodes the horizontal bands of band_rows rows independently and joins them into one stream.
+ * The band height is a multiple of the MCU height, so the bands have the same coefficients as
+ * the corresponding part of the whole image. The restart interval is set to the number of MCUs
+ * in a band: the predictors are reset at the band boundaries, where the RSTn markers are inserted.
+ */
+bool JpegEncoder::writeBands( const Mat& img, const std::vector<int>& params, int band_rows )
+{
+    std::vector<int> band_params;
+    for( size_t i = 0; i + 1 < params.size(); i += 2 )
+    {
+        if( params[i] != IMWRITE_JPEG_THREADS && params[i] != IMWRITE_JPEG_RST_INTERVAL )
+        {
+            band_params.push_back(params[i]);
+            band_params.push_back(params[i+1]);
+        }
+    }
+
+    const int nbands = divUp(img.rows, band_rows);
+    std::vector<std::vector<uchar> > streams(nbands);
+    std::vector<String> errors(nbands);
+    parallel_for_(Range(0, nbands), [&](const Range& range)
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            JpegEncoder encoder;
+            encoder.setDestination(streams[i]);
+            if( !encoder.write(img.rowRange(i*band_rows, std::min((i + 1)*band_rows, img.rows)), band_params) )
+                errors[i] = encoder.m_last_error.empty() ? String("can't encode a band") : encoder.m_last_error;
+        }
+    }, nbands);
+
+    std::vector<size_t> data(nbands);
+    size_t sof = 0, sos = 0, total = 0;
+    for( int i = 0; i < nbands; i++ )
+    {
+        if( !errors[i].empty() )
+        {
+            m_last_error = errors[i];
+            return false;
+        }
+        size_t band_sof = 0, band_sos = 0;
+        CV_Assert( jpegFindScan(streams[i], band_sof, band_sos, data[i]) );
+        if( i == 0 )
+        {
+            sof = band_sof;
+            sos = band_sos;
+        }
+        total += streams[i].size();
+    }
+
+    // the header of the first band describes the whole image
+    std::vector<uchar> header(streams[0].begin(), streams[0].begin() + data[0]);
+    CV_Assert( sof + 10 <= sos );
+    header[sof + 5] = (uchar)(img.rows >> 8);
+    header[sof + 6] = (uchar)img.rows;
+    int hmax = 1, vmax = 1;
+    for( int c = 0, ncomps = header[sof + 9]; c < ncomps; c++ )
+    {
+        hmax = std::max(hmax, header[sof + 11 + c*3] >> 4);
+        vmax = std::max(vmax, header[sof + 11 + c*3] & 15);
+    }
+    CV_Assert( band_rows % (vmax*8) == 0 );
+    const int interval = divUp(img.cols, hmax*8) * (band_rows / (vmax*8));
+    CV_Assert( 0 < interval && interval <= 65535 );
+    const uchar dri[] = { 0xFF, 0xDD, 0, 4, (uchar)(interval >> 8), (uchar)interval };
+    header.insert(header.begin() + sos, dri, dri + sizeof(dri));
+
+    std::vector<uchar> out;
+    out.reserve(total);
+    out.insert(out.end(), header.begin(), header.end());
+    for( int i = 0; i < nbands; i++ )
+    {
+        // the entropy-coded data of the band, without the EOI marker
+        out.insert(out.end(), streams[i].begin() + data[i], streams[i].end() - 2);
+        out.push_back(0xFF);
+        out.push_back(i + 1 < nbands ? (uchar)(0xD0 + (i & 7)) : (uchar)0xD9);
+    }
+
+    if( m_buf )
+    {
+        m_buf->insert(m_buf->end(), out.begin(), out.end());
+        return true;
+    }
+    FILE* f = fopen( m_filename.c_str(), "wb" );
+    if( !f )
+        return false;
+    bool result = fwrite( out.data(), 1, out.size(), f ) == out.size();
+    result = fclose( f ) == 0 && result;
+    return result;
+}
+
 bool JpegEncoder::write( const Mat& img, const std::vector<int>& params )
 {
     m_last_error.clear();
 
+    int threads = 0;
+    bool sequential = false;
+    for( size_t i = 0; i + 1 < params.size(); i += 2 )
+    {
+        if( params[i] == IMWRITE_JPEG_THREADS )
+            threads = params[i+1] < 0 ? getNumThreads() : params[i+1];
+        // the bands must consist of a single scan and share the Huffman tables
+        if( (params[i] == IMWRITE_JPEG_PROGRESSIVE || params[i] == IMWRITE_JPEG_OPTIMIZE) && params[i+1] != 0 )
+            sequential = true;
+    }
+    if( threads > 1 && !sequential )
+    {
+        // the band height is a multiple of 16 rows, the tallest MCU, and a band has at most
+        // 65535 MCUs (8x8 pixels at least) to fit into the restart interval
+        int max_band_rows = 65535 / divUp(img.cols, 8) * 8 / 16 * 16;
+        int band_rows = std::min((int)alignSize(divUp(img.rows, threads), 16), max_band_rows);
+        if( band_rows > 0 && band_rows < img.rows )
+            return writeBands(img, params, band_rows);
+    }
+
     struct fileWrapper
     {
         FILE* f;
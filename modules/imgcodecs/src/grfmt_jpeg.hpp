@@ -81,14 +81,17 @@ public:
 
     bool  readData( Mat& img ) CV_OVERRIDE;
     bool  readHeader() CV_OVERRIDE;
+    bool  setDecodeRegion( const Rect& roi, Size& size ) CV_OVERRIDE;
     void  close();
 
     ImageDecoder newDecoder() const CV_OVERRIDE;
+    bool  reset() CV_OVERRIDE;
 
 protected:
 
     FILE* m_f;
     void* m_state;
+    Rect  m_roi; // decoded region in the coordinates of the scaled image, empty for the whole image
 
 private:
     JpegDecoder(const JpegDecoder &); // copy disabled
@@ -104,6 +107,9 @@ public:
 
     bool  write( const Mat& img, const std::vector<int>& params ) CV_OVERRIDE;
     ImageEncoder newEncoder() const CV_OVERRIDE;
+
+protected:
+    bool  writeBands( const Mat& img, const std::vector<int>& params, int band_rows );
 };
 
 }
@@ -231,6 +231,33 @@ ImageDecoder PngDecoder::newDecoder() const
     return makePtr<PngDecoder>();
 }
 
+bool PngDecoder::reset()
+{
+    // the frame buffers of APNG are not reusable
+    if (m_frame_count > 1)
+        return false;
+
+    ClearPngPtr();
+    if( m_f )
+    {
+        fclose( m_f );
+        m_f = nullptr;
+    }
+    resetBaseState();
+    m_color_type = 0;
+    m_bit_depth = 0;
+    m_buf_pos = 0;
+    m_frame_no = 0;
+    m_chunkIHDR = Chunk();
+    m_chunksInfo.clear();
+    w0 = h0 = x0 = y0 = 0;
+    delay_num = delay_den = 0;
+    dop = bop = 0;
+    m_is_fcTL_loaded = false;
+    m_is_IDAT_loaded = false;
+    return true;
+}
+
 void  PngDecoder::readDataFromBuf( void* _png_ptr, unsigned char* dst, size_t size )
 {
     png_structp png_ptr = (png_structp)_png_ptr;
@@ -855,6 +882,20 @@ void PngEncoder::flushBuf(void*)
 
 bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
 {
+    int threads = 0;
+    bool isBilevelParam = false;
+    for( size_t i = 0; i + 1 < params.size(); i += 2 )
+    {
+        if( params[i] == IMWRITE_PNG_THREADS )
+            threads = params[i+1] < 0 ? getNumThreads() : params[i+1];
+        if( params[i] == IMWRITE_PNG_BILEVEL )
+            isBilevelParam = params[i+1] != 0;
+    }
+    if( threads > 1 && !isBilevelParam && img.rows > 1 &&
+        (img.depth() == CV_8U || img.depth() == CV_16U) &&
+        (img.channels() == 1 || img.channels() == 3 || img.channels() == 4) )
+        return writeParallel( img, params, threads );
+
     png_structp png_ptr = png_create_write_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
     png_infop info_ptr = 0;
     FILE * volatile f = 0;
@@ -958,6 +999,240 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
     return result;
 }
 
+// converts the row of the image to the PNG sample layout: RGB(A) order, big-endian 16-bit samples
+static void pngPackRow(const Mat& img, int y, uchar* dst)
+{
+    const int width = img.cols, channels = img.channels();
+    if (img.depth() == CV_8U)
+    {
+        const uchar* src = img.ptr<uchar>(y);
+        if (channels == 3)
+            icvCvt_BGR2RGB_8u_C3R(src, 0, dst, 0, Size(width, 1));
+        else if (channels == 4)
+            icvCvt_BGRA2RGBA_8u_C4R(src, 0, dst, 0, Size(width, 1));
+        else
+            memcpy(dst, src, width * channels);
+    }
+    else
+    {
+        const ushort* src = img.ptr<ushort>(y);
+        ushort* dst16 = (ushort*)dst;
+        if (channels == 3)
+            icvCvt_BGR2RGB_16u_C3R(src, 0, dst16, 0, Size(width, 1));
+        else if (channels == 4)
+            icvCvt_BGRA2RGBA_16u_C4R(src, 0, dst16, 0, Size(width, 1));
+        else
+            memcpy(dst16, src, width * channels * sizeof(ushort));
+        if (!isBigEndian())
+            for (int i = 0; i < width * channels; i++)
+                dst16[i] = (ushort)((dst16[i] >> 8) | (dst16[i] << 8));
+    }
+}
+
+// applies the PNG filter to the row, the filter type byte is stored first
+static void pngFilterRow(int filter, const uchar* row, const uchar* prev, int rowbytes, int bpp, uchar* out)
+{
+    int i;
+    *out++ = (uchar)filter;
+    switch (filter)
+    {
+    case PNG_FILTER_VALUE_NONE:
+        memcpy(out, row, rowbytes);
+        break;
+    case PNG_FILTER_VALUE_SUB:
+        for (i = 0; i < bpp; i++)
+            out[i] = row[i];
+        for (; i < rowbytes; i++)
+            out[i] = (uchar)(row[i] - row[i - bpp]);
+        break;
+    case PNG_FILTER_VALUE_UP:
+        for (i = 0; i < rowbytes; i++)
+            out[i] = (uchar)(row[i] - prev[i]);
+        break;
+    case PNG_FILTER_VALUE_AVG:
+        for (i = 0; i < bpp; i++)
+            out[i] = (uchar)(row[i] - prev[i] / 2);
+        for (; i < rowbytes; i++)
+            out[i] = (uchar)(row[i] - (prev[i] + row[i - bpp]) / 2);
+        break;
+    default: // PNG_FILTER_VALUE_PAETH
+        for (i = 0; i < bpp; i++)
+            out[i] = (uchar)(row[i] - prev[i]);
+        for (; i < rowbytes; i++)
+        {
+            int a = row[i - bpp], b = prev[i], c = prev[i - bpp];
+            int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+            out[i] = (uchar)(row[i] - (pa <= pb && pa <= pc ? a : pb <= pc ? b : c));
+        }
+        break;
+    }
+}
+
+// the libpng heuristic for the adaptive filtering: the sum of the absolute values of the filtered bytes
+static uint64_t pngFilterCost(const uchar* out, int rowbytes)
+{
+    uint64_t sum = 0;
+    for (int i = 1; i <= rowbytes; i++)
+        sum += out[i] < 128 ? out[i] : 256 - out[i];
+    return sum;
+}
+
+/*
+ * Writes the image with the rows filtered and deflated in parallel, the same way pigz does.
+ * The image is split into horizontal segments deflated into raw streams. Each segment is primed
+ * with the 32K of the filtered data preceding it, so the compression ratio stays close to that
+ * of a single stream, and terminated with a sync flush, which aligns it to a byte boundary.
+ * The concatenated segments form one zlib stream with the checksum combined from the segment ones.
+ */
+bool PngEncoder::writeParallel(const Mat& img, const std::vector<int>& params, int threads)
+{
+    int compression_level = -1;
+    int compression_strategy = IMWRITE_PNG_STRATEGY_RLE;
+    for (size_t i = 0; i + 1 < params.size(); i += 2)
+    {
+        if (params[i] == IMWRITE_PNG_COMPRESSION)
+        {
+            compression_strategy = IMWRITE_PNG_STRATEGY_DEFAULT;
+            compression_level = MIN(MAX(params[i+1], 0), Z_BEST_COMPRESSION);
+        }
+        if (params[i] == IMWRITE_PNG_STRATEGY)
+            compression_strategy = MIN(MAX(params[i+1], 0), Z_FIXED);
+    }
+    // the same filters as in write(): Sub for the speed-tuned default, adaptive with a compression level
+    const bool adaptive = compression_level >= 0;
+    const int level = adaptive ? compression_level : Z_BEST_SPEED;
+
+    const int width = img.cols, height = img.rows, channels = img.channels();
+    const int bpp = (int)img.elemSize();
+    const int rowbytes = width * bpp;
+    const size_t stride = (size_t)rowbytes + 1;
+    CV_CheckLT(stride * height, (size_t)1 << 31, "PNG: the image is too large for the parallel encoding");
+    std::vector<uchar> filtered(stride * height);
+
+    parallel_for_(Range(0, height), [&](const Range& range)
+    {
+        AutoBuffer<uchar> _buf(rowbytes * 3 + 1);
+        uchar* cur = _buf.data();
+        uchar* prev = cur + rowbytes;
+        uchar* candidate = prev + rowbytes;
+        if (range.start > 0)
+            pngPackRow(img, range.start - 1, prev);
+        else
+            memset(prev, 0, rowbytes);
+        for (int y = range.start; y < range.end; y++)
+        {
+            uchar* out = &filtered[stride * y];
+            pngPackRow(img, y, cur);
+            if (!adaptive)
+            {
+                pngFilterRow(PNG_FILTER_VALUE_SUB, cur, prev, rowbytes, bpp, out);
+            }
+            else
+            {
+                uint64_t best = std::numeric_limits<uint64_t>::max();
+                for (int filter = PNG_FILTER_VALUE_NONE; filter <= PNG_FILTER_VALUE_PAETH; filter++)
+                {
+                    pngFilterRow(filter, cur, prev, rowbytes, bpp, candidate);
+                    uint64_t cost = pngFilterCost(candidate, rowbytes);
+                    if (cost < best)
+                    {
+                        best = cost;
+                        memcpy(out, candidate, stride);
+                    }
+                }
+            }
+            std::swap(cur, prev);
+        }
+    }, threads);
+
+    const int nsegments = std::min(threads, height);
+    const int segment_rows = divUp(height, nsegments);
+    std::vector<std::vector<uchar> > segments(nsegments);
+    std::vector<uLong> checksums(nsegments);
+    std::vector<int> status(nsegments, Z_OK);
+    parallel_for_(Range(0, nsegments), [&](const Range& range)
+    {
+        for (int i = range.start; i < range.end; i++)
+        {
+            const size_t begin = stride * std::min(i * segment_rows, height);
+            const size_t end = stride * std::min((i + 1) * segment_rows, height);
+            const bool last = i == nsegments - 1;
+            z_stream strm;
+            memset(&strm, 0, sizeof(strm));
+            status[i] = deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, compression_strategy);
+            if (status[i] != Z_OK)
+                continue;
+            if (begin > 0)
+            {
+                const size_t dict = std::min(begin, (size_t)32768);
+                deflateSetDictionary(&strm, &filtered[begin - dict], (uInt)dict);
+            }
+            std::vector<uchar>& out = segments[i];
+            out.resize(deflateBound(&strm, (uLong)(end - begin)) + 16);
+            strm.next_in = &filtered[0] + begin;
+            strm.avail_in = (uInt)(end - begin);
+            strm.next_out = out.data();
+            strm.avail_out = (uInt)out.size();
+            status[i] = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+            if (status[i] == (last ? Z_STREAM_END : Z_OK) && strm.avail_in == 0)
+                status[i] = Z_OK;
+            else if (status[i] == Z_OK)
+                status[i] = Z_BUF_ERROR;
+            out.resize(strm.total_out);
+            deflateEnd(&strm);
+            checksums[i] = adler32(adler32(0L, Z_NULL, 0), &filtered[0] + begin, (uInt)(end - begin));
+        }
+    }, nsegments);
+
+    std::vector<uchar> zdata(2);
+    uLong checksum = checksums[0];
+    for (int i = 0; i < nsegments; i++)
+    {
+        if (status[i] != Z_OK)
+            return false;
+        zdata.insert(zdata.end(), segments[i].begin(), segments[i].end());
+        if (i > 0)
+        {
+            const size_t length = stride * (std::min((i + 1) * segment_rows, height) - std::min(i * segment_rows, height));
+            checksum = adler32_combine(checksum, checksums[i], (z_off_t)length);
+        }
+    }
+    // zlib header for the 32K window and the compression level, then the Adler-32 checksum
+    const int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    zdata[0] = 0x78;
+    zdata[1] = (uchar)(flevel << 6);
+    zdata[1] += (uchar)((31 - (zdata[0] * 256 + zdata[1]) % 31) % 31);
+    unsigned char buf[13];
+    png_save_uint_32(buf, (png_uint_32)checksum);
+    zdata.insert(zdata.end(), buf, buf + 4);
+
+    FILE* f = NULL;
+    if (!m_buf)
+    {
+        f = fopen(m_filename.c_str(), "wb");
+        if (!f)
+            return false;
+    }
+
+    const unsigned char signature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    writeToStreamOrBuffer(signature, sizeof(signature), f);
+    png_save_uint_32(buf, width);
+    png_save_uint_32(buf + 4, height);
+    buf[8] = img.depth() == CV_8U ? 8 : 16;
+    buf[9] = channels == 1 ? PNG_COLOR_TYPE_GRAY : channels == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGBA;
+    buf[10] = PNG_COMPRESSION_TYPE_BASE;
+    buf[11] = PNG_FILTER_TYPE_BASE;
+    buf[12] = PNG_INTERLACE_NONE;
+    writeChunk(f, "IHDR", buf, 13);
+    writeIDATs(f, 0, zdata.data(), (uint32_t)zdata.size(), (uint32_t)filtered.size());
+    writeChunk(f, "IEND", NULL, 0);
+
+    bool result = true;
+    if (f)
+        result = !ferror(f) && fclose(f) == 0;
+    return result;
+}
+
 size_t PngEncoder::writeToStreamOrBuffer(void const* buffer, size_t num_bytes, FILE* stream)
 {
     if (!buffer || !num_bytes)
@@ -129,6 +129,7 @@ public:
     bool  nextPage() CV_OVERRIDE;
 
     ImageDecoder newDecoder() const CV_OVERRIDE;
+    bool reset() CV_OVERRIDE;
 
 private:
     static void readDataFromBuf(void* png_ptr, uchar* dst, size_t size);
@@ -211,6 +212,7 @@ protected:
     size_t writeToStreamOrBuffer(void const* buffer, size_t  num_bytes, FILE* stream);
 
 private:
+    bool writeParallel(const Mat& img, const std::vector<int>& params, int threads);
     void writeChunk(FILE* f, const char* name, unsigned char* data, uint32_t length);
     void writeIDATs(FILE* f, int frame, unsigned char* data, uint32_t length, uint32_t idat_size);
     void processRect(unsigned char* row, int rowbytes, int bpp, int stride, int h, unsigned char* rows);
@@ -51,6 +51,7 @@
 #include <opencv2/core/utils/logger.hpp>
 
 #include "grfmt_tiff.hpp"
+#include <opencv2/core/utils/tls.hpp>
 #include <limits>
 
 #include "tiff.h"
@@ -104,6 +105,9 @@ static bool cv_tiffSetErrorHandler()
     return v;
 }
 
+// The tiles are decoded in parallel only if there is enough data: every thread opens one more libtiff handle
+static const size_t TIFF_PARALLEL_MIN_DECODED_SIZE = 1 << 18;
+
 static const char fmtSignTiffII[] = "II\x2a\x00";
 static const char fmtSignTiffMM[] = "MM\x00\x2a";
 static const char fmtSignBigTiffII[] = "II\x2b\x00";
@@ -156,10 +160,15 @@ ImageDecoder TiffDecoder::newDecoder() const
 class TiffDecoderBufHelper
 {
     Mat& m_buf;
+    size_t m_own_pos;
     size_t& m_buf_pos;
 public:
     TiffDecoderBufHelper(Mat& buf, size_t& buf_pos) :
-        m_buf(buf), m_buf_pos(buf_pos)
+        m_buf(buf), m_own_pos(0), m_buf_pos(buf_pos)
+    {}
+    // keeps its own position, for additional handles reading the same buffer
+    explicit TiffDecoderBufHelper(Mat& buf) :
+        m_buf(buf), m_own_pos(0), m_buf_pos(m_own_pos)
     {}
     static tmsize_t read( thandle_t handle, void* buffer, tmsize_t n )
     {
@@ -229,6 +238,35 @@ public:
     }
 };
 
+/**
+ * Opens one more handle of the decoder source at the directory with the given offset.
+ * libtiff handles are not thread-safe, each thread decoding tiles in parallel needs its own one.
+ */
+static Ptr<void> cv_tiffOpenDirectory(const String& filename, Mat& buf, toff_t dir_offset)
+{
+    TIFF* tif = NULL;
+    if ( !buf.empty() )
+    {
+        TiffDecoderBufHelper* buf_helper = new TiffDecoderBufHelper(buf);
+        tif = TIFFClientOpen( "", "r", reinterpret_cast<thandle_t>(buf_helper), &TiffDecoderBufHelper::read,
+                              &TiffDecoderBufHelper::write, &TiffDecoderBufHelper::seek,
+                              &TiffDecoderBufHelper::close, &TiffDecoderBufHelper::size,
+                              &TiffDecoderBufHelper::map, /*unmap=*/0 );
+        if (!tif)
+            delete buf_helper;
+    }
+    else
+    {
+        tif = TIFFOpen(filename.c_str(), "r");
+    }
+    if (!tif)
+        return Ptr<void>();
+    Ptr<void> handle(tif, cv_tiffCloseHandle);
+    if (!TIFFSetSubDirectory(tif, dir_offset))
+        return Ptr<void>();
+    return handle;
+}
+
 bool TiffDecoder::readHeader()
 {
     bool result = false;
@@ -262,6 +300,7 @@ bool TiffDecoder::readHeader()
     {
         uint32_t wdth = 0, hght = 0;
         uint16_t photometric = 0;
+        m_roi = Rect();
 
         CV_TIFF_CHECK_CALL(TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &wdth));
         CV_TIFF_CHECK_CALL(TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &hght));
@@ -375,6 +414,86 @@ bool TiffDecoder::nextPage()
            readHeader();
 }
 
+// the properties that must match between the levels of a pyramidal image
+static Vec4i tiffSampleLayout(TIFF* tif)
+{
+    uint16_t bpp = 1, ncn = 1, photometric = (uint16_t)-1, sample_format = SAMPLEFORMAT_UINT;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bpp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &ncn);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_format);
+    TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric);
+    return Vec4i(bpp, ncn, photometric, sample_format);
+}
+
+bool TiffDecoder::setDecodeRegion( const Rect& roi, Size& size )
+{
+    TIFF* tif = static_cast<TIFF*>(m_tif.get());
+    if (!tif || m_hdr || !m_width || !m_height)
+        return false;
+
+    CV_Assert( 0 <= roi.x && 0 < roi.width && roi.x + roi.width <= m_width &&
+               0 <= roi.y && 0 < roi.height && roi.y + roi.height <= m_height );
+
+    // the region is given in the stored layout, the flips and the transpositions are applied later
+    uint16_t orientation = ORIENTATION_TOPLEFT;
+    CV_TIFF_CHECK_CALL_DEBUG(TIFFGetField(tif, TIFFTAG_ORIENTATION, &orientation));
+    if (orientation != ORIENTATION_TOPLEFT)
+        return false;
+
+    Rect region = roi;
+    uint16_t nlevels = 0;
+    toff_t* level_offsets = NULL;
+    if (TIFFGetField(tif, TIFFTAG_SUBIFD, &nlevels, &level_offsets) && nlevels > 0)
+    {
+        // Pyramidal image: read the smallest reduced-resolution level (SubIFD)
+        // that keeps the region not smaller than the requested size.
+        const std::vector<toff_t> offsets(level_offsets, level_offsets + nlevels);
+        const toff_t main_offset = TIFFCurrentDirOffset(tif);
+        const Vec4i layout = tiffSampleLayout(tif);
+        toff_t best_offset = main_offset;
+        for (size_t i = 0; i < offsets.size(); i++)
+        {
+            uint32_t wdth = 0, hght = 0;
+            if (!TIFFSetSubDirectory(tif, offsets[i]) ||
+                !TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &wdth) || !TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &hght) ||
+                wdth == 0 || wdth > (uint32_t)m_width || hght == 0 || hght > (uint32_t)m_height ||
+                tiffSampleLayout(tif) != layout)
+                continue;
+            uint16_t level_orientation = ORIENTATION_TOPLEFT;
+            TIFFGetField(tif, TIFFTAG_ORIENTATION, &level_orientation);
+            if (level_orientation != ORIENTATION_TOPLEFT)
+                continue;
+
+            double sx = (double)wdth / m_width, sy = (double)hght / m_height;
+            int x0 = cvFloor(roi.x * sx), y0 = cvFloor(roi.y * sy);
+            int x1 = std::min(cvCeil((roi.x + roi.width) * sx), (int)wdth);
+            int y1 = std::min(cvCeil((roi.y + roi.height) * sy), (int)hght);
+            Rect r(x0, y0, x1 - x0, y1 - y0);
+            if (r.width >= size.width && r.height >= size.height && r.area() < region.area())
+            {
+                region = r;
+                best_offset = offsets[i];
+            }
+        }
+        CV_TIFF_CHECK_CALL(TIFFSetSubDirectory(tif, best_offset));
+    }
+
+    m_roi = region;
+    m_width = region.width;
+    m_height = region.height;
+    size = region.size();
+    return true;
+}
+
+// the state of a thread decoding tiles in parallel
+struct TiffTileReader
+{
+    Ptr<void> tif;
+    AutoBuffer<uchar> src_buffer;
+    AutoBuffer<uchar> src_buffer_unpacked;
+    Mat tile_buffer;
+};
+
 static void fixOrientationPartial(Mat &img, uint16_t orientation)
 {
     switch(orientation) {
@@ -606,6 +725,11 @@ bool  TiffDecoder::readData( Mat& img )
 
     if (m_width && m_height)
     {
+        // the size of the whole directory, setDecodeRegion() reduces m_width and m_height to the region
+        uint32_t wdth = 0, hght = 0;
+        CV_TIFF_CHECK_CALL(TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &wdth));
+        CV_TIFF_CHECK_CALL(TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &hght));
+        const int width = (int)wdth, height = (int)hght;
         int is_tiled = TIFFIsTiled(tif) != 0;
         bool isGrayScale = photometric == PHOTOMETRIC_MINISWHITE || photometric == PHOTOMETRIC_MINISBLACK;
         uint16_t bpp = 8, ncn = isGrayScale ? 1 : 3;
@@ -625,7 +749,7 @@ bool  TiffDecoder::readData( Mat& img )
         int wanted_channels = normalizeChannelsNumber(img.channels());
         bool doReadScanline = false;
 
-        uint32_t tile_width0 = m_width, tile_height0 = 0;
+        uint32_t tile_width0 = width, tile_height0 = 0;
 
         if (is_tiled)
         {
@@ -640,11 +764,11 @@ bool  TiffDecoder::readData( Mat& img )
 
         {
             if (tile_width0 == 0)
-                tile_width0 = m_width;
+                tile_width0 = width;
 
             if (tile_height0 == 0 ||
                     (!is_tiled && tile_height0 == std::numeric_limits<uint32_t>::max()) )
-                tile_height0 = m_height;
+                tile_height0 = height;
 
             const int TILE_MAX_WIDTH = (1 << 24);
             const int TILE_MAX_HEIGHT = (1 << 24);
@@ -677,7 +801,7 @@ bool  TiffDecoder::readData( Mat& img )
                                      &&
                                      ( ( bpp == 8 ) || ( bpp == 16 ) )
                                      &&
-                                     (tile_height0 == (uint32_t) m_height) // single strip
+                                     (tile_height0 == (uint32_t) height) // single strip
                                      &&
                                      (
                                          (photometric == PHOTOMETRIC_MINISWHITE)
@@ -733,7 +857,7 @@ bool  TiffDecoder::readData( Mat& img )
                                      &&
                                      ( ( bpp == 8 ) || ( bpp == 16 ) )
                                      &&
-                                     (tile_height0 == (uint32_t) m_height) // single strip
+                                     (tile_height0 == (uint32_t) height) // single strip
                                      &&
                                      (
                                          (photometric == PHOTOMETRIC_MINISWHITE)
@@ -773,10 +897,6 @@ bool  TiffDecoder::readData( Mat& img )
             const size_t src_buffer_unpacked_bytes_per_row = divUp(static_cast<size_t>(ncn * tile_width0 * dst_bpp), static_cast<size_t>(bitsPerByte));
             const size_t src_buffer_unpacked_size = tile_height0 * src_buffer_unpacked_bytes_per_row;
             const bool needsUnpacking = (bpp < dst_bpp);
-            AutoBuffer<uchar> _src_buffer(src_buffer_size);
-            uchar* src_buffer = _src_buffer.data();
-            AutoBuffer<uchar> _src_buffer_unpacked(needsUnpacking ? src_buffer_unpacked_size : 0);
-            uchar* src_buffer_unpacked = needsUnpacking ? _src_buffer_unpacked.data() : nullptr;
 
             if ( doReadScanline )
             {
@@ -785,277 +905,334 @@ bool  TiffDecoder::readData( Mat& img )
                            "src_buffer_size is smaller than TIFFScanlineSize().");
             }
 
-            int tileidx = 0;
-
             #define MAKE_FLAG(a,b) ( (a << 8) | b )
             const int  convert_flag = MAKE_FLAG( ncn, wanted_channels );
             const bool isNeedConvert16to8 = ( doReadScanline ) && ( bpp == 16 ) && ( dst_bpp == 8);
 
-            for (int y = 0; y < m_height; y += (int)tile_height0)
-            {
-                int tile_height = std::min((int)tile_height0, m_height - y);
+            const Rect roi = m_roi.empty() ? Rect(0, 0, width, height) : m_roi;
+            CV_Assert(img.size() == roi.size());
+            const int tiles_across = divUp(width, tile_width0);
+            const int tx0 = roi.x / (int)tile_width0, tx1 = divUp(roi.x + roi.width, tile_width0);
+            const int ty0 = roi.y / (int)tile_height0, ty1 = divUp(roi.y + roi.height, tile_height0);
 
-                const int img_y = vert_flip ? m_height - y - tile_height : y;
-
-                for(int x = 0; x < m_width; x += (int)tile_width0, tileidx++)
+            // Decodes the tile (the strip if the image is not tiled) with the given indices through the given handle
+            // and stores its part inside of the region into img. The tiles are independent, so they can be decoded
+            // concurrently through different handles.
+            auto readTile = [&](TIFF* handle, int tx, int ty, uchar* src_buffer, uchar* src_buffer_unpacked, Mat& tile_buffer)
+            {
+                const int x = tx * (int)tile_width0, y = ty * (int)tile_height0;
+                const int tileidx = ty * tiles_across + tx;
+                const int tile_width = std::min((int)tile_width0, width - x);
+                const int tile_height = std::min((int)tile_height0, height - y);
+
+                const int img_y = vert_flip ? height - y - tile_height : y;
+
+                // the tiles crossing the border of the region are decoded into a temporary buffer
+                const Rect tile_rect(x, doReadScanline ? y : img_y, tile_width, tile_height);
+                const Rect visible = tile_rect & roi;
+                Mat tile;
+                if (visible == tile_rect)
                 {
-                    int tile_width = std::min((int)tile_width0, m_width - x);
+                    tile = img(tile_rect - roi.tl());
+                }
+                else
+                {
+                    tile_buffer.create((int)tile_height0, (int)tile_width0, img.type());
+                    tile = tile_buffer(Rect(0, 0, tile_width, tile_height));
+                }
 
-                    switch (dst_bpp)
+                switch (dst_bpp)
+                {
+                    case 8:
                     {
-                        case 8:
+                        uchar* bstart = src_buffer;
+                        if (doReadScanline)
                         {
-                            uchar* bstart = src_buffer;
-                            if (doReadScanline)
-                            {
-                                CV_TIFF_CHECK_CALL((int)TIFFReadScanline(tif, (uint32_t*)src_buffer, y) >= 0);
+                            CV_TIFF_CHECK_CALL((int)TIFFReadScanline(handle, (uint32_t*)src_buffer, y) >= 0);
 
-                                if ( isNeedConvert16to8 )
+                            if ( isNeedConvert16to8 )
+                            {
+                                // Convert buffer image from 16bit to 8bit.
+                                int ix;
+                                for ( ix = 0 ; ix < tile_width * ncn - 4; ix += 4 )
                                 {
-                                    // Convert buffer image from 16bit to 8bit.
-                                    int ix;
-                                    for ( ix = 0 ; ix < tile_width * ncn - 4; ix += 4 )
-                                    {
-                                        src_buffer[ ix     ] = src_buffer[ ix * 2 + 1 ];
-                                        src_buffer[ ix + 1 ] = src_buffer[ ix * 2 + 3 ];
-                                        src_buffer[ ix + 2 ] = src_buffer[ ix * 2 + 5 ];
-                                        src_buffer[ ix + 3 ] = src_buffer[ ix * 2 + 7 ];
-                                    }
+                                    src_buffer[ ix     ] = src_buffer[ ix * 2 + 1 ];
+                                    src_buffer[ ix + 1 ] = src_buffer[ ix * 2 + 3 ];
+                                    src_buffer[ ix + 2 ] = src_buffer[ ix * 2 + 5 ];
+                                    src_buffer[ ix + 3 ] = src_buffer[ ix * 2 + 7 ];
+                                }
 
-                                    for (        ; ix < tile_width * ncn ; ix ++ )
-                                    {
-                                        src_buffer[ ix ] = src_buffer[ ix * 2 + 1];
-                                    }
+                                for (        ; ix < tile_width * ncn ; ix ++ )
+                                {
+                                    src_buffer[ ix ] = src_buffer[ ix * 2 + 1];
                                 }
                             }
-                            else if (!is_tiled)
-                            {
-                                CV_TIFF_CHECK_CALL(TIFFReadRGBAStrip(tif, y, (uint32_t*)src_buffer));
-                            }
-                            else
-                            {
-                                CV_TIFF_CHECK_CALL(TIFFReadRGBATile(tif, x, y, (uint32_t*)src_buffer));
-                                // Tiles fill the buffer from the bottom up
-                                bstart += (tile_height0 - tile_height) * tile_width0 * 4;
-                            }
+                        }
+                        else if (!is_tiled)
+                        {
+                            CV_TIFF_CHECK_CALL(TIFFReadRGBAStrip(handle, y, (uint32_t*)src_buffer));
+                        }
+                        else
+                        {
+                            CV_TIFF_CHECK_CALL(TIFFReadRGBATile(handle, x, y, (uint32_t*)src_buffer));
+                            // Tiles fill the buffer from the bottom up
+                            bstart += (tile_height0 - tile_height) * tile_width0 * 4;
+                        }
 
-                            uchar* img_line_buffer = (uchar*) img.ptr(y, 0);
+                        uchar* img_line_buffer = tile.ptr(0);
 
-                            for (int i = 0; i < tile_height; i++)
+                        for (int i = 0; i < tile_height; i++)
+                        {
+                            if (doReadScanline)
                             {
-                                if (doReadScanline)
+                                switch ( convert_flag )
                                 {
-                                    switch ( convert_flag )
-                                    {
-                                    case MAKE_FLAG( 1, 1 ): // GRAY to GRAY
+                                case MAKE_FLAG( 1, 1 ): // GRAY to GRAY
+                                    std::memcpy( (void*) img_line_buffer,
+                                                 (void*) bstart,
+                                                 tile_width * sizeof(uchar) );
+                                    break;
+
+                                case MAKE_FLAG( 1, 3 ): // GRAY to BGR
+                                    icvCvt_Gray2BGR_8u_C1C3R( bstart, 0,
+                                            img_line_buffer, 0,
+                                            Size(tile_width, 1) );
+                                    break;
+
+                                case MAKE_FLAG( 3, 1): // RGB to GRAY
+                                    icvCvt_BGR2Gray_8u_C3C1R( bstart, 0,
+                                            img_line_buffer, 0,
+                                            Size(tile_width, 1) );
+                                    break;
+
+                                case MAKE_FLAG( 3, 3 ): // RGB to BGR
+                                    if (m_use_rgb)
                                         std::memcpy( (void*) img_line_buffer,
                                                      (void*) bstart,
                                                      tile_width * sizeof(uchar) );
-                                        break;
-
-                                    case MAKE_FLAG( 1, 3 ): // GRAY to BGR
-                                        icvCvt_Gray2BGR_8u_C1C3R( bstart, 0,
-                                                img_line_buffer, 0,
-                                                Size(tile_width, 1) );
-                                        break;
-
-                                    case MAKE_FLAG( 3, 1): // RGB to GRAY
-                                        icvCvt_BGR2Gray_8u_C3C1R( bstart, 0,
-                                                img_line_buffer, 0,
-                                                Size(tile_width, 1) );
-                                        break;
-
-                                    case MAKE_FLAG( 3, 3 ): // RGB to BGR
-                                        if (m_use_rgb)
-                                            std::memcpy( (void*) img_line_buffer,
-                                                         (void*) bstart,
-                                                         tile_width * sizeof(uchar) );
-                                        else
-                                            icvCvt_BGR2RGB_8u_C3R( bstart, 0,
-                                                    img_line_buffer, 0,
-                                                    Size(tile_width, 1) );
-                                        break;
-
-                                    case MAKE_FLAG( 4, 1 ): // RGBA to GRAY
-                                        icvCvt_BGRA2Gray_8u_C4C1R( bstart, 0,
-                                                img_line_buffer, 0,
-                                                Size(tile_width, 1) );
-                                        break;
-
-                                    case MAKE_FLAG( 4, 3 ): // RGBA to BGR
-                                        icvCvt_BGRA2BGR_8u_C4C3R( bstart, 0,
-                                                img_line_buffer, 0,
-                                                Size(tile_width, 1), m_use_rgb ? 0 : 2);
-                                        break;
-
-                                    case MAKE_FLAG( 4, 4 ): // RGBA to BGRA
-                                        icvCvt_BGRA2RGBA_8u_C4R(bstart, 0,
+                                    else
+                                        icvCvt_BGR2RGB_8u_C3R( bstart, 0,
                                                 img_line_buffer, 0,
                                                 Size(tile_width, 1) );
-                                        break;
-
-                                    default:
-                                        CV_LOG_ONCE_ERROR(NULL, "OpenCV TIFF(line " << __LINE__ << "): Unsupported convertion :"
-                                                               << " bpp = " << bpp << " ncn = " << (int)ncn
-                                                               << " wanted_channels =" << wanted_channels  );
-                                        break;
-                                    }
-                                    #undef MAKE_FLAG
+                                    break;
+
+                                case MAKE_FLAG( 4, 1 ): // RGBA to GRAY
+                                    icvCvt_BGRA2Gray_8u_C4C1R( bstart, 0,
+                                            img_line_buffer, 0,
+                                            Size(tile_width, 1) );
+                                    break;
+
+                                case MAKE_FLAG( 4, 3 ): // RGBA to BGR
+                                    icvCvt_BGRA2BGR_8u_C4C3R( bstart, 0,
+                                            img_line_buffer, 0,
+                                            Size(tile_width, 1), m_use_rgb ? 0 : 2);
+                                    break;
+
+                                case MAKE_FLAG( 4, 4 ): // RGBA to BGRA
+                                    icvCvt_BGRA2RGBA_8u_C4R(bstart, 0,
+                                            img_line_buffer, 0,
+                                            Size(tile_width, 1) );
+                                    break;
+
+                                default:
+                                    CV_LOG_ONCE_ERROR(NULL, "OpenCV TIFF(line " << __LINE__ << "): Unsupported convertion :"
+                                                           << " bpp = " << bpp << " ncn = " << (int)ncn
+                                                           << " wanted_channels =" << wanted_channels  );
+                                    break;
                                 }
-                                else if (color)
+                                #undef MAKE_FLAG
+                            }
+                            else if (color)
+                            {
+                                if (wanted_channels == 4)
                                 {
-                                    if (wanted_channels == 4)
-                                    {
-                                        icvCvt_BGRA2RGBA_8u_C4R(bstart + i*tile_width0*4, 0,
-                                                img.ptr(img_y + tile_height - i - 1, x), 0,
-                                                Size(tile_width, 1) );
-                                    }
-                                    else
-                                    {
-                                        CV_CheckEQ(wanted_channels, 3, "TIFF-8bpp: BGR/BGRA images are supported only");
-                                        icvCvt_BGRA2BGR_8u_C4C3R(bstart + i*tile_width0*4, 0,
-                                                img.ptr(img_y + tile_height - i - 1, x), 0,
-                                                Size(tile_width, 1), m_use_rgb ? 0 : 2);
-                                    }
+                                    icvCvt_BGRA2RGBA_8u_C4R(bstart + i*tile_width0*4, 0,
+                                            tile.ptr(tile_height - i - 1), 0,
+                                            Size(tile_width, 1) );
                                 }
                                 else
                                 {
-                                    CV_CheckEQ(wanted_channels, 1, "");
-                                    icvCvt_BGRA2Gray_8u_C4C1R( bstart + i*tile_width0*4, 0,
-                                            img.ptr(img_y + tile_height - i - 1, x), 0,
-                                            Size(tile_width, 1), 2);
+                                    CV_CheckEQ(wanted_channels, 3, "TIFF-8bpp: BGR/BGRA images are supported only");
+                                    icvCvt_BGRA2BGR_8u_C4C3R(bstart + i*tile_width0*4, 0,
+                                            tile.ptr(tile_height - i - 1), 0,
+                                            Size(tile_width, 1), m_use_rgb ? 0 : 2);
                                 }
                             }
-                            break;
+                            else
+                            {
+                                CV_CheckEQ(wanted_channels, 1, "");
+                                icvCvt_BGRA2Gray_8u_C4C1R( bstart + i*tile_width0*4, 0,
+                                        tile.ptr(tile_height - i - 1), 0,
+                                        Size(tile_width, 1), 2);
+                            }
                         }
+                        break;
+                    }
 
-                        case 16:
+                    case 16:
+                    {
+                        if (doReadScanline)
                         {
-                            if (doReadScanline)
-                            {
-                                CV_TIFF_CHECK_CALL((int)TIFFReadScanline(tif, (uint32_t*)src_buffer, y) >= 0);
-                            }
-                            else if (!is_tiled)
-                            {
-                                CV_TIFF_CHECK_CALL((int)TIFFReadEncodedStrip(tif, tileidx, (uint32_t*)src_buffer, src_buffer_size) >= 0);
-                            }
-                            else
+                            CV_TIFF_CHECK_CALL((int)TIFFReadScanline(handle, (uint32_t*)src_buffer, y) >= 0);
+                        }
+                        else if (!is_tiled)
+                        {
+                            CV_TIFF_CHECK_CALL((int)TIFFReadEncodedStrip(handle, tileidx, (uint32_t*)src_buffer, src_buffer_size) >= 0);
+                        }
+                        else
+                        {
+                            CV_TIFF_CHECK_CALL((int)TIFFReadEncodedTile(handle, tileidx, (uint32_t*)src_buffer, src_buffer_size) >= 0);
+                        }
+
+                        for (int i = 0; i < tile_height; i++)
+                        {
+                            ushort* buffer16 = (ushort*)(src_buffer+i*src_buffer_bytes_per_row);
+                            if (needsUnpacking)
                             {
-                                CV_TIFF_CHECK_CALL((int)TIFFReadEncodedTile(tif, tileidx, (uint32_t*)src_buffer, src_buffer_size) >= 0);
+                                const uchar* src_packed = src_buffer+i*src_buffer_bytes_per_row;
+                                uchar* dst_unpacked = src_buffer_unpacked+i*src_buffer_unpacked_bytes_per_row;
+                                if (bpp == 10)
+                                    _unpack10To16(src_packed, src_packed+src_buffer_bytes_per_row,
+                                                  (ushort*)dst_unpacked, (ushort*)(dst_unpacked+src_buffer_unpacked_bytes_per_row),
+                                                  ncn * tile_width0);
+                                else if (bpp == 12)
+                                    _unpack12To16(src_packed, src_packed+src_buffer_bytes_per_row,
+                                                  (ushort*)dst_unpacked, (ushort*)(dst_unpacked+src_buffer_unpacked_bytes_per_row),
+                                                  ncn * tile_width0);
+                                else if (bpp == 14)
+                                    _unpack14To16(src_packed, src_packed+src_buffer_bytes_per_row,
+                                                  (ushort*)dst_unpacked, (ushort*)(dst_unpacked+src_buffer_unpacked_bytes_per_row),
+                                                  ncn * tile_width0);
+                                buffer16 = (ushort*)dst_unpacked;
                             }
 
-                            for (int i = 0; i < tile_height; i++)
+                            if (color)
                             {
-                                ushort* buffer16 = (ushort*)(src_buffer+i*src_buffer_bytes_per_row);
-                                if (needsUnpacking)
+                                if (ncn == 1)
                                 {
-                                    const uchar* src_packed = src_buffer+i*src_buffer_bytes_per_row;
-                                    uchar* dst_unpacked = src_buffer_unpacked+i*src_buffer_unpacked_bytes_per_row;
-                                    if (bpp == 10)
-                                        _unpack10To16(src_packed, src_packed+src_buffer_bytes_per_row,
-                                                      (ushort*)dst_unpacked, (ushort*)(dst_unpacked+src_buffer_unpacked_bytes_per_row),
-                                                      ncn * tile_width0);
-                                    else if (bpp == 12)
-                                        _unpack12To16(src_packed, src_packed+src_buffer_bytes_per_row,
-                                                      (ushort*)dst_unpacked, (ushort*)(dst_unpacked+src_buffer_unpacked_bytes_per_row),
-                                                      ncn * tile_width0);
-                                    else if (bpp == 14)
-                                        _unpack14To16(src_packed, src_packed+src_buffer_bytes_per_row,
-                                                      (ushort*)dst_unpacked, (ushort*)(dst_unpacked+src_buffer_unpacked_bytes_per_row),
-                                                      ncn * tile_width0);
-                                    buffer16 = (ushort*)dst_unpacked;
+                                    CV_CheckEQ(wanted_channels, 3, "");
+                                    icvCvt_Gray2BGR_16u_C1C3R(buffer16, 0,
+                                            tile.ptr<ushort>(i), 0,
+                                            Size(tile_width, 1));
                                 }
-
-                                if (color)
+                                else if (ncn == 3)
                                 {
-                                    if (ncn == 1)
-                                    {
-                                        CV_CheckEQ(wanted_channels, 3, "");
-                                        icvCvt_Gray2BGR_16u_C1C3R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
+                                    CV_CheckEQ(wanted_channels, 3, "");
+                                    if (m_use_rgb)
+                                        std::memcpy(tile.ptr<ushort>(i), buffer16, tile_width * 3 * sizeof(ushort));
+                                    else
+                                        icvCvt_RGB2BGR_16u_C3R(buffer16, 0,
+                                                tile.ptr<ushort>(i), 0,
                                                 Size(tile_width, 1));
-                                    }
-                                    else if (ncn == 3)
-                                    {
-                                        CV_CheckEQ(wanted_channels, 3, "");
-                                        if (m_use_rgb)
-                                            std::memcpy(buffer16, img.ptr<ushort>(img_y + i, x), tile_width * sizeof(ushort));
-                                        else
-                                            icvCvt_RGB2BGR_16u_C3R(buffer16, 0,
-                                                    img.ptr<ushort>(img_y + i, x), 0,
-                                                    Size(tile_width, 1));
-                                    }
-                                    else if (ncn == 4)
+                                }
+                                else if (ncn == 4)
+                                {
+                                    if (wanted_channels == 4)
                                     {
-                                        if (wanted_channels == 4)
-                                        {
-                                            icvCvt_BGRA2RGBA_16u_C4R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
-                                                Size(tile_width, 1));
-                                        }
-                                        else
-                                        {
-                                            CV_CheckEQ(wanted_channels, 3, "TIFF-16bpp: BGR/BGRA images are supported only");
-                                            icvCvt_BGRA2BGR_16u_C4C3R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
-                                                Size(tile_width, 1), m_use_rgb ? 0 : 2);
-                                        }
+                                        icvCvt_BGRA2RGBA_16u_C4R(buffer16, 0,
+                                            tile.ptr<ushort>(i), 0,
+                                            Size(tile_width, 1));
                                     }
                                     else
                                     {
-                                        CV_Error(Error::StsError, "Not supported");
+                                        CV_CheckEQ(wanted_channels, 3, "TIFF-16bpp: BGR/BGRA images are supported only");
+                                        icvCvt_BGRA2BGR_16u_C4C3R(buffer16, 0,
+                                            tile.ptr<ushort>(i), 0,
+                                            Size(tile_width, 1), m_use_rgb ? 0 : 2);
                                     }
                                 }
                                 else
                                 {
-                                    CV_CheckEQ(wanted_channels, 1, "");
-                                    if( ncn == 1 )
-                                    {
-                                        std::memcpy(img.ptr<ushort>(img_y + i, x),
-                                                    buffer16,
-                                                    tile_width*sizeof(ushort));
-                                    }
-                                    else
-                                    {
-                                        icvCvt_BGRA2Gray_16u_CnC1R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
-                                                Size(tile_width, 1), ncn, 2);
-                                    }
+                                    CV_Error(Error::StsError, "Not supported");
                                 }
                             }
-                            break;
-                        }
-
-                        case 32:
-                        case 64:
-                        {
-                            if( !is_tiled )
-                            {
-                                CV_TIFF_CHECK_CALL((int)TIFFReadEncodedStrip(tif, tileidx, src_buffer, src_buffer_size) >= 0);
-                            }
                             else
                             {
-                                CV_TIFF_CHECK_CALL((int)TIFFReadEncodedTile(tif, tileidx, src_buffer, src_buffer_size) >= 0);
+                                CV_CheckEQ(wanted_channels, 1, "");
+                                if( ncn == 1 )
+                                {
+                                    std::memcpy(tile.ptr<ushort>(i),
+                                                buffer16,
+                                                tile_width*sizeof(ushort));
+                                }
+                                else
+                                {
+                                    icvCvt_BGRA2Gray_16u_CnC1R(buffer16, 0,
+                                            tile.ptr<ushort>(i), 0,
+                                            Size(tile_width, 1), ncn, 2);
+                                }
                             }
+                        }
+                        break;
+                    }
 
-                            Mat m_tile(Size(tile_width0, tile_height0), CV_MAKETYPE((dst_bpp == 32) ? (depth == CV_32S ? CV_32S : CV_32F) : CV_64F, ncn), src_buffer);
-                            Rect roi_tile(0, 0, tile_width, tile_height);
-                            Rect roi_img(x, img_y, tile_width, tile_height);
-                            if (!m_hdr && ncn == 3 && !m_use_rgb)
-                                extend_cvtColor(m_tile(roi_tile), img(roi_img), COLOR_RGB2BGR);
-                            else if (!m_hdr && ncn == 4)
-                                extend_cvtColor(m_tile(roi_tile), img(roi_img), COLOR_RGBA2BGRA);
-                            else
-                                m_tile(roi_tile).copyTo(img(roi_img));
-                            break;
+                    case 32:
+                    case 64:
+                    {
+                        if( !is_tiled )
+                        {
+                            CV_TIFF_CHECK_CALL((int)TIFFReadEncodedStrip(handle, tileidx, src_buffer, src_buffer_size) >= 0);
                         }
-                        default:
+                        else
                         {
-                            CV_Assert(0 && "OpenCV TIFF: unsupported depth");
+                            CV_TIFF_CHECK_CALL((int)TIFFReadEncodedTile(handle, tileidx, src_buffer, src_buffer_size) >= 0);
                         }
-                    }  // switch (dst_bpp)
-                }  // for x
-            }  // for y
+
+                        Mat m_tile(Size(tile_width0, tile_height0), CV_MAKETYPE((dst_bpp == 32) ? (depth == CV_32S ? CV_32S : CV_32F) : CV_64F, ncn), src_buffer);
+                        Rect roi_tile(0, 0, tile_width, tile_height);
+                        if (!m_hdr && ncn == 3 && !m_use_rgb)
+                            extend_cvtColor(m_tile(roi_tile), tile, COLOR_RGB2BGR);
+                        else if (!m_hdr && ncn == 4)
+                            extend_cvtColor(m_tile(roi_tile), tile, COLOR_RGBA2BGRA);
+                        else
+                            m_tile(roi_tile).copyTo(tile);
+                        break;
+                    }
+                    default:
+                    {
+                        CV_Assert(0 && "OpenCV TIFF: unsupported depth");
+                    }
+                }  // switch (dst_bpp)
+
+                if (visible != tile_rect)
+                    tile(visible - tile_rect.tl()).copyTo(img(visible - roi.tl()));
+            };
+
+            const int ntiles = (tx1 - tx0) * (ty1 - ty0);
+            if (doReadScanline || m_hdr || ntiles < 2 || getNumThreads() < 2 ||
+                (size_t)ntiles * src_buffer_size < TIFF_PARALLEL_MIN_DECODED_SIZE)
+            {
+                AutoBuffer<uchar> _src_buffer(src_buffer_size);
+                AutoBuffer<uchar> _src_buffer_unpacked(needsUnpacking ? src_buffer_unpacked_size : 0);
+                Mat tile_buffer;
+                for (int ty = ty0; ty < ty1; ty++)
+                    for (int tx = tx0; tx < tx1; tx++)
+                        readTile(tif, tx, ty, _src_buffer.data(), needsUnpacking ? _src_buffer_unpacked.data() : nullptr, tile_buffer);
+            }
+            else
+            {
+                const toff_t dir_offset = TIFFCurrentDirOffset(tif);
+                TLSData<TiffTileReader> readers;
+                parallel_for_(Range(0, ntiles), [&](const Range& range)
+                {
+                    TiffTileReader& reader = readers.getRef();
+                    if (reader.tif.empty())
+                    {
+                        reader.tif = cv_tiffOpenDirectory(m_filename, m_buf, dir_offset);
+                        if (reader.tif.empty())
+                            CV_Error(Error::StsError, "OpenCV TIFF: can't open one more handle of the image");
+                        if (dst_bpp == 32 || dst_bpp == 64)
+                            CV_TIFF_CHECK_CALL(TIFFSetField((TIFF*)reader.tif.get(), TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP));
+                        reader.src_buffer.allocate(src_buffer_size);
+                        if (needsUnpacking)
+                            reader.src_buffer_unpacked.allocate(src_buffer_unpacked_size);
+                    }
+                    for (int i = range.start; i < range.end; i++)
+                        readTile((TIFF*)reader.tif.get(), tx0 + i % (tx1 - tx0), ty0 + i / (tx1 - tx0),
+                                 reader.src_buffer.data(), needsUnpacking ? reader.src_buffer_unpacked.data() : nullptr,
+                                 reader.tile_buffer);
+                });
+            }
         }
         if (bpp < dst_bpp)
           img *= (1<<(dst_bpp-bpp));
@@ -100,6 +100,7 @@ public:
     bool  readData( Mat& img ) CV_OVERRIDE;
     void  close();
     bool  nextPage() CV_OVERRIDE;
+    bool  setDecodeRegion( const Rect& roi, Size& size ) CV_OVERRIDE;
 
     size_t signatureLength() const CV_OVERRIDE;
     bool checkSignature( const String& signature ) const CV_OVERRIDE;
@@ -110,6 +111,7 @@ protected:
     int normalizeChannelsNumber(int channels) const;
     bool m_hdr;
     size_t m_buf_pos;
+    Rect m_roi; // decoded region of the current directory, empty for the whole image
 
 private:
     TiffDecoder(const TiffDecoder &); // copy disabled
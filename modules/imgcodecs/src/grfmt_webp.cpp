@@ -104,6 +104,21 @@ ImageDecoder WebPDecoder::newDecoder() const
     return makePtr<WebPDecoder>();
 }
 
+bool WebPDecoder::reset()
+{
+    if (fs.is_open())
+        fs.close();
+    fs.clear();
+    fs_size = 0;
+    data.release();
+    anim_decoder.reset();
+    m_has_animation = false;
+    m_previous_timestamp = 0;
+    m_roi = Rect();
+    resetBaseState();
+    return true;
+}
+
 bool WebPDecoder::readHeader()
 {
     if (m_has_animation)
@@ -178,6 +193,24 @@ bool WebPDecoder::readHeader()
     return true;
 }
 
+bool WebPDecoder::setDecodeRegion( const Rect& roi, Size& size )
+{
+    if (m_has_animation || !m_width || !m_height)
+        return false;
+
+    CV_Assert(0 <= roi.x && 0 < roi.width && roi.x + roi.width <= m_width &&
+              0 <= roi.y && 0 < roi.height && roi.y + roi.height <= m_height);
+
+    // libwebp moves odd crop offsets of lossy images to the even position on the left/top.
+    // In that case the region is decoded with one extra row/column and without scaling.
+    if ((roi.x | roi.y) & 1)
+        size = roi.size();
+    m_roi = roi;
+    m_width = size.width;
+    m_height = size.height;
+    return true;
+}
+
 bool WebPDecoder::readData(Mat &img)
 {
     CV_CheckGE(m_width, 0, ""); CV_CheckGE(m_height, 0, "");
@@ -197,9 +230,11 @@ bool WebPDecoder::readData(Mat &img)
 
     Mat read_img;
     CV_CheckType(img.type(), img.type() == CV_8UC1 || img.type() == CV_8UC3 || img.type() == CV_8UC4, "");
-    if (img.type() != m_type || img.cols != m_width || img.rows != m_height)
+    // libwebp drops the alpha channel itself when decoding into 3-channel buffers
+    const int dec_type = (img.type() == CV_8UC3 && !m_has_animation) ? CV_8UC3 : m_type;
+    if (img.type() != dec_type || img.cols != m_width || img.rows != m_height)
     {
-        read_img.create(m_height, m_width, m_type);
+        read_img.create(m_height, m_width, dec_type);
     }
     else
     {
@@ -236,7 +271,43 @@ bool WebPDecoder::readData(Mat &img)
         return true;
     }
 
-    if (m_type == CV_8UC3)
+    if (!m_roi.empty())
+    {
+        const int dx = m_roi.x & 1, dy = m_roi.y & 1;
+        Mat dec = (dx | dy) ? Mat(m_roi.height + dy, m_roi.width + dx, dec_type) : read_img;
+
+        WebPDecoderConfig config;
+        if (!WebPInitDecoderConfig(&config))
+            return false;
+        config.options.use_cropping = 1;
+        config.options.crop_left = m_roi.x - dx;
+        config.options.crop_top = m_roi.y - dy;
+        config.options.crop_width = m_roi.width + dx;
+        config.options.crop_height = m_roi.height + dy;
+        if (dec.cols != config.options.crop_width || dec.rows != config.options.crop_height)
+        {
+            config.options.use_scaling = 1;
+            config.options.scaled_width = dec.cols;
+            config.options.scaled_height = dec.rows;
+        }
+        if (dec_type == CV_8UC3)
+            config.output.colorspace = m_use_rgb ? MODE_RGB : MODE_BGR;
+        else
+            config.output.colorspace = m_use_rgb ? MODE_RGBA : MODE_BGRA;
+        config.output.is_external_memory = 1;
+        config.output.u.RGBA.rgba = dec.ptr();
+        config.output.u.RGBA.stride = (int)dec.step;
+        config.output.u.RGBA.size = dec.dataend - dec.ptr();
+
+        VP8StatusCode status = WebPDecode(data.ptr(), data.total(), &config);
+        WebPFreeDecBuffer(&config.output);
+        if (status != VP8_STATUS_OK)
+            return false;
+        if (dec.data != read_img.data)
+            dec(Rect(dx, dy, m_roi.width, m_roi.height)).copyTo(read_img);
+        res_ptr = out_data;
+    }
+    else if (dec_type == CV_8UC3)
     {
         CV_CheckTypeEQ(read_img.type(), CV_8UC3, "");
         if (m_use_rgb)
@@ -246,7 +317,7 @@ bool WebPDecoder::readData(Mat &img)
             res_ptr = WebPDecodeBGRInto(data.ptr(), data.total(), out_data,
                 (int)out_data_size, (int)read_img.step);
     }
-    else if (m_type == CV_8UC4)
+    else if (dec_type == CV_8UC4)
     {
         CV_CheckTypeEQ(read_img.type(), CV_8UC4, "");
         if (m_use_rgb)
@@ -260,7 +331,7 @@ bool WebPDecoder::readData(Mat &img)
     if (res_ptr != out_data)
         return false;
 
-    if (read_img.data == img.data && img.type() == m_type)
+    if (read_img.data == img.data && img.type() == dec_type)
     {
         // nothing
     }
@@ -63,12 +63,14 @@ public:
 
     bool readData( Mat& img ) CV_OVERRIDE;
     bool readHeader() CV_OVERRIDE;
+    bool setDecodeRegion( const Rect& roi, Size& size ) CV_OVERRIDE;
     bool nextPage() CV_OVERRIDE;
 
     size_t signatureLength() const CV_OVERRIDE;
     bool checkSignature( const String& signature) const CV_OVERRIDE;
 
     ImageDecoder newDecoder() const CV_OVERRIDE;
+    bool reset() CV_OVERRIDE;
 
 protected:
     struct UniquePtrDeleter {
@@ -81,6 +83,7 @@ protected:
     std::unique_ptr<WebPAnimDecoder, UniquePtrDeleter> anim_decoder;
     bool m_has_animation;
     int m_previous_timestamp;
+    Rect m_roi; // decoded region, empty for the whole image
 };
 
 class WebPEncoder CV_FINAL : public BaseImageEncoder
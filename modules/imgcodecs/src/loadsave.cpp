@@ -54,6 +54,7 @@
 #include <cerrno>
 #include <opencv2/core/utils/logger.hpp>
 #include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/tls.hpp>
 #include <opencv2/imgcodecs.hpp>
 
 
@@ -241,14 +242,58 @@ ImageCodecInitializer& getCodecs()
     return g_codecs;
 }
 
+/**
+ * Create a decoder for the i-th registered codec
+ *
+ * @param[in] i Index of the codec
+ * @param[in] cache Optional per-thread set of decoder instances, one per codec, reused between calls
+ *
+ * @return Image decoder ready to accept a new source.
+*/
+static ImageDecoder newDecoder( size_t i, std::vector<ImageDecoder>* cache )
+{
+    ImageCodecInitializer& codecs = getCodecs();
+    if( !cache )
+        return codecs.decoders[i]->newDecoder();
+
+    cache->resize(codecs.decoders.size());
+    ImageDecoder& decoder = (*cache)[i];
+    if( !decoder || !decoder->reset() )
+        decoder = codecs.decoders[i]->newDecoder();
+    return decoder;
+}
+
+/**
+ * Per-thread decoder instances of imreadBatch() and imdecodeBatch(), kept between the calls
+ */
+static TLSData<std::vector<ImageDecoder> >& getDecoderCacheTLS()
+{
+    // never destroyed: the cache may be accessed from threads that outlive the static objects
+    static TLSData<std::vector<ImageDecoder> >* cache = new TLSData<std::vector<ImageDecoder> >();
+    return *cache;
+}
+
+/**
+ * Reset the cached decoders, so they do not keep the sources of the last decoded images
+ */
+static void releaseDecoderSources( std::vector<ImageDecoder>& cache )
+{
+    for( size_t i = 0; i < cache.size(); i++ )
+    {
+        if( cache[i] && !cache[i]->reset() )
+            cache[i].release();
+    }
+}
+
 /**
  * Find the decoders
  *
  * @param[in] filename File to search
+ * @param[in] cache Optional per-thread set of decoder instances to reuse
  *
  * @return Image decoder to parse image file.
 */
-static ImageDecoder findDecoder( const String& filename ) {
+static ImageDecoder findDecoder( const String& filename, std::vector<ImageDecoder>* cache = NULL ) {
 
     size_t i, maxlen = 0;
 
@@ -279,14 +324,14 @@ static ImageDecoder findDecoder( const String& filename ) {
     for( i = 0; i < codecs.decoders.size(); i++ )
     {
         if( codecs.decoders[i]->checkSignature(signature) )
-            return codecs.decoders[i]->newDecoder();
+            return newDecoder(i, cache);
     }
 
     /// If no decoder was found, return base type
     return ImageDecoder();
 }
 
-static ImageDecoder findDecoder( const Mat& buf )
+static ImageDecoder findDecoder( const Mat& buf, std::vector<ImageDecoder>* cache = NULL )
 {
     size_t i, maxlen = 0;
 
@@ -308,7 +353,7 @@ static ImageDecoder findDecoder( const Mat& buf )
     for( i = 0; i < codecs.decoders.size(); i++ )
     {
         if( codecs.decoders[i]->checkSignature(signature) )
-            return codecs.decoders[i]->newDecoder();
+            return newDecoder(i, cache);
     }
 
     return ImageDecoder();
@@ -412,7 +457,7 @@ static void ApplyExifOrientation(ExifEntry_t orientationTag, OutputArray img)
  *
 */
 static bool
-imread_( const String& filename, int flags, OutputArray mat )
+imread_( const String& filename, int flags, OutputArray mat, std::vector<ImageDecoder>* cache = NULL )
 {
     /// Search for the relevant decoder to handle the imagery
     ImageDecoder decoder;
@@ -422,7 +467,7 @@ imread_( const String& filename, int flags, OutputArray mat )
         decoder = GdalDecoder().newDecoder();
     }else{
 #endif
-        decoder = findDecoder( filename );
+        decoder = findDecoder( filename, cache );
 #ifdef HAVE_GDAL
     }
 #endif
@@ -479,8 +524,9 @@ imread_( const String& filename, int flags, OutputArray mat )
     // grab the decoded type
     const int type = calcType(decoder->type(), flags);
 
-    if (mat.empty())
+    if (mat.empty() || cache)
     {
+        // batch reading reuses the output if it matches and reallocates it otherwise
         mat.create( size.height, size.width, type );
     }
     else
@@ -530,6 +576,89 @@ imread_( const String& filename, int flags, OutputArray mat )
     return true;
 }
 
+static void
+resizeRegion_( const Mat& src, const Size& dsize, Mat& dst )
+{
+    if( src.size() == dsize )
+        src.copyTo(dst);
+    else
+        resize(src, dst, dsize, 0, 0,
+               dsize.width <= src.cols && dsize.height <= src.rows ? INTER_AREA : INTER_LINEAR);
+}
+
+/**
+ * Decode a region of the image, resized to the given size
+ *
+ * Decoders supporting setDecodeRegion() skip the data outside of the region and use the cheapest
+ * reduced resolution they can produce; the rest decode the whole image.
+ *
+ * @param[in] decoder Decoder with the source set
+ * @param[in] flags Flags
+ * @param[in] roi Region of the image, empty for the whole image
+ * @param[in] dsize Output size, empty for the size of the region
+ * @param[out] mat The decoded region
+*/
+static bool
+decodeRegion_( const ImageDecoder& decoder, int flags, const Rect& roi, const Size& dsize, Mat& mat )
+{
+    try
+    {
+        if( !decoder->readHeader() )
+            return false;
+    }
+    catch (const cv::Exception& e)
+    {
+        CV_LOG_ERROR(NULL, "decodeRegion_: can't read header: " << e.what());
+        return false;
+    }
+    catch (...)
+    {
+        CV_LOG_ERROR(NULL, "decodeRegion_: can't read header: unknown exception");
+        return false;
+    }
+
+    Size size = validateInputImageSize(Size(decoder->width(), decoder->height()));
+    Rect region = roi.empty() ? Rect(Point(), size) : roi;
+    CV_Assert((region & Rect(Point(), size)) == region);
+    Size outSize = dsize.empty() ? region.size() : dsize;
+    const int type = calcType(decoder->type(), flags);
+
+    Mat buf;
+    Mat* dst = &buf;
+    bool success = false;
+    try
+    {
+        Size decSize(std::min(outSize.width, region.width), std::min(outSize.height, region.height));
+        bool partial = decoder->setDecodeRegion(region, decSize);
+        if( !partial )
+            decSize = size;
+        else if( decSize == outSize )
+            dst = &mat; // decode straight into the output
+        dst->create(decSize, type);
+        success = decoder->readData(*dst);
+        if( success && dst != &mat )
+            resizeRegion_(partial ? buf : buf(region), outSize, mat);
+    }
+    catch (const cv::Exception& e)
+    {
+        CV_LOG_ERROR(NULL, "decodeRegion_: can't read data: " << e.what());
+    }
+    catch (...)
+    {
+        CV_LOG_ERROR(NULL, "decodeRegion_: can't read data: unknown exception");
+    }
+    if( !success )
+        return false;
+
+    /// optionally rotate the data if EXIF orientation flag says so
+    if( (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
+    {
+        ApplyExifOrientation(decoder->getExifTag(ORIENTATION), mat);
+    }
+
+    return true;
+}
+
 
 static bool
 imreadmulti_(const String& filename, int flags, std::vector<Mat>& mats, int start, int count)
@@ -668,6 +797,56 @@ void imread( const String& filename, OutputArray dst, int flags )
     imread_(filename, flags, dst);
 }
 
+int imreadBatch( const std::vector<String>& filenames, std::vector<Mat>& mats, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    const int n = (int)filenames.size();
+    mats.resize(n);
+
+    TLSData<std::vector<ImageDecoder> >& decoders = getDecoderCacheTLS();
+    parallel_for_(Range(0, n), [&](const Range& range)
+    {
+        std::vector<ImageDecoder>& cache = decoders.getRef();
+        for (int i = range.start; i < range.end; i++)
+        {
+            try
+            {
+                imread_(filenames[i], flags, mats[i], &cache);
+            }
+            catch (const std::exception& e)
+            {
+                CV_LOG_ERROR(NULL, "imreadBatch('" << filenames[i] << "'): " << e.what());
+                mats[i].release();
+            }
+        }
+        releaseDecoderSources(cache);
+    }, n);
+
+    int count = 0;
+    for (int i = 0; i < n; i++)
+        count += !mats[i].empty();
+    return count;
+}
+
+Mat imreadRegion( const String& filename, const Rect& roi, const Size& dsize, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat img;
+    ImageDecoder decoder = findDecoder(filename);
+    if( !decoder )
+        return img;
+
+    if( flags & IMREAD_COLOR_RGB && flags != IMREAD_UNCHANGED )
+        decoder->setRGB(true);
+    decoder->setSource(filename);
+
+    if( !decodeRegion_(decoder, flags, roi, dsize, img) )
+        img.release();
+    return img;
+}
+
 /**
 * Read a multi-page image
 *
@@ -988,7 +1167,7 @@ bool imwriteanimation(const String& filename, const Animation& animation, const
 }
 
 static bool
-imdecode_( const Mat& buf, int flags, Mat& mat )
+imdecode_( const Mat& buf, int flags, Mat& mat, std::vector<ImageDecoder>* cache = NULL, bool keepDst = false )
 {
     CV_Assert(!buf.empty());
     CV_Assert(buf.isContinuous());
@@ -997,7 +1176,7 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
 
     String filename;
 
-    ImageDecoder decoder = findDecoder(buf_row);
+    ImageDecoder decoder = findDecoder(buf_row, cache);
     if( !decoder )
         return false;
 
@@ -1072,12 +1251,40 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
 
     const int type = calcType(decoder->type(), flags);
 
-    mat.create( size.height, size.width, type );
+    // JpegDecoder applies scale_denom in readHeader() and returns 1 here, other decoders need the resize
+    const bool reduce = decoder->setScale( scale_denom ) > 1;
+    // size of the result before the EXIF orientation is applied
+    const Size dstSize = reduce ? Size( size.width / scale_denom, size.height / scale_denom ) : size;
+    const bool applyOrientation = (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED;
+
+    // A kept output must have the shape of the result, the orientation may transpose it (checked again below)
+    if (keepDst && (mat.type() != type ||
+        (mat.size() != dstSize && (!applyOrientation || mat.size() != Size(dstSize.height, dstSize.width)))))
+    {
+        CV_LOG_ERROR(NULL, "imdecode_('" << filename << "'): the preallocated output " << mat.size() << " of type "
+                     << typeToString(mat.type()) << " does not match the decoded image " << dstSize << " of type "
+                     << typeToString(type));
+        if (!filename.empty())
+        {
+            if (0 != remove(filename.c_str()))
+            {
+                CV_LOG_WARNING(NULL, "unable to remove temporary file: " << filename);
+            }
+        }
+        return false;
+    }
+
+    // Decode straight into the output if it has the right shape. A kept output that does not
+    // (e.g. it is a strided view or it expects the EXIF-rotated shape) receives the final result by copy.
+    Mat img;
+    if (!keepDst || (!reduce && mat.size() == size && mat.type() == type && mat.isContinuous()))
+        img = mat;
+    img.create( size.height, size.width, type );
 
     success = false;
     try
     {
-        if (decoder->readData(mat))
+        if (decoder->readData(img))
             success = true;
     }
     catch (const cv::Exception& e)
@@ -1102,16 +1309,29 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
         return false;
     }
 
-    if( decoder->setScale( scale_denom ) > 1 ) // if decoder is JpegDecoder then decoder->setScale always returns 1
+    if( reduce )
     {
-        resize(mat, mat, Size( size.width / scale_denom, size.height / scale_denom ), 0, 0, INTER_LINEAR_EXACT);
+        resize(img, img, dstSize, 0, 0, INTER_LINEAR_EXACT);
     }
 
     /// optionally rotate the data if EXIF' orientation flag says so
-    if (!mat.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED)
+    if (!img.empty() && applyOrientation)
     {
-        ApplyExifOrientation(decoder->getExifTag(ORIENTATION), mat);
+        ApplyExifOrientation(decoder->getExifTag(ORIENTATION), img);
+    }
+
+    if (keepDst && img.data != mat.data)
+    {
+        if (img.size() != mat.size())
+        {
+            CV_LOG_ERROR(NULL, "imdecode_('" << filename << "'): the preallocated output " << mat.size()
+                         << " does not match the oriented image " << img.size());
+            return false;
+        }
+        img.copyTo(mat);
     }
+    else
+        mat = img;
 
     return true;
 }
@@ -1140,6 +1360,122 @@ Mat imdecode( InputArray _buf, int flags, Mat* dst )
         return cv::Mat();
 }
 
+Mat imdecodeRegion( InputArray _buf, const Rect& roi, const Size& dsize, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat(), img;
+    CV_Assert(!buf.empty());
+    CV_Assert(buf.isContinuous());
+    CV_Assert(buf.checkVector(1, CV_8U) > 0);
+    Mat buf_row = buf.reshape(1, 1);
+
+    ImageDecoder decoder = findDecoder(buf_row);
+    if( !decoder )
+        return img;
+
+    if( flags & IMREAD_COLOR_RGB && flags != IMREAD_UNCHANGED )
+        decoder->setRGB(true);
+
+    // the codec cannot read from memory, decode the region from a temporary file
+    String filename;
+    if( !decoder->setSource(buf_row) )
+    {
+        filename = tempfile();
+        FILE* f = fopen( filename.c_str(), "wb" );
+        if( !f )
+            return img;
+        size_t bufSize = buf_row.total()*buf.elemSize();
+        if (fwrite(buf_row.ptr(), 1, bufSize, f) != bufSize)
+        {
+            fclose( f );
+            CV_Error( Error::StsError, "failed to write image data to temporary file" );
+        }
+        if( fclose(f) != 0 )
+        {
+            CV_Error( Error::StsError, "failed to write image data to temporary file" );
+        }
+        decoder->setSource(filename);
+    }
+
+    bool success = false;
+    try
+    {
+        success = decodeRegion_(decoder, flags, roi, dsize, img);
+    }
+    catch (...)
+    {
+        decoder.release();
+        if( !filename.empty() )
+            remove(filename.c_str());
+        throw;
+    }
+    if( !success )
+        img.release();
+
+    decoder.release();
+    if( !filename.empty() && 0 != remove(filename.c_str()) )
+    {
+        CV_LOG_WARNING(NULL, "unable to remove temporary file:" << filename);
+    }
+    return img;
+}
+
+bool imdecode( InputArray _buf, int flags, InputOutputArray _dst )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat();
+    if (_dst.isMat())
+    {
+        Mat& dst = _dst.getMatRef();
+        return imdecode_(buf, flags, dst, NULL, !dst.empty());
+    }
+
+    Mat img;
+    if (!_dst.empty())
+        img.create(_dst.size(), _dst.type());
+    if (!imdecode_(buf, flags, img, NULL, !img.empty()))
+        return false;
+    img.copyTo(_dst);
+    return true;
+}
+
+int imdecodeBatch( InputArrayOfArrays bufs, std::vector<Mat>& mats, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    const int n = (int)bufs.total();
+    mats.resize(n);
+
+    TLSData<std::vector<ImageDecoder> >& decoders = getDecoderCacheTLS();
+    parallel_for_(Range(0, n), [&](const Range& range)
+    {
+        std::vector<ImageDecoder>& cache = decoders.getRef();
+        for (int i = range.start; i < range.end; i++)
+        {
+            bool success = false;
+            try
+            {
+                Mat buf = bufs.getMat(i);
+                success = !buf.empty() && imdecode_(buf, flags, mats[i], &cache);
+            }
+            catch (const std::exception& e)
+            {
+                CV_LOG_ERROR(NULL, "imdecodeBatch(" << i << "): " << e.what());
+            }
+            if (!success)
+                mats[i].release();
+        }
+        releaseDecoderSources(cache);
+    }, n);
+
+    int count = 0;
+    for (int i = 0; i < n; i++)
+        count += !mats[i].empty();
+    return count;
+}
+
 static bool
 imdecodemulti_(const Mat& buf, int flags, std::vector<Mat>& mats, int start, int count)
 {
@@ -289,6 +289,92 @@ INSTANTIATE_TEST_CASE_P( /* nothing */,
                             testing::Values(70, 95, 100),    // IMWRITE_JPEG_LUMA_QUALITY
                             testing::Values(70, 95, 100) )); // IMWRITE_JPEG_CHROMA_QUALITY
 
+TEST(Imgcodecs_Jpeg, decode_region)
+{
+    Mat src(480, 640, CV_8UC3);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            src.at<Vec3b>(y, x) = Vec3b((uchar)(x*255/src.cols), (uchar)(y*255/src.rows), (uchar)((x + y)/5));
+    std::vector<uchar> buf;
+    ASSERT_TRUE(imencode(".jpg", src, buf));
+    const Mat full = imdecode(buf, IMREAD_COLOR);
+    ASSERT_FALSE(full.empty());
+
+    // the region at the full resolution, not aligned to the MCU grid
+    const Rect roi(101, 37, 301, 200);
+    Mat region = imdecodeRegion(buf, roi);
+    ASSERT_EQ(roi.size(), region.size());
+    EXPECT_LE(cvtest::norm(full(roi), region, NORM_INF), 2);
+
+    // DCT-domain downscaling by 2, aligned region
+    const Mat full2 = imdecode(buf, IMREAD_REDUCED_COLOR_2);
+    region = imdecodeRegion(buf, Rect(96, 32, 320, 208), Size(160, 104));
+    ASSERT_EQ(Size(160, 104), region.size());
+    EXPECT_LE(cvtest::norm(full2(Rect(48, 16, 160, 104)), region, NORM_INF), 2);
+
+    // arbitrary output size
+    Mat gray = imdecode(buf, IMREAD_GRAYSCALE), ref;
+    resize(gray(roi), ref, Size(70, 45), 0, 0, INTER_AREA);
+    region = imdecodeRegion(buf, roi, Size(70, 45), IMREAD_GRAYSCALE);
+    ASSERT_EQ(CV_8UC1, region.type());
+    ASSERT_EQ(ref.size(), region.size());
+    EXPECT_LE(cvtest::norm(ref, region, NORM_L1) / ref.total(), 2);
+
+    string filename = cv::tempfile(".jpg");
+    ASSERT_TRUE(imwrite(filename, src));
+    Mat fromFile = imreadRegion(filename, roi, Size(70, 45), IMREAD_GRAYSCALE);
+    EXPECT_EQ(0, remove(filename.c_str()));
+    ASSERT_EQ(region.size(), fromFile.size());
+    EXPECT_EQ(0, cvtest::norm(region, fromFile, NORM_INF));
+
+    EXPECT_ANY_THROW(imdecodeRegion(buf, Rect(600, 0, 100, 10)));
+}
+
+TEST(Imgcodecs_Jpeg, encode_parallel_bands)
+{
+    Mat src(700, 1003, CV_8UC3);
+    randu(src, 0, 32);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            src.at<Vec3b>(y, x) += Vec3b((uchar)(x*200/src.cols), (uchar)(y*200/src.rows), (uchar)((x + y)/8));
+    Mat gray;
+    cvtColor(src, gray, COLOR_BGR2GRAY);
+
+    const int samplings[] = { IMWRITE_JPEG_SAMPLING_FACTOR_420, IMWRITE_JPEG_SAMPLING_FACTOR_444, IMWRITE_JPEG_SAMPLING_FACTOR_411 };
+    for (int k = 0; k < 4; k++)
+    {
+        SCOPED_TRACE(k);
+        const Mat& img = k < 3 ? src : gray;
+        std::vector<int> params = { IMWRITE_JPEG_QUALITY, 90 };
+        if (k < 3)
+        {
+            params.push_back(IMWRITE_JPEG_SAMPLING_FACTOR);
+            params.push_back(samplings[k]);
+        }
+        std::vector<uchar> serial, parallel;
+        ASSERT_TRUE(imencode(".jpg", img, serial, params));
+        params.push_back(IMWRITE_JPEG_THREADS);
+        params.push_back(4);
+        ASSERT_TRUE(imencode(".jpg", img, parallel, params));
+        EXPECT_NE(serial, parallel);
+
+        // the bands have the same coefficients as the whole image
+        Mat expected = imdecode(serial, IMREAD_UNCHANGED), actual = imdecode(parallel, IMREAD_UNCHANGED);
+        ASSERT_EQ(expected.size(), actual.size());
+        ASSERT_EQ(expected.type(), actual.type());
+        EXPECT_EQ(0, cvtest::norm(expected, actual, NORM_INF));
+    }
+
+    std::vector<uchar> serial;
+    ASSERT_TRUE(imencode(".jpg", src, serial));
+    string filename = cv::tempfile(".jpg");
+    ASSERT_TRUE(imwrite(filename, src, { IMWRITE_JPEG_THREADS, -1 }));
+    Mat fromFile = imread(filename);
+    EXPECT_EQ(0, remove(filename.c_str()));
+    ASSERT_EQ(src.size(), fromFile.size());
+    EXPECT_EQ(0, cvtest::norm(imdecode(serial, IMREAD_COLOR), fromFile, NORM_INF));
+}
+
 #endif // HAVE_JPEG
 
 }} // namespace
@@ -327,6 +327,42 @@ const string pngsuite_files_corrupted[] = {
 INSTANTIATE_TEST_CASE_P(/*nothing*/, Imgcodecs_Png_PngSuite_Corrupted,
                         testing::ValuesIn(pngsuite_files_corrupted));
 
+TEST(Imgcodecs_Png, encode_parallel)
+{
+    const int types[] = { CV_8UC3, CV_8UC1, CV_16UC4 };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        Mat img(301, 517, types[t]);
+        randu(img, 0, 8);
+        img(Rect(0, 0, 517, 150)) += Scalar(10, 20, 30, 40);
+        for (int compression = -1; compression <= 9; compression += 7)
+        {
+            SCOPED_TRACE(cv::format("type=%d compression=%d", types[t], compression));
+            std::vector<int> params = { IMWRITE_PNG_THREADS, 4 };
+            if (compression >= 0)
+            {
+                params.push_back(IMWRITE_PNG_COMPRESSION);
+                params.push_back(compression);
+            }
+            std::vector<uchar> buf;
+            ASSERT_TRUE(imencode(".png", img, buf, params));
+            Mat decoded = imdecode(buf, IMREAD_UNCHANGED);
+            ASSERT_EQ(img.size(), decoded.size());
+            ASSERT_EQ(img.type(), decoded.type());
+            EXPECT_EQ(0, cvtest::norm(img, decoded, NORM_INF));
+        }
+    }
+
+    Mat img(64, 48, CV_8UC3);
+    randu(img, 0, 255);
+    string filename = cv::tempfile(".png");
+    ASSERT_TRUE(imwrite(filename, img, { IMWRITE_PNG_THREADS, -1 }));
+    Mat fromFile = imread(filename);
+    EXPECT_EQ(0, remove(filename.c_str()));
+    ASSERT_EQ(img.size(), fromFile.size());
+    EXPECT_EQ(0, cvtest::norm(img, fromFile, NORM_INF));
+}
+
 #endif // HAVE_PNG
 
 }} // namespace
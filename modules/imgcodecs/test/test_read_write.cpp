@@ -329,6 +329,139 @@ TEST(Imgcodecs_Image, imread_overload)
     }
 }
 
+TEST(Imgcodecs_Image, imdecode_into_preallocated)
+{
+    std::vector<string> extensions;
+    extensions.push_back(".bmp");
+#if defined(HAVE_PNG) || defined(HAVE_SPNG)
+    extensions.push_back(".png");
+#endif
+#ifdef HAVE_JPEG
+    extensions.push_back(".jpg");
+#endif
+#ifdef HAVE_WEBP
+    extensions.push_back(".webp");
+#endif
+
+    Mat src(60, 80, CV_8UC4);
+    RNG rng(123);
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+    for (size_t i = 0; i < extensions.size(); i++)
+    {
+        SCOPED_TRACE(extensions[i]);
+        std::vector<uchar> buf;
+        ASSERT_TRUE(imencode(extensions[i], src, buf));
+        for (int flags = IMREAD_GRAYSCALE; flags <= IMREAD_COLOR; flags++)
+        {
+            const Mat ref = imdecode(buf, flags);
+            ASSERT_FALSE(ref.empty());
+
+            // continuous user memory is decoded into directly
+            std::vector<uchar> storage(ref.total()*ref.elemSize());
+            Mat dst(ref.size(), ref.type(), storage.data());
+            ASSERT_TRUE(imdecode(buf, flags, dst));
+            EXPECT_EQ((void*)storage.data(), (void*)dst.data);
+            EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+            // a strided view of a larger buffer is filled without touching the rest
+            Mat big(ref.rows + 10, ref.cols + 20, ref.type(), Scalar::all(7));
+            Mat view = big(Rect(5, 3, ref.cols, ref.rows));
+            ASSERT_TRUE(imdecode(buf, flags, view));
+            EXPECT_EQ(big.ptr(3, 5), view.data);
+            EXPECT_EQ(0, cvtest::norm(ref, view, NORM_INF));
+            view.setTo(Scalar::all(7));
+            EXPECT_EQ(0, cvtest::norm(big, Mat(big.size(), big.type(), Scalar::all(7)), NORM_INF));
+
+            // empty output is allocated, mismatching one is rejected
+            Mat empty;
+            ASSERT_TRUE(imdecode(buf, flags, empty));
+            EXPECT_EQ(0, cvtest::norm(ref, empty, NORM_INF));
+            Mat wrong(ref.rows + 1, ref.cols, ref.type());
+            const uchar* wrongData = wrong.data;
+            EXPECT_FALSE(imdecode(buf, flags, wrong));
+            EXPECT_EQ(wrongData, wrong.data);
+            Mat wrongType(ref.size(), CV_MAKETYPE(CV_16U, ref.channels()));
+            EXPECT_FALSE(imdecode(buf, flags, wrongType));
+        }
+
+        // the reduced size is expected with IMREAD_REDUCED_*
+        const Mat reduced = imdecode(buf, IMREAD_REDUCED_COLOR_2);
+        ASSERT_FALSE(reduced.empty());
+        ASSERT_EQ(Size(src.cols / 2, src.rows / 2), reduced.size());
+        Mat dst(reduced.size(), reduced.type());
+        const uchar* data = dst.data;
+        ASSERT_TRUE(imdecode(buf, IMREAD_REDUCED_COLOR_2, dst));
+        EXPECT_EQ(data, dst.data);
+        EXPECT_EQ(0, cvtest::norm(reduced, dst, NORM_INF));
+        Mat full(src.size(), reduced.type());
+        EXPECT_FALSE(imdecode(buf, IMREAD_REDUCED_COLOR_2, full));
+    }
+}
+
+TEST(Imgcodecs_Image, batch_decoding)
+{
+    std::vector<string> extensions;
+    extensions.push_back(".bmp");
+#ifdef HAVE_JPEG
+    extensions.push_back(".jpg");
+#endif
+#if defined(HAVE_PNG) || defined(HAVE_SPNG)
+    extensions.push_back(".png");
+#endif
+#ifdef HAVE_WEBP
+    extensions.push_back(".webp");
+#endif
+
+    RNG rng(12345);
+    std::vector<std::vector<uchar> > bufs;
+    std::vector<string> filenames;
+    for (int i = 0; i < 12; i++)
+    {
+        Mat img(32 + i*7, 48 + i*5, CV_8UC3);
+        rng.fill(img, RNG::UNIFORM, 0, 256);
+        const string& ext = extensions[i % extensions.size()];
+        std::vector<uchar> buf;
+        ASSERT_TRUE(imencode(ext, img, buf));
+        bufs.push_back(buf);
+        filenames.push_back(cv::tempfile(ext.c_str()));
+        ASSERT_TRUE(imwrite(filenames.back(), img));
+    }
+    bufs.push_back(std::vector<uchar>(100, 0)); // not an image
+    filenames.push_back(cv::tempfile(".bmp")); // does not exist
+
+    for (int flags = IMREAD_GRAYSCALE; flags <= IMREAD_COLOR; flags++)
+    {
+        SCOPED_TRACE(flags);
+        std::vector<Mat> decoded(bufs.size()), loaded;
+        // preallocated outputs: the matching one must be reused, the other one reallocated
+        decoded[0] = imdecode(bufs[0], flags);
+        decoded[1].create(1, 1, CV_8UC1);
+        decoded.back().create(8, 8, CV_8UC1);
+        const uchar* ptr0 = decoded[0].data;
+
+        EXPECT_EQ((int)bufs.size() - 1, imdecodeBatch(bufs, decoded, flags));
+        EXPECT_EQ((int)filenames.size() - 1, imreadBatch(filenames, loaded, flags));
+        ASSERT_EQ(bufs.size(), decoded.size());
+        ASSERT_EQ(filenames.size(), loaded.size());
+        EXPECT_EQ(ptr0, decoded[0].data);
+        EXPECT_TRUE(decoded.back().empty());
+        EXPECT_TRUE(loaded.back().empty());
+
+        for (size_t i = 0; i + 1 < bufs.size(); i++)
+        {
+            Mat ref = imdecode(bufs[i], flags);
+            ASSERT_FALSE(ref.empty());
+            ASSERT_EQ(ref.size(), decoded[i].size());
+            ASSERT_EQ(ref.size(), loaded[i].size());
+            EXPECT_EQ(cv::norm(ref, decoded[i], NORM_INF), 0);
+            EXPECT_EQ(cv::norm(ref, loaded[i], NORM_INF), 0);
+        }
+    }
+
+    for (size_t i = 0; i + 1 < filenames.size(); i++)
+        EXPECT_EQ(0, remove(filenames[i].c_str()));
+}
+
 //==================================================================================================
 
 TEST(Imgcodecs_Image, write_umat)
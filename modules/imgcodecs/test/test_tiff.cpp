@@ -1300,6 +1300,172 @@ TEST(Imgcodecs_Tiff, read_bigtiff_images)
     }
 }
 
+TEST(Imgcodecs_Tiff, decode_region_strips)
+{
+    const int types[] = { CV_8UC3, CV_8UC1, CV_16UC3, CV_32FC1 };
+    const Rect rois[] = { Rect(0, 0, 301, 257), Rect(37, 5, 100, 40), Rect(0, 100, 301, 16), Rect(300, 256, 1, 1) };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        SCOPED_TRACE(cv::format("type=%d", types[t]));
+        Mat img(257, 301, types[t]);
+        randu(img, 0, 255);
+        std::vector<uchar> buf;
+        ASSERT_TRUE(imencode(".tiff", img, buf, { IMWRITE_TIFF_ROWSPERSTRIP, 16 }));
+
+        Mat full = imdecode(buf, IMREAD_UNCHANGED);
+        ASSERT_EQ(img.size(), full.size());
+        ASSERT_EQ(img.type(), full.type());
+        EXPECT_EQ(0, cvtest::norm(img, full, NORM_INF));
+
+        for (size_t r = 0; r < sizeof(rois) / sizeof(rois[0]); r++)
+        {
+            SCOPED_TRACE(rois[r]);
+            Mat region = imdecodeRegion(buf, rois[r], Size(), IMREAD_UNCHANGED);
+            ASSERT_EQ(rois[r].size(), region.size());
+            ASSERT_EQ(img.type(), region.type());
+            EXPECT_EQ(0, cvtest::norm(img(rois[r]), region, NORM_INF));
+        }
+    }
+}
+
+// an uncompressed 8-bit grayscale image with a reduced-resolution level stored in a SubIFD
+static std::vector<uchar> makePyramidalTiff(const Mat& level0, const Mat& level1)
+{
+    const uint32_t ifd0 = 8, ifd1 = ifd0 + 2 + 10 * 12 + 4, data0 = ifd1 + 2 + 10 * 12 + 4;
+    const uint32_t data1 = data0 + (uint32_t)level0.total();
+    std::vector<uchar> buf;
+    auto put16 = [&](uint32_t v) { buf.push_back((uchar)v); buf.push_back((uchar)(v >> 8)); };
+    auto put32 = [&](uint32_t v) { put16(v & 0xffff); put16(v >> 16); };
+    auto entry = [&](uint32_t tag, uint32_t type, uint32_t value) { put16(tag); put16(type); put32(1); put32(value); };
+    auto ifd = [&](const Mat& level, uint32_t data, bool reduced, uint32_t subifd)
+    {
+        put16(10);
+        if (reduced)
+            entry(254, 4, 1);  // NewSubfileType: reduced-resolution image
+        entry(256, 4, level.cols);
+        entry(257, 4, level.rows);
+        entry(258, 3, 8);  // BitsPerSample
+        entry(259, 3, 1);  // Compression: none
+        entry(262, 3, 1);  // Photometric: BlackIsZero
+        entry(273, 4, data);  // StripOffsets
+        entry(277, 3, 1);  // SamplesPerPixel
+        entry(278, 4, level.rows);  // RowsPerStrip
+        entry(279, 4, (uint32_t)level.total());  // StripByteCounts
+        if (!reduced)
+            entry(330, 4, subifd);  // SubIFDs
+        put32(0);
+    };
+    buf.push_back('I'); buf.push_back('I'); put16(42); put32(ifd0);
+    ifd(level0, data0, false, ifd1);
+    ifd(level1, data1, true, 0);
+    CV_Assert(buf.size() == data0 && level0.isContinuous() && level1.isContinuous());
+    buf.insert(buf.end(), level0.data, level0.data + level0.total());
+    buf.insert(buf.end(), level1.data, level1.data + level1.total());
+    return buf;
+}
+
+TEST(Imgcodecs_Tiff, decode_region_pyramid_level)
+{
+    Mat level0(48, 64, CV_8UC1), level1(24, 32, CV_8UC1);
+    randu(level0, 0, 255);
+    randu(level1, 0, 255);
+    const std::vector<uchar> buf = makePyramidalTiff(level0, level1);
+
+    Mat full = imdecode(buf, IMREAD_GRAYSCALE);
+    ASSERT_EQ(level0.size(), full.size());
+    EXPECT_EQ(0, cvtest::norm(level0, full, NORM_INF));
+
+    const Rect roi(16, 8, 32, 24);
+    Mat region = imdecodeRegion(buf, roi, Size(), IMREAD_GRAYSCALE);
+    ASSERT_EQ(roi.size(), region.size());
+    EXPECT_EQ(0, cvtest::norm(level0(roi), region, NORM_INF));
+
+    // the half size is read from the reduced-resolution level
+    Mat reduced = imdecodeRegion(buf, roi, Size(16, 12), IMREAD_GRAYSCALE);
+    ASSERT_EQ(Size(16, 12), reduced.size());
+    EXPECT_EQ(0, cvtest::norm(level1(Rect(8, 4, 16, 12)), reduced, NORM_INF));
+}
+
+// an uncompressed single-channel 8-bit or 16-bit tiled image, the encoder writes strips only
+static std::vector<uchar> makeTiledTiff(const Mat& img, int tileWidth, int tileHeight)
+{
+    CV_Assert(img.channels() == 1 && (img.depth() == CV_8U || img.depth() == CV_16U));
+    const uint32_t tilesX = (img.cols + tileWidth - 1) / tileWidth, tilesY = (img.rows + tileHeight - 1) / tileHeight;
+    const uint32_t ntiles = tilesX * tilesY, tileBytes = (uint32_t)(tileWidth * tileHeight * img.elemSize());
+    const uint32_t ifd = 8, offsets = ifd + 2 + 10 * 12 + 4, counts = offsets + 4 * ntiles, data = counts + 4 * ntiles;
+    std::vector<uchar> buf;
+    auto put16 = [&](uint32_t v) { buf.push_back((uchar)v); buf.push_back((uchar)(v >> 8)); };
+    auto put32 = [&](uint32_t v) { put16(v & 0xffff); put16(v >> 16); };
+    auto entry = [&](uint32_t tag, uint32_t type, uint32_t count, uint32_t value) { put16(tag); put16(type); put32(count); put32(value); };
+    buf.push_back('I'); buf.push_back('I'); put16(42); put32(ifd);
+    put16(10);
+    entry(256, 4, 1, img.cols);
+    entry(257, 4, 1, img.rows);
+    entry(258, 3, 1, (uint32_t)img.elemSize() * 8);  // BitsPerSample
+    entry(259, 3, 1, 1);  // Compression: none
+    entry(262, 3, 1, 1);  // Photometric: BlackIsZero
+    entry(277, 3, 1, 1);  // SamplesPerPixel
+    entry(322, 4, 1, tileWidth);  // TileWidth
+    entry(323, 4, 1, tileHeight);  // TileLength
+    entry(324, 4, ntiles, offsets);  // TileOffsets
+    entry(325, 4, ntiles, counts);  // TileByteCounts
+    put32(0);
+    for (uint32_t i = 0; i < ntiles; i++)
+        put32(data + i * tileBytes);
+    for (uint32_t i = 0; i < ntiles; i++)
+        put32(tileBytes);
+    CV_Assert(buf.size() == data);
+    // the tiles on the right and bottom edges are padded with zeros
+    for (uint32_t ty = 0; ty < tilesY; ty++)
+        for (uint32_t tx = 0; tx < tilesX; tx++)
+        {
+            Mat tile = Mat::zeros(tileHeight, tileWidth, img.type());
+            Rect r = Rect(tx * tileWidth, ty * tileHeight, tileWidth, tileHeight) & Rect(Point(), img.size());
+            img(r).copyTo(tile(Rect(Point(), r.size())));
+            buf.insert(buf.end(), tile.data, tile.data + tileBytes);
+        }
+    return buf;
+}
+
+TEST(Imgcodecs_Tiff, decode_region_tiles)
+{
+    // partial tiles on the right and bottom edges; the large image is decoded in parallel
+    const Size sizes[] = { Size(80, 56), Size(530, 517) };
+    const int types[] = { CV_8UC1, CV_16UC1 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        const Size size = sizes[s];
+        SCOPED_TRACE(cv::format("type=%d size=%dx%d", types[t], size.width, size.height));
+        Mat img(size, types[t]);
+        randu(img, 0, types[t] == CV_8UC1 ? 256 : 65536);
+        // libtiff rejects uncompressed tiles smaller than its 1KB read buffer in TIFFReadRGBATile()
+        const std::vector<uchar> buf = makeTiledTiff(img, 32, 32);
+
+        Mat full = imdecode(buf, IMREAD_UNCHANGED);
+        ASSERT_EQ(img.size(), full.size());
+        ASSERT_EQ(img.type(), full.type());
+        EXPECT_EQ(0, cvtest::norm(img, full, NORM_INF));
+
+        const int w = size.width, h = size.height;
+        const Rect rois[] = {
+            Rect(0, 0, w, h),
+            Rect(5, 3, 30, 13),                // inside the first tiles
+            Rect(w / 2 + 7, h / 2 + 3, w - w / 2 - 7, h - h / 2 - 3),  // up to the partial tiles
+            Rect(w - 10, h - 6, 10, 6),        // the partial corner tile only
+            Rect(17, h - 5, w - 30, 5)         // the partial bottom row of tiles
+        };
+        for (size_t r = 0; r < sizeof(rois) / sizeof(rois[0]); r++)
+        {
+            SCOPED_TRACE(rois[r]);
+            Mat region = imdecodeRegion(buf, rois[r], Size(), IMREAD_UNCHANGED);
+            ASSERT_EQ(rois[r].size(), region.size());
+            ASSERT_EQ(img.type(), region.type());
+            EXPECT_EQ(0, cvtest::norm(img(rois[r]), region, NORM_INF));
+        }
+    }
+}
+
 #endif
 
 }} // namespace
@@ -114,6 +114,42 @@ TEST(Imgcodecs_WebP, encode_decode_with_alpha_webp)
     EXPECT_EQ(512, img_webp_bgr.rows);
 }
 
+TEST(Imgcodecs_WebP, decode_region)
+{
+    Mat src(240, 320, CV_8UC3);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            src.at<Vec3b>(y, x) = Vec3b((uchar)(x*255/src.cols), (uchar)(y*255/src.rows), (uchar)((x + y)/3));
+
+    for (int quality = 80; quality <= 101; quality += 21) // lossy and lossless
+    {
+        SCOPED_TRACE(quality);
+        std::vector<int> params;
+        params.push_back(IMWRITE_WEBP_QUALITY);
+        params.push_back(quality);
+        std::vector<uchar> buf;
+        ASSERT_TRUE(imencode(".webp", src, buf, params));
+        const Mat full = imdecode(buf, IMREAD_COLOR);
+        ASSERT_FALSE(full.empty());
+        const double eps = quality > 100 ? 0 : 8; // lossy: chroma upsampling differs at the crop border
+
+        // even and odd offsets
+        const Rect rois[] = { Rect(40, 20, 200, 150), Rect(41, 21, 199, 150) };
+        for (size_t i = 0; i < sizeof(rois)/sizeof(rois[0]); i++)
+        {
+            Mat region = imdecodeRegion(buf, rois[i]);
+            ASSERT_EQ(rois[i].size(), region.size());
+            EXPECT_LE(cvtest::norm(full(rois[i]), region, NORM_INF), eps);
+
+            Mat ref;
+            resize(full(rois[i]), ref, Size(64, 48), 0, 0, INTER_AREA);
+            region = imdecodeRegion(buf, rois[i], Size(64, 48));
+            ASSERT_EQ(ref.size(), region.size());
+            EXPECT_LE(cvtest::norm(ref, region, NORM_L1) / ref.total(), 4);
+        }
+    }
+}
+
 #endif // HAVE_WEBP
 
 }} // namespace
@@ -294,6 +294,15 @@ enum InterpolationMasks {
        INTER_TAB_SIZE2 = INTER_TAB_SIZE * INTER_TAB_SIZE
      };
 
+/** \brief Memory layouts of the batches of images
+@sa resizeBatch, warpAffineBatch
+*/
+enum BatchLayout
+{
+    BATCH_NHWC = 0, ///< 4D array of size N x H x W x C: the images with interleaved channels, one after another
+    BATCH_NCHW = 1  ///< 4D array of size N x C x H x W: each image is stored as C separate planes
+};
+
 //! @} imgproc_transform
 
 //! @addtogroup imgproc_misc
@@ -1858,6 +1867,75 @@ CV_EXPORTS_W void Laplacian( InputArray src, OutputArray dst, int ddepth,
                              int ksize = 1, double scale = 1, double delta = 0,
                              int borderType = BORDER_DEFAULT );
 
+/** @brief Chain of filters and per-pixel operations applied in a single pass over the image.
+
+Stages are added with the add* methods and executed in the order of addition, each stage
+consumes the output of the previous one. Instead of producing a full intermediate image per stage,
+the pipeline streams small blocks of rows through all the stages, so the intermediate data stays in
+cache. The image is processed by horizontal bands in parallel; the bands overlap by the aperture
+of the filters.
+
+The result of every stage is the same as the one of the corresponding standalone function
+(#sepFilter2D, #filter2D, #GaussianBlur, #Sobel, #threshold, Mat::convertTo) applied to the whole
+image, up to the rounding of 8-bit Gaussian blur, which uses the floating-point kernel here.
+The source image is processed as if #BORDER_ISOLATED was specified.
+
+For example, the binary edge map of a color image:
+@code
+    Ptr<FilterPipeline> p = createFilterPipeline();
+    p->addGaussianBlur(Size(5, 5), 1.5);
+    p->addGradientMagnitude(3);
+    p->addThreshold(100, 255, THRESH_BINARY);
+    p->addConvertTo(CV_8U);
+    p->apply(img, edges);
+@endcode
+@sa createFilterPipeline
+ */
+class CV_EXPORTS_W FilterPipeline : public Algorithm
+{
+public:
+    //! Adds the separable linear filter stage, see #sepFilter2D
+    CV_WRAP virtual void addSepFilter2D(int ddepth, InputArray kernelX, InputArray kernelY,
+                                        Point anchor = Point(-1,-1), double delta = 0,
+                                        int borderType = BORDER_DEFAULT) = 0;
+    //! Adds the linear filter stage, see #filter2D
+    CV_WRAP virtual void addFilter2D(int ddepth, InputArray kernel, Point anchor = Point(-1,-1),
+                                     double delta = 0, int borderType = BORDER_DEFAULT) = 0;
+    //! Adds the Gaussian blur stage, see #GaussianBlur
+    CV_WRAP virtual void addGaussianBlur(Size ksize, double sigmaX, double sigmaY = 0,
+                                         int borderType = BORDER_DEFAULT) = 0;
+    //! Adds the image derivative stage, see #Sobel
+    CV_WRAP virtual void addSobel(int ddepth, int dx, int dy, int ksize = 3, double scale = 1,
+                                  double delta = 0, int borderType = BORDER_DEFAULT) = 0;
+    /** @brief Adds the gradient magnitude stage.
+
+    The stage computes the first x and y derivatives with the Sobel operator of the given aperture
+    and stores their magnitude (see #magnitude) as 32-bit floating-point values.
+     */
+    CV_WRAP virtual void addGradientMagnitude(int ksize = 3, int borderType = BORDER_DEFAULT) = 0;
+    //! Adds the fixed-level threshold stage, see #threshold. #THRESH_OTSU and #THRESH_TRIANGLE are not supported.
+    CV_WRAP virtual void addThreshold(double thresh, double maxval, int type) = 0;
+    //! Adds the depth conversion stage, see Mat::convertTo
+    CV_WRAP virtual void addConvertTo(int ddepth, double alpha = 1, double beta = 0) = 0;
+
+    /** @brief Applies the pipeline to the image.
+
+    @param src Source image.
+    @param dst Destination image of the same size and the same number of channels as src, the depth
+    is the one produced by the last stage.
+     */
+    CV_WRAP virtual void apply(InputArray src, OutputArray dst) = 0;
+
+    //! Returns the number of stages
+    CV_WRAP virtual int getNumStages() const = 0;
+    //! Removes all the stages
+    CV_WRAP virtual void clear() CV_OVERRIDE = 0;
+};
+
+/** @brief Creates an empty FilterPipeline object.
+ */
+CV_EXPORTS_W Ptr<FilterPipeline> createFilterPipeline();
+
 //! @} imgproc_filter
 
 //! @addtogroup imgproc_feature
@@ -2206,6 +2284,77 @@ CV_EXPORTS_W void HoughLinesP( InputArray image, OutputArray lines,
                                double rho, double theta, int threshold,
                                double minLineLength = 0, double maxLineGap = 0 );
 
+/** @brief Line detector that keeps its state between calls.
+
+The detector implements the standard and the probabilistic Hough transforms of #HoughLines and
+#HoughLinesP. It keeps the accumulators, the trigonometric tables and the point buffers between
+calls, so processing a sequence of frames of the same size does not reallocate them; only the output
+array is reallocated when the number of the detected lines changes. Detection can
+be restricted to a region of interest, the lines are still reported in the coordinates of the
+whole image.
+
+@sa createHoughLinesDetector
+ */
+class CV_EXPORTS_W HoughLinesDetector : public Algorithm
+{
+public:
+    /** @brief Finds lines with the standard Hough transform.
+
+    Without a region of interest the result is the same as of #HoughLines with zero srn and stn
+    and the default angle range.
+
+    @param image 8-bit, single-channel binary source image.
+    @param lines Output vector of lines, \f$(\rho, \theta)\f$ or \f$(\rho, \theta, \textrm{votes})\f$,
+    see #HoughLines. \f$\rho\f$ is measured from the top-left corner of the image, not of roi.
+    @param roi Optional region of interest. Only the non-zero pixels inside it vote.
+     */
+    CV_WRAP virtual void detect( InputArray image, OutputArray lines, Rect roi = Rect() ) = 0;
+
+    /** @brief Finds line segments with the probabilistic Hough transform.
+
+    The result is the same as of #HoughLinesP applied to image(roi), with the segments shifted by
+    roi.tl().
+
+    @param image 8-bit, single-channel binary source image.
+    @param lines Output vector of line segments \f$(x_1, y_1, x_2, y_2)\f$, see #HoughLinesP.
+    @param roi Optional region of interest.
+     */
+    CV_WRAP virtual void detectSegments( InputArray image, OutputArray lines, Rect roi = Rect() ) = 0;
+
+    CV_WRAP virtual void setThreshold( int threshold ) = 0;
+    CV_WRAP virtual int getThreshold() const = 0;
+
+    CV_WRAP virtual void setMinLineLength( double minLineLength ) = 0;
+    CV_WRAP virtual double getMinLineLength() const = 0;
+
+    CV_WRAP virtual void setMaxLineGap( double maxLineGap ) = 0;
+    CV_WRAP virtual double getMaxLineGap() const = 0;
+
+    /** @brief Enables parallel voting of the standard transform (enabled by default).
+
+    Every thread votes into its own accumulator, the accumulators are summed afterwards. The
+    result does not depend on the number of threads. The probabilistic transform removes the
+    points of every found segment before it processes the next point, so it always runs on one
+    thread.
+     */
+    CV_WRAP virtual void setParallelVoting( bool enabled ) = 0;
+    CV_WRAP virtual bool getParallelVoting() const = 0;
+};
+
+/** @brief Creates a HoughLinesDetector.
+
+@param rho Distance resolution of the accumulator in pixels.
+@param theta Angle resolution of the accumulator in radians.
+@param threshold %Accumulator threshold parameter, see #HoughLines and #HoughLinesP.
+@param minLineLength Minimum segment length, used by HoughLinesDetector::detectSegments.
+@param maxLineGap Maximum allowed gap between points on the same segment, used by
+HoughLinesDetector::detectSegments.
+ */
+CV_EXPORTS_W Ptr<HoughLinesDetector> createHoughLinesDetector( double rho = 1, double theta = CV_PI/180,
+                                                               int threshold = 100,
+                                                               double minLineLength = 0,
+                                                               double maxLineGap = 0 );
+
 /** @brief Finds lines in a set of points using the standard Hough transform.
 
 The function finds lines in a set of points using a modification of the Hough transform.
@@ -2453,6 +2602,56 @@ CV_EXPORTS_W void warpAffine( InputArray src, OutputArray dst,
                               int borderMode = BORDER_CONSTANT,
                               const Scalar& borderValue = Scalar());
 
+/** @brief Resizes a set of image regions to the same size and stores them in one batch.
+
+The function is equivalent to calling #resize for each region of interest and copying the results
+into consecutive images of dst, but it is much faster when there are many small regions, e.g. when
+the detections of an object detector are cropped and scaled to the input size of a network. The
+interpolation tables are computed once for all the regions of the same size, and the regions are
+processed in parallel instead of parallelizing each resize. The HAL and IPP implementations of resize
+are used the same way as by #resize; the OpenCL implementation is not used.
+
+If dst is already allocated with the proper size and depth (e.g. it is the input blob of a network),
+the images are written directly into it.
+
+@param src input image.
+@param rois regions of interest; each of them must lie inside src.
+@param dst output batch: a 4D single-channel array of the same depth as src, of size
+N x dsize.height x dsize.width x C for #BATCH_NHWC or N x C x dsize.height x dsize.width
+for #BATCH_NCHW, where N = rois.size() and C = src.channels().
+@param dsize size of each output image.
+@param interpolation interpolation method, see #InterpolationFlags.
+@param layout memory layout of dst, see #BatchLayout.
+
+@sa resize, warpAffineBatch
+ */
+CV_EXPORTS_W void resizeBatch( InputArray src, const std::vector<Rect>& rois, OutputArray dst,
+                               Size dsize, int interpolation = INTER_LINEAR,
+                               int layout = BATCH_NHWC );
+
+/** @brief Applies a set of affine transformations to an image and stores the results in one batch.
+
+The function is equivalent to calling #warpAffine with each of the matrices and copying the results
+into consecutive images of dst. The transformations are processed in parallel.
+
+@param src input image.
+@param M vector of \f$2\times 3\f$ transformation matrices.
+@param dst output batch, see #resizeBatch.
+@param dsize size of each output image.
+@param flags combination of interpolation methods and the optional flag #WARP_INVERSE_MAP, see
+#warpAffine.
+@param borderMode pixel extrapolation method, see #warpAffine.
+@param borderValue value used in case of a constant border; by default, it is 0.
+@param layout memory layout of dst, see #BatchLayout.
+
+@sa warpAffine, resizeBatch
+ */
+CV_EXPORTS_W void warpAffineBatch( InputArray src, InputArrayOfArrays M, OutputArray dst,
+                                   Size dsize, int flags = INTER_LINEAR,
+                                   int borderMode = BORDER_CONSTANT,
+                                   const Scalar& borderValue = Scalar(),
+                                   int layout = BATCH_NHWC );
+
 /** @example samples/cpp/warpPerspective_demo.cpp
 An example program shows using cv::getPerspectiveTransform and cv::warpPerspective for image warping
 */
@@ -2562,6 +2761,44 @@ CV_EXPORTS_W void convertMaps( InputArray map1, InputArray map2,
                                OutputArray dstmap1, OutputArray dstmap2,
                                int dstmap1type, bool nninterpolation = false );
 
+/** @brief Remapping with maps that are prepared once and reused for many images.
+
+Use it instead of #remap when the same maps are applied to many frames, e.g. for the undistortion
+or stitching of a video stream. The plan converts the maps to the fixed-point representation (see
+#convertMaps) once, and stores them tile by tile, with the tiles ordered by their source area, so
+each tile reads contiguous memory and neighbor tiles fetch the same source pixels. The tiles are
+remapped in parallel.
+
+The result of RemapPlan::apply is identical to the result of #remap with the fixed-point maps.
+@sa createRemapPlan
+ */
+class CV_EXPORTS_W RemapPlan : public Algorithm
+{
+public:
+    /** @brief Remaps the image.
+
+    @param src source image; its size must be less than 32767x32767.
+    @param dst destination image of size getSize() and of the same type as src.
+     */
+    CV_WRAP virtual void apply(InputArray src, OutputArray dst) const = 0;
+
+    //! Returns the size of the destination images, i.e. the size of the maps
+    CV_WRAP virtual Size getSize() const = 0;
+};
+
+/** @brief Creates a RemapPlan.
+
+@param map1 the first map, see #remap. Floating-point (CV_32FC1, CV_32FC2) and fixed-point
+(CV_16SC2) maps are accepted.
+@param map2 the second map, see #remap.
+@param interpolation interpolation method, see #remap. The flag #WARP_RELATIVE_MAP is supported.
+@param borderMode pixel extrapolation method, see #remap.
+@param borderValue value used in case of a constant border; by default, it is 0.
+ */
+CV_EXPORTS_W Ptr<RemapPlan> createRemapPlan( InputArray map1, InputArray map2, int interpolation,
+                                             int borderMode = BORDER_CONSTANT,
+                                             const Scalar& borderValue = Scalar() );
+
 /** @brief Calculates an affine matrix of 2D rotation.
 
 The function calculates the following matrix:
@@ -3353,6 +3590,26 @@ equally sized rectangular tiles. tileGridSize defines the number of tiles in row
  */
 CV_EXPORTS_W Ptr<CLAHE> createCLAHE(double clipLimit = 40.0, Size tileGridSize = Size(8, 8));
 
+/** @brief Creates a cv::CLAHE object for the consecutive frames of a video stream.
+
+The histograms and lookup tables of the tiles are kept between the calls of CLAHE::apply(). A tile is
+processed again only when its content has changed since the frame its lookup table was computed from:
+the mean absolute difference of its pixels must exceed changeThreshold. The histogram of a processed
+tile may also be blended with the previous one, which avoids the flickering of the output:
+\f[\texttt{hist} = (1 - \alpha) \cdot \texttt{hist}_{prev} + \alpha \cdot \texttt{hist}_{frame}\f]
+
+The state is reset when the size or the type of the input changes, when the parameters are changed
+and by CLAHE::collectGarbage().
+
+@param clipLimit Threshold for contrast limiting.
+@param tileGridSize Size of grid for histogram equalization, see #createCLAHE.
+@param alpha weight of the histogram of the current frame, in (0, 1]; 1 disables the blending.
+@param changeThreshold tiles whose mean absolute difference from the reference frame does not exceed
+this value keep their lookup tables; with 0 all the tiles are recomputed in every frame.
+ */
+CV_EXPORTS_W Ptr<CLAHE> createTemporalCLAHE(double clipLimit = 40.0, Size tileGridSize = Size(8, 8),
+                                            double alpha = 1.0, double changeThreshold = 0.0);
+
 /** @brief Computes the "minimal work" distance between two weighted point configurations.
 
 The function computes the earth mover distance and/or a lower boundary of the distance between the
@@ -3677,6 +3934,34 @@ CV_EXPORTS int floodFill( InputOutputArray image,
                           Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
                           int flags = 4 );
 
+/** @brief Grows regions from several seed points at once.
+
+The function grows a region from every seed point with the same connectivity and color closeness
+rules as #floodFill, but it does not modify the image. Seeds are processed independently and in
+parallel, so a pixel that is reachable from several seeds belongs to each of their regions. The
+label map resolves such overlaps in favor of the seed with the lowest index. Region statistics
+are collected while the regions are grown and describe the complete region of each seed.
+
+@param image Input 1- or 3-channel, 8-bit, 32-bit integer or 32-bit floating-point image.
+@param seeds Vector of seed points, std::vector<Point> or an Nx1 CV_32SC2 matrix.
+@param labels Output CV_32SC1 label map of the image size. Pixels of the region grown from
+seeds[i] are set to i+1, pixels that do not belong to any region are set to 0.
+@param stats Optional output Nx5 CV_32SC1 matrix with the bounding box and area of every
+region, indexed by #ConnectedComponentsTypes as in #connectedComponentsWithStats.
+@param means Optional output NxC CV_64FC1 matrix with the mean color of every region, where C is
+the number of image channels.
+@param loDiff Maximal lower brightness/color difference, see #floodFill.
+@param upDiff Maximal upper brightness/color difference, see #floodFill.
+@param flags Connectivity (4 or 8) optionally combined with #FLOODFILL_FIXED_RANGE. The mask
+fill value and #FLOODFILL_MASK_ONLY are ignored.
+
+@sa floodFill, connectedComponentsWithStats
+ */
+CV_EXPORTS_W void floodFillSeeds( InputArray image, InputArray seeds, OutputArray labels,
+                                  OutputArray stats = noArray(), OutputArray means = noArray(),
+                                  Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
+                                  int flags = 4 );
+
 //! Performs linear blending of two images:
 //! \f[ \texttt{dst}(i,j) = \texttt{weights1}(i,j)*\texttt{src1}(i,j) + \texttt{weights2}(i,j)*\texttt{src2}(i,j) \f]
 //! @param src1 It has a type of CV_8UC(n) or CV_32FC(n), where n is a positive integer.
@@ -3916,6 +4201,42 @@ is \f$W \times H\f$ and templ is \f$w \times h\f$ , then result is \f$(W-w+1) \t
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Template matcher prepared for a fixed template and comparison method.
+
+The object computes the template statistics (mean, norm) once, and caches the template spectrum
+and the transform plans for the size of the processed images, so that matching the same template
+against a stream of same-sized frames does not repeat this work. Small templates are correlated
+directly in the spatial domain, larger ones tile by tile in the frequency domain; both paths are
+parallelized. The result is the same as the one of #matchTemplate without mask up to rounding
+errors.
+
+@note A TemplateMatcher object must not be used by several threads at the same time.
+@sa matchTemplate, createTemplateMatcher
+ */
+class CV_EXPORTS_W TemplateMatcher : public Algorithm
+{
+public:
+    /** @brief Compares the template against overlapped image regions.
+
+    @param image Image where the search is running. It must have the same type as the template and
+    be not smaller than the template.
+    @param result Map of comparison results, see #matchTemplate.
+     */
+    CV_WRAP virtual void match(InputArray image, OutputArray result) = 0;
+
+    //! Returns the comparison method, see #TemplateMatchModes
+    CV_WRAP virtual int getMethod() const = 0;
+    //! Returns the size of the template
+    CV_WRAP virtual Size getTemplateSize() const = 0;
+};
+
+/** @brief Creates a TemplateMatcher object for the given template.
+
+@param templ Searched template. It must be 8-bit or 32-bit floating-point with up to 4 channels.
+@param method Parameter specifying the comparison method, see #TemplateMatchModes
+ */
+CV_EXPORTS_W Ptr<TemplateMatcher> createTemplateMatcher(InputArray templ, int method);
+
 //! @}
 
 //! @addtogroup imgproc_shape
@@ -179,7 +179,12 @@ TWeight GCGraph<TWeight>::maxFlow()
             v->t = v->weight < 0;
         }
         else
+        {
+            // a vertex left from the previous maxFlow() call on the same graph
+            // starts free and on the source side, as a new one does
             v->parent = 0;
+            v->t = 0;
+        }
     }
     first = first->next;
     last->next = nilNode;
@@ -42,6 +42,7 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 // ----------------------------------------------------------------------
 // CLAHE
@@ -122,8 +123,12 @@ namespace
     class CLAHE_CalcLut_Body : public cv::ParallelLoopBody
     {
     public:
-        CLAHE_CalcLut_Body(const cv::Mat& src, const cv::Mat& lut, const cv::Size& tileSize, const int& tilesX, const int& clipLimit, const float& lutScale) :
-            src_(src), lut_(lut), tileSize_(tileSize), tilesX_(tilesX), clipLimit_(clipLimit), lutScale_(lutScale)
+        // ref and hist are the state of the temporal mode (empty otherwise): the frame the lookup tables
+        // were computed from, and the blended histograms of the tiles
+        CLAHE_CalcLut_Body(const cv::Mat& src, const cv::Mat& lut, const cv::Size& tileSize, const int& tilesX, const int& clipLimit, const float& lutScale,
+                           const cv::Mat& ref, const cv::Mat& hist, float alpha, double changeThreshold, bool resetState) :
+            src_(src), lut_(lut), tileSize_(tileSize), tilesX_(tilesX), clipLimit_(clipLimit), lutScale_(lutScale),
+            ref_(ref), hist_(hist), alpha_(alpha), changeThreshold_(changeThreshold), resetState_(resetState)
         {
         }
 
@@ -137,6 +142,12 @@ namespace
         int tilesX_;
         int clipLimit_;
         float lutScale_;
+
+        mutable cv::Mat ref_;
+        mutable cv::Mat hist_;
+        float alpha_;
+        double changeThreshold_;
+        bool resetState_;
     };
 
     template <class T, int histSize, int shift>
@@ -160,6 +171,16 @@ namespace
 
             const cv::Mat tile = src_(tileROI);
 
+            if (!ref_.empty())
+            {
+                // temporal mode: the tile keeps its lookup table while it is close to the reference
+                cv::Mat refTile = ref_(tileROI);
+                if (!resetState_ && changeThreshold_ > 0 &&
+                    cv::norm(tile, refTile, cv::NORM_L1) <= changeThreshold_ * tileROI.area())
+                    continue;
+                tile.copyTo(refTile);
+            }
+
             // calc histogram
 
             cv::AutoBuffer<int> _tileHist(histSize);
@@ -183,13 +204,48 @@ namespace
                     tileHist[ptr[x] >> shift]++;
             }
 
+            if (!hist_.empty())
+            {
+                // temporal mode: blend with the histogram of the previous frames
+                float* blendHist = hist_.ptr<float>(k);
+                if (resetState_)
+                {
+                    for (int i = 0; i < histSize; ++i)
+                        blendHist[i] = (float)tileHist[i];
+                }
+                else
+                {
+                    for (int i = 0; i < histSize; ++i)
+                    {
+                        blendHist[i] += alpha_ * (tileHist[i] - blendHist[i]);
+                        tileHist[i] = cvRound(blendHist[i]);
+                    }
+                }
+            }
+
             // clip histogram
 
             if (clipLimit_ > 0)
             {
                 // how many pixels were clipped
                 int clipped = 0;
-                for (int i = 0; i < histSize; ++i)
+                int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+                {
+                    // the 65536 bins of 16-bit images make the per-bin passes as costly as the histogram itself
+                    const int vlanes = cv::VTraits<cv::v_int32>::vlanes();
+                    cv::v_int32 v_limit = cv::vx_setall_s32(clipLimit_), v_clipped = cv::vx_setzero_s32();
+                    for (; i <= histSize - vlanes; i += vlanes)
+                    {
+                        cv::v_int32 v_hist = cv::vx_load(tileHist + i);
+                        cv::v_int32 v_res = cv::v_min(v_hist, v_limit);
+                        v_clipped = cv::v_add(v_clipped, cv::v_sub(v_hist, v_res));
+                        cv::v_store(tileHist + i, v_res);
+                    }
+                    clipped = cv::v_reduce_sum(v_clipped);
+                }
+#endif
+                for (; i < histSize; ++i)
                 {
                     if (tileHist[i] > clipLimit_)
                     {
@@ -202,13 +258,22 @@ namespace
                 int redistBatch = clipped / histSize;
                 int residual = clipped - redistBatch * histSize;
 
-                for (int i = 0; i < histSize; ++i)
+                i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+                {
+                    const int vlanes = cv::VTraits<cv::v_int32>::vlanes();
+                    cv::v_int32 v_batch = cv::vx_setall_s32(redistBatch);
+                    for (; i <= histSize - vlanes; i += vlanes)
+                        cv::v_store(tileHist + i, cv::v_add(cv::vx_load(tileHist + i), v_batch));
+                }
+#endif
+                for (; i < histSize; ++i)
                     tileHist[i] += redistBatch;
 
                 if (residual != 0)
                 {
                     int residualStep = MAX(histSize / residual, 1);
-                    for (int i = 0; i < histSize && residual > 0; i += residualStep, residual--)
+                    for (i = 0; i < histSize && residual > 0; i += residualStep, residual--)
                         tileHist[i]++;
                 }
             }
@@ -315,7 +380,8 @@ namespace
     class CLAHE_Impl CV_FINAL : public cv::CLAHE
     {
     public:
-        CLAHE_Impl(double clipLimit = 40.0, int tilesX = 8, int tilesY = 8);
+        CLAHE_Impl(double clipLimit = 40.0, int tilesX = 8, int tilesY = 8,
+                   bool temporal = false, double alpha = 1.0, double changeThreshold = 0.0);
 
         void apply(cv::InputArray src, cv::OutputArray dst) CV_OVERRIDE;
 
@@ -335,14 +401,24 @@ namespace
         cv::Mat srcExt_;
         cv::Mat lut_;
 
+        // temporal mode
+        bool temporal_;
+        double alpha_;
+        double changeThreshold_;
+        bool stateValid_;
+        cv::Mat ref_;
+        cv::Mat hist_;
+
 #ifdef HAVE_OPENCL
         cv::UMat usrcExt_;
         cv::UMat ulut_;
 #endif
     };
 
-    CLAHE_Impl::CLAHE_Impl(double clipLimit, int tilesX, int tilesY) :
-        clipLimit_(clipLimit), tilesX_(tilesX), tilesY_(tilesY)
+    CLAHE_Impl::CLAHE_Impl(double clipLimit, int tilesX, int tilesY,
+                           bool temporal, double alpha, double changeThreshold) :
+        clipLimit_(clipLimit), tilesX_(tilesX), tilesY_(tilesY),
+        temporal_(temporal), alpha_(alpha), changeThreshold_(changeThreshold), stateValid_(false)
     {
     }
 
@@ -353,7 +429,7 @@ namespace
         CV_Assert( _src.type() == CV_8UC1 || _src.type() == CV_16UC1 );
 
 #ifdef HAVE_OPENCL
-        bool useOpenCL = cv::ocl::isOpenCLActivated() && _src.isUMat() && _src.dims()<=2 && _src.type() == CV_8UC1;
+        bool useOpenCL = !temporal_ && cv::ocl::isOpenCLActivated() && _src.isUMat() && _src.dims()<=2 && _src.type() == CV_8UC1;
 #endif
 
         int histSize = _src.type() == CV_8UC1 ? 256 : 65536;
@@ -409,11 +485,28 @@ namespace
         cv::Mat srcForLut = _srcForLut.getMat();
         lut_.create(tilesX_ * tilesY_, histSize, _src.type());
 
+        bool resetState = true;
+        if (temporal_)
+        {
+            resetState = !stateValid_ || ref_.size() != srcForLut.size() || ref_.type() != srcForLut.type();
+            if (resetState)
+            {
+                ref_.create(srcForLut.size(), srcForLut.type());
+                if (alpha_ < 1.0)
+                    hist_.create(tilesX_ * tilesY_, histSize, CV_32F);
+                else
+                    hist_.release();
+            }
+            stateValid_ = true;
+        }
+
         cv::Ptr<cv::ParallelLoopBody> calcLutBody;
         if (_src.type() == CV_8UC1)
-            calcLutBody = cv::makePtr<CLAHE_CalcLut_Body<uchar, 256, 0> >(srcForLut, lut_, tileSize, tilesX_, clipLimit, lutScale);
+            calcLutBody = cv::makePtr<CLAHE_CalcLut_Body<uchar, 256, 0> >(srcForLut, lut_, tileSize, tilesX_, clipLimit, lutScale,
+                                                                          ref_, hist_, (float)alpha_, changeThreshold_, resetState);
         else if (_src.type() == CV_16UC1)
-            calcLutBody = cv::makePtr<CLAHE_CalcLut_Body<ushort, 65536, 0> >(srcForLut, lut_, tileSize, tilesX_, clipLimit, lutScale);
+            calcLutBody = cv::makePtr<CLAHE_CalcLut_Body<ushort, 65536, 0> >(srcForLut, lut_, tileSize, tilesX_, clipLimit, lutScale,
+                                                                             ref_, hist_, (float)alpha_, changeThreshold_, resetState);
         else
             CV_Error( cv::Error::StsBadArg, "Unsupported type" );
 
@@ -431,6 +524,7 @@ namespace
     void CLAHE_Impl::setClipLimit(double clipLimit)
     {
         clipLimit_ = clipLimit;
+        stateValid_ = false;
     }
 
     double CLAHE_Impl::getClipLimit() const
@@ -442,6 +536,7 @@ namespace
     {
         tilesX_ = tileGridSize.width;
         tilesY_ = tileGridSize.height;
+        stateValid_ = false;
     }
 
     cv::Size CLAHE_Impl::getTilesGridSize() const
@@ -453,6 +548,9 @@ namespace
     {
         srcExt_.release();
         lut_.release();
+        ref_.release();
+        hist_.release();
+        stateValid_ = false;
 #ifdef HAVE_OPENCL
         usrcExt_.release();
         ulut_.release();
@@ -464,3 +562,9 @@ cv::Ptr<cv::CLAHE> cv::createCLAHE(double clipLimit, cv::Size tileGridSize)
 {
     return makePtr<CLAHE_Impl>(clipLimit, tileGridSize.width, tileGridSize.height);
 }
+
+cv::Ptr<cv::CLAHE> cv::createTemporalCLAHE(double clipLimit, cv::Size tileGridSize, double alpha, double changeThreshold)
+{
+    CV_Assert( alpha > 0.0 && alpha <= 1.0 && changeThreshold >= 0.0 );
+    return makePtr<CLAHE_Impl>(clipLimit, tileGridSize.width, tileGridSize.height, true, alpha, changeThreshold);
+}
@@ -621,6 +621,81 @@ bool ContourScanner_::findNext()
 
 //==============================================================================
 
+// Parallel scan of horizontal bands
+//
+// Rows which contain only background can't be crossed by any contour, so the image is cut
+// into bands at such rows and each band is processed by its own scanner. Band sub-images share
+// only the cutting rows, which are never written by border following. Contours of a band are
+// found after all contours of the previous bands in the sequential raster scan and their
+// parents belong to the same band (or the root), so the result is identical to the sequential one.
+
+static const int MIN_BAND_PIXELS = 1 << 18;
+
+static void findBandCuts(const Mat& image, std::vector<int>& cuts)
+{
+    cuts.clear();
+    const int height = image.rows;
+    const int nthreads = getNumThreads();
+    if (nthreads <= 1 || image.total() < (size_t)MIN_BAND_PIXELS * 2)
+        return;
+
+    // rows 0 and height-1 belong to the added border
+    std::vector<uchar> emptyRow(height, (uchar)1);
+    parallel_for_(Range(1, height - 1), [&](const Range& r) {
+        for (int y = r.start; y < r.end; y++)
+            emptyRow[y] = !hasNonZero(image.row(y));
+    }, height * (double)image.cols / MIN_BAND_PIXELS);
+
+    const int maxBands = std::min(nthreads * 4, (int)(image.total() / MIN_BAND_PIXELS));
+    const int bandRows = std::max(height / std::max(maxBands, 1), 2);
+    cuts.push_back(0);
+    for (int y = bandRows; y < height - 1; y++)
+    {
+        if (emptyRow[y] && y - cuts.back() >= bandRows)
+            cuts.push_back(y);
+    }
+    cuts.push_back(height - 1);
+    if (cuts.size() < 3)
+        cuts.clear();
+}
+
+// Appends contours of the band trees to the resulting tree in the order of the sequential scan
+static void mergeBandTrees(std::vector<CTree>& bands, CTree& res)
+{
+    CNode& root = res.newElem();
+    CV_Assert(root.self() == 0);
+    root.body.isHole = true;
+    for (CTree& band : bands)
+    {
+        CV_Assert(!band.isEmpty());
+        const int base = (int)res.size() - 1;
+        auto remap = [base](int idx) { return idx <= 0 ? -1 : idx + base; };
+        for (int i = 1; i < (int)band.size(); i++)
+        {
+            CNode& src = band.elem(i);
+            CNode& dst = res.newElem();
+            dst.parent = src.parent == 0 ? 0 : remap(src.parent);
+            dst.first_child = remap(src.first_child);
+            dst.prev = remap(src.prev);
+            dst.next = remap(src.next);
+            std::swap(dst.body, src.body);
+        }
+
+        // children of the band root are stored in reverse order of appearance
+        std::vector<int> top;
+        for (int c = band.elem(0).first_child; c != -1; c = band.elem(c).next)
+            top.push_back(c);
+        for (auto it = top.rbegin(); it != top.rend(); ++it)
+        {
+            CNode& child = res.elem(remap(*it));
+            child.next = -1;
+            res.addChild(0, child.self());
+        }
+    }
+}
+
+//==============================================================================
+
 void cv::findContours(InputArray _image,
                       OutputArrayOfArrays _contours,
                       OutputArray _hierarchy,
@@ -674,6 +749,30 @@ void cv::findContours(InputArray _image,
         threshold(image, image, 0, 1, THRESH_BINARY);
 
     // find contours
+    std::vector<int> cuts;
+    findBandCuts(image, cuts);
+    if (!cuts.empty())
+    {
+        const int nbands = (int)cuts.size() - 1;
+        std::vector<CTree> bands(nbands);
+        parallel_for_(Range(0, nbands), [&](const Range& r) {
+            for (int i = r.start; i < r.end; i++)
+            {
+                Mat band = image.rowRange(cuts[i], cuts[i + 1] + 1);
+                ContourScanner scanner = ContourScanner_::create(band, mode, method, offset + Point(-1, cuts[i] - 1));
+                while (scanner->findNext())
+                {
+                }
+                std::swap(bands[i], scanner->tree);
+            }
+        }, nbands);
+
+        CTree tree;
+        mergeBandTrees(bands, tree);
+        contourTreeToResults(tree, res_type, _contours, _hierarchy);
+        return;
+    }
+
     ContourScanner scanner = ContourScanner_::create(image, mode, method, offset + Point(-1, -1));
     while (scanner->findNext())
     {
@@ -0,0 +1,387 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "filterengine.hpp"
+
+namespace cv
+{
+
+namespace {
+
+enum
+{
+    STAGE_FILTER = 0,   // separable or 2D linear filter
+    STAGE_GAUSSIAN,     // separable linear filter with kernels chosen by the input depth
+    STAGE_SOBEL,        // separable linear filter with kernels chosen by the input depth
+    STAGE_GRADIENT_MAG, // magnitude of the first Sobel derivatives
+    STAGE_THRESHOLD,
+    STAGE_CONVERT
+};
+
+struct PipelineStage
+{
+    PipelineStage() : kind(STAGE_FILTER), ddepth(-1), anchor(-1, -1), delta(0), borderType(BORDER_DEFAULT),
+        ksize(0, 0), sigma1(0), sigma2(0), dx(0), dy(0), scale(1), thresh(0), maxval(0), threshType(0) {}
+
+    int kind;
+    int ddepth;
+    Mat kx, ky, kernel;
+    Point anchor;
+    double delta;
+    int borderType;
+    Size ksize;
+    double sigma1, sigma2;
+    int dx, dy;
+    double scale;
+    double thresh, maxval;
+    int threshType;
+};
+
+// Aperture of the Gaussian stage, the same as the one of GaussianBlur
+static Size getGaussianStageKsize(const PipelineStage& st, int sdepth)
+{
+    Size ksize = st.ksize;
+    double sigma1 = st.sigma1, sigma2 = st.sigma2 <= 0 ? st.sigma1 : st.sigma2;
+    if( ksize.width <= 0 && sigma1 > 0 )
+        ksize.width = cvRound(sigma1*(sdepth == CV_8U ? 3 : 4)*2 + 1)|1;
+    if( ksize.height <= 0 && sigma2 > 0 )
+        ksize.height = cvRound(sigma2*(sdepth == CV_8U ? 3 : 4)*2 + 1)|1;
+    CV_Assert( ksize.width > 0 && ksize.width % 2 == 1 &&
+               ksize.height > 0 && ksize.height % 2 == 1 );
+    return ksize;
+}
+
+// Pads the 1D kernel with zeros to the given odd size
+static Mat padKernel(const Mat& kernel, int size)
+{
+    int n = (int)kernel.total();
+    if( n >= size )
+        return kernel;
+    Mat k;
+    copyMakeBorder(kernel.reshape(1, n), k, (size - n)/2, (size - n)/2, 0, 0, BORDER_CONSTANT, Scalar::all(0));
+    return k;
+}
+
+// Rows are pushed through the stages by blocks of this size
+static const int PIPELINE_BLOCK_ROWS = 16;
+// Bands of fewer rows are not worth the overlap
+static const int PIPELINE_MIN_BAND_ROWS = 64;
+
+/* Filter engines and row buffers of one band.
+
+The band computes rows [y0, y1) of the final result. Stage k produces rows outRows[k] of its
+output, which are exactly the input rows required by stage k+1 (a filter needs the aperture
+around its output rows, per-pixel operations need the same rows).
+*/
+class PipelineBand
+{
+public:
+    PipelineBand(const std::vector<PipelineStage>& stages, const std::vector<int>& types, Size size)
+        : stages_(stages), types_(types), size_(size), n_((int)stages.size()),
+          engines_(n_), engines2_(n_), outRows_(n_), outPos_(n_), bufs_(n_), tmpX_(n_), tmpY_(n_)
+    {
+        int extraRows = 0;
+        for( int k = 0; k < n_; k++ )
+        {
+            createEngines(k);
+            if( engines_[k] )
+                extraRows += engines_[k]->ksize.height - 1;
+            // the last call of a filter may produce the tail rows in addition to the rows of the input block
+            bufs_[k].create(PIPELINE_BLOCK_ROWS + extraRows, size_.width, types_[k + 1]);
+            if( stages_[k].kind == STAGE_GRADIENT_MAG )
+            {
+                tmpX_[k].create(bufs_[k].size(), types_[k + 1]);
+                tmpY_[k].create(bufs_[k].size(), types_[k + 1]);
+            }
+        }
+    }
+
+    void run(const Mat& src, Mat& dst, int y0, int y1)
+    {
+        Range rows(y0, y1);
+        for( int k = n_ - 1; k >= 0; k-- )
+        {
+            outRows_[k] = rows;
+            outPos_[k] = rows.start;
+            if( engines_[k] )
+            {
+                const Ptr<FilterEngine>& e = engines_[k];
+                e->start(size_, Size(size_.width, rows.size()), Point(0, rows.start));
+                if( engines2_[k] )
+                    engines2_[k]->start(size_, Size(size_.width, rows.size()), Point(0, rows.start));
+                rows = Range(e->startY, e->endY);
+            }
+        }
+
+        dst_ = dst;
+        for( int y = rows.start; y < rows.end; y += PIPELINE_BLOCK_ROWS )
+            feed(0, src.ptr(y), src.step, std::min(PIPELINE_BLOCK_ROWS, rows.end - y));
+
+        for( int k = 0; k < n_; k++ )
+            CV_Assert(outPos_[k] == outRows_[k].end);
+    }
+
+private:
+    void createEngines(int k)
+    {
+        const PipelineStage& st = stages_[k];
+        int stype = types_[k], dtype = types_[k + 1], sdepth = CV_MAT_DEPTH(stype);
+
+        if( st.kind == STAGE_FILTER )
+        {
+            if( st.kernel.empty() )
+                engines_[k] = createSeparableLinearFilter(stype, dtype, st.kx, st.ky, st.anchor, st.delta, st.borderType);
+            else
+                engines_[k] = createLinearFilter(stype, dtype, st.kernel, st.anchor, st.delta, st.borderType);
+        }
+        else if( st.kind == STAGE_GAUSSIAN )
+        {
+            // the same kernels as the ones of GaussianBlur
+            Size ksize = getGaussianStageKsize(st, sdepth);
+            double sigma1 = st.sigma1, sigma2 = st.sigma2 <= 0 ? st.sigma1 : st.sigma2;
+            int ktype = std::max(sdepth, CV_32F);
+            Mat kx = getGaussianKernel(ksize.width, std::max(sigma1, 0.), ktype);
+            Mat ky = getGaussianKernel(ksize.height, std::max(sigma2, 0.), ktype);
+            engines_[k] = createSeparableLinearFilter(stype, dtype, kx, ky, Point(-1,-1), 0, st.borderType);
+        }
+        else if( st.kind == STAGE_SOBEL || st.kind == STAGE_GRADIENT_MAG )
+        {
+            // the same kernels as the ones of Sobel
+            int ktype = std::max(CV_32F, std::max(CV_MAT_DEPTH(dtype), sdepth));
+            Mat kx, ky;
+            if( st.kind == STAGE_SOBEL )
+            {
+                getDerivKernels(kx, ky, st.dx, st.dy, st.ksize.width, false, ktype);
+                if( st.scale != 1 )
+                {
+                    if( st.dx == 0 )
+                        kx *= st.scale;
+                    else
+                        ky *= st.scale;
+                }
+                engines_[k] = createSeparableLinearFilter(stype, dtype, kx, ky, Point(-1,-1), st.delta, st.borderType);
+            }
+            else
+            {
+                // the engines may share the kernel data, so each one gets its own kernels
+                Mat kx2, ky2;
+                getDerivKernels(kx, ky, 1, 0, st.ksize.width, false, ktype);
+                getDerivKernels(kx2, ky2, 0, 1, st.ksize.width, false, ktype);
+                // both engines must produce the same rows: the 1-tap smoothing kernels of ksize == 1
+                // are padded to the aperture of the derivative kernels
+                int ksz = (int)std::max(kx.total(), ky2.total());
+                engines_[k] = createSeparableLinearFilter(stype, dtype, padKernel(kx, ksz), padKernel(ky, ksz), Point(-1,-1), 0, st.borderType);
+                engines2_[k] = createSeparableLinearFilter(stype, dtype, padKernel(kx2, ksz), padKernel(ky2, ksz), Point(-1,-1), 0, st.borderType);
+            }
+        }
+    }
+
+    // passes count input rows to the stage k, and the produced rows to the next stages
+    void feed(int k, const uchar* src, size_t srcstep, int count)
+    {
+        const PipelineStage& st = stages_[k];
+        bool last = k == n_ - 1;
+        Mat out = last ? dst_.rowRange(outPos_[k], dst_.rows) : bufs_[k];
+        int dy;
+
+        if( engines2_[k] )
+        {
+            dy = engines_[k]->proceed(src, (int)srcstep, count, tmpX_[k].ptr(), (int)tmpX_[k].step);
+            int dy2 = engines2_[k]->proceed(src, (int)srcstep, count, tmpY_[k].ptr(), (int)tmpY_[k].step);
+            CV_Assert(dy == dy2);
+            if( dy > 0 )
+            {
+                Mat mag = out.rowRange(0, dy);
+                magnitude(tmpX_[k].rowRange(0, dy).reshape(1), tmpY_[k].rowRange(0, dy).reshape(1), mag.reshape(1));
+            }
+        }
+        else if( engines_[k] )
+            dy = engines_[k]->proceed(src, (int)srcstep, count, out.ptr(), (int)out.step);
+        else
+        {
+            dy = count;
+            Mat in(count, size_.width, types_[k], (void*)src, srcstep);
+            Mat res = out.rowRange(0, count);
+            if( st.kind == STAGE_THRESHOLD )
+                threshold(in, res, st.thresh, st.maxval, st.threshType);
+            else
+                in.convertTo(res, CV_MAT_DEPTH(types_[k + 1]), st.scale, st.delta);
+        }
+
+        outPos_[k] += dy;
+        if( dy > 0 && !last )
+            feed(k + 1, out.ptr(), out.step, dy);
+    }
+
+    const std::vector<PipelineStage>& stages_;
+    const std::vector<int>& types_;
+    Size size_;
+    int n_;
+    std::vector<Ptr<FilterEngine> > engines_, engines2_;
+    std::vector<Range> outRows_;
+    std::vector<int> outPos_;
+    std::vector<Mat> bufs_, tmpX_, tmpY_;
+    Mat dst_;
+};
+
+class FilterPipelineImpl CV_FINAL : public FilterPipeline
+{
+public:
+    void addSepFilter2D(int ddepth, InputArray kernelX, InputArray kernelY, Point anchor,
+                        double delta, int borderType) CV_OVERRIDE
+    {
+        PipelineStage st;
+        st.ddepth = ddepth;
+        st.kx = kernelX.getMat().clone();
+        st.ky = kernelY.getMat().clone();
+        CV_Assert( !st.kx.empty() && !st.ky.empty() );
+        st.anchor = anchor;
+        st.delta = delta;
+        st.borderType = checkBorder(borderType);
+        stages_.push_back(st);
+    }
+
+    void addFilter2D(int ddepth, InputArray kernel, Point anchor, double delta, int borderType) CV_OVERRIDE
+    {
+        PipelineStage st;
+        st.ddepth = ddepth;
+        st.kernel = kernel.getMat().clone();
+        CV_Assert( !st.kernel.empty() && st.kernel.channels() == 1 );
+        st.anchor = anchor;
+        st.delta = delta;
+        st.borderType = checkBorder(borderType);
+        stages_.push_back(st);
+    }
+
+    void addGaussianBlur(Size ksize, double sigmaX, double sigmaY, int borderType) CV_OVERRIDE
+    {
+        PipelineStage st;
+        st.kind = STAGE_GAUSSIAN;
+        st.ksize = ksize;
+        st.sigma1 = sigmaX;
+        st.sigma2 = sigmaY;
+        st.borderType = checkBorder(borderType);
+        stages_.push_back(st);
+    }
+
+    void addSobel(int ddepth, int dx, int dy, int ksize, double scale, double delta, int borderType) CV_OVERRIDE
+    {
+        CV_Assert( dx >= 0 && dy >= 0 && dx + dy > 0 );
+        PipelineStage st;
+        st.kind = STAGE_SOBEL;
+        st.ddepth = ddepth;
+        st.dx = dx;
+        st.dy = dy;
+        st.ksize = Size(ksize, ksize);
+        st.scale = scale;
+        st.delta = delta;
+        st.borderType = checkBorder(borderType);
+        stages_.push_back(st);
+    }
+
+    void addGradientMagnitude(int ksize, int borderType) CV_OVERRIDE
+    {
+        PipelineStage st;
+        st.kind = STAGE_GRADIENT_MAG;
+        st.ddepth = CV_32F;
+        st.ksize = Size(ksize, ksize);
+        st.borderType = checkBorder(borderType);
+        stages_.push_back(st);
+    }
+
+    void addThreshold(double thresh, double maxval, int type) CV_OVERRIDE
+    {
+        CV_Assert( (type & (THRESH_OTSU | THRESH_TRIANGLE)) == 0 && (type & THRESH_MASK) <= THRESH_TOZERO_INV );
+        PipelineStage st;
+        st.kind = STAGE_THRESHOLD;
+        st.thresh = thresh;
+        st.maxval = maxval;
+        st.threshType = type;
+        stages_.push_back(st);
+    }
+
+    void addConvertTo(int ddepth, double alpha, double beta) CV_OVERRIDE
+    {
+        PipelineStage st;
+        st.kind = STAGE_CONVERT;
+        st.ddepth = ddepth;
+        st.scale = alpha;
+        st.delta = beta;
+        stages_.push_back(st);
+    }
+
+    void apply(InputArray _src, OutputArray _dst) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        CV_Assert( !stages_.empty() );
+        Mat src = _src.getMat();
+        CV_Assert( !src.empty() && src.dims <= 2 );
+
+        int n = (int)stages_.size(), cn = src.channels();
+        std::vector<int> types(n + 1);
+        types[0] = src.type();
+        int halo = 0;
+        for( int k = 0; k < n; k++ )
+        {
+            const PipelineStage& st = stages_[k];
+            int sdepth = CV_MAT_DEPTH(types[k]);
+            int ddepth = st.kind == STAGE_THRESHOLD || st.ddepth < 0 ? sdepth : st.ddepth;
+            types[k + 1] = CV_MAKETYPE(ddepth, cn);
+            if( st.kind == STAGE_GAUSSIAN )
+                halo += getGaussianStageKsize(st, sdepth).height;
+            else if( st.kind == STAGE_SOBEL || st.kind == STAGE_GRADIENT_MAG )
+                halo += std::max(st.ksize.height, 3);
+            else if( st.kind == STAGE_FILTER )
+                halo += st.kernel.empty() ? (int)st.ky.total() : st.kernel.rows;
+        }
+
+        _dst.create(src.size(), types[n]);
+        Mat dst = _dst.getMat();
+        if( src.data == dst.data )
+            src = src.clone();
+
+        Size size = src.size();
+        int nbands = 1;
+        if( getNumThreads() > 1 )
+            nbands = std::min(getNumThreads()*2, size.height / std::max(PIPELINE_MIN_BAND_ROWS, halo*4));
+        nbands = std::max(nbands, 1);
+
+        const std::vector<PipelineStage>& stages = stages_;
+        parallel_for_(Range(0, nbands), [&](const Range& range)
+        {
+            PipelineBand band(stages, types, size);
+            for( int b = range.start; b < range.end; b++ )
+            {
+                int y0 = (int)((int64)size.height*b/nbands);
+                int y1 = (int)((int64)size.height*(b + 1)/nbands);
+                band.run(src, dst, y0, y1);
+            }
+        }, nbands);
+    }
+
+    int getNumStages() const CV_OVERRIDE { return (int)stages_.size(); }
+
+    void clear() CV_OVERRIDE { stages_.clear(); }
+
+private:
+    static int checkBorder(int borderType)
+    {
+        borderType &= ~BORDER_ISOLATED;
+        CV_Assert( borderType != BORDER_WRAP );
+        return borderType;
+    }
+
+    std::vector<PipelineStage> stages_;
+};
+
+} // namespace
+
+Ptr<FilterPipeline> createFilterPipeline()
+{
+    return makePtr<FilterPipelineImpl>();
+}
+
+}
@@ -41,6 +41,8 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/core/utils/tls.hpp"
 
 #if defined(__GNUC__) && (__GNUC__ == 4) && (__GNUC_MINOR__ == 8)
 # pragma GCC diagnostic ignored "-Warray-bounds"
@@ -449,6 +451,311 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
     }
 }
 
+
+/****************************************************************************************\
+*                                  Multi-seed Floodfill                                  *
+\****************************************************************************************/
+
+struct FFillSpan
+{
+    int y;
+    int l;
+    int r;
+};
+
+// One bit per pixel; a set bit marks a pixel that is already in the region being grown.
+class FFillVisitedMask
+{
+public:
+    FFillVisitedMask() : wpr(0), height(0) {}
+
+    void init(Size size)
+    {
+        if( height == size.height && wpr == ((size.width + 31) >> 5) )
+            return;
+        wpr = (size.width + 31) >> 5;
+        height = size.height;
+        bits.assign((size_t)wpr*height, 0u);
+    }
+
+    bool test(int y, int x) const
+    {
+        return ((bits[(size_t)y*wpr + (x >> 5)] >> (x & 31)) & 1) != 0;
+    }
+
+    void setSpan(int y, int l, int r)
+    {
+        unsigned* row = &bits[(size_t)y*wpr];
+        int wl = l >> 5, wr = r >> 5;
+        unsigned ml = ~0u << (l & 31), mr = ~0u >> (31 - (r & 31));
+        if( wl == wr )
+        {
+            row[wl] |= ml & mr;
+            return;
+        }
+        row[wl] |= ml;
+        for( int w = wl + 1; w < wr; w++ )
+            row[w] = ~0u;
+        row[wr] |= mr;
+    }
+
+    // the first x in [x0, x1] with the bit equal to 'value', or x1 + 1
+    int find(int y, int x0, int x1, bool value) const
+    {
+        if( x0 > x1 )
+            return x1 + 1;
+        const unsigned* row = &bits[(size_t)y*wpr];
+        unsigned inv = value ? 0u : ~0u;
+        int w = x0 >> 5, wend = x1 >> 5;
+        unsigned word = (row[w] ^ inv) & (~0u << (x0 & 31));
+        for( ;; )
+        {
+            if( word )
+                return std::min((w << 5) + (int)trailingZeros32(word), x1 + 1);
+            if( ++w > wend )
+                return x1 + 1;
+            word = row[w] ^ inv;
+        }
+    }
+
+    void clearRows(int y0, int y1)
+    {
+        std::fill(bits.begin() + (size_t)y0*wpr, bits.begin() + (size_t)(y1 + 1)*wpr, 0u);
+    }
+
+protected:
+    std::vector<unsigned> bits;
+    int wpr;
+    int height;
+};
+
+// returns the first x in [x, limit] that is not within the fixed range around val0, or limit + 1
+template<typename _Tp, class Diff> static inline int
+ffFixedRunEnd( const _Tp* row, int x, int limit, const _Tp& val0, const Diff& diff )
+{
+    for( ; x <= limit && diff(row + x, &val0); x++ )
+        ;
+    return x;
+}
+
+// the same for the floating range: each pixel is compared with its left neighbor
+template<typename _Tp, class Diff> static inline int
+ffGradRunEnd( const _Tp* row, int x, int limit, const Diff& diff )
+{
+    for( ; x <= limit && diff(row + x, row + (x - 1)); x++ )
+        ;
+    return x;
+}
+
+static inline int
+ffFixedRunEnd( const uchar* row, int x, int limit, const uchar& val0, const Diff8uC1& diff )
+{
+    int lo = std::max((int)val0 - (int)diff.lo, 0);
+    int hi = std::min((int)val0 - (int)diff.lo + (int)diff.interval, 255);
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int VECSZ = VTraits<v_uint8>::vlanes();
+    v_uint8 vlo = vx_setall_u8((uchar)lo), vhi = vx_setall_u8((uchar)hi);
+    for( ; x <= limit - VECSZ + 1; x += VECSZ )
+    {
+        v_uint8 v = vx_load(row + x);
+        if( v_check_any(v_or(v_lt(v, vlo), v_gt(v, vhi))) )
+            break;
+    }
+#endif
+    for( ; x <= limit && lo <= row[x] && row[x] <= hi; x++ )
+        ;
+    return x;
+}
+
+static inline int
+ffGradRunEnd( const uchar* row, int x, int limit, const Diff8uC1& diff )
+{
+    // -lo <= a - b <= up  <=>  (b -sat a) <= lo && (a -sat b) <= up
+    uchar lo = (uchar)diff.lo, up = (uchar)(diff.interval - diff.lo);
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int VECSZ = VTraits<v_uint8>::vlanes();
+    v_uint8 vlo = vx_setall_u8(lo), vup = vx_setall_u8(up);
+    for( ; x <= limit - VECSZ + 1; x += VECSZ )
+    {
+        v_uint8 a = vx_load(row + x), b = vx_load(row + x - 1);
+        if( v_check_any(v_or(v_gt(v_sub(b, a), vlo), v_gt(v_sub(a, b), vup))) )
+            break;
+    }
+#endif
+    for( ; x <= limit && diff(row + x, row + (x - 1)); x++ )
+        ;
+    return x;
+}
+
+template<typename _Tp> static inline void
+ffAccumulate( const _Tp* row, int l, int r, double* sum )
+{
+    typedef typename DataType<_Tp>::channel_type _Ct;
+    const int cn = DataType<_Tp>::channels;
+    const _Ct* p = (const _Ct*)(row + l);
+    for( int c = 0; c < cn; c++ )
+    {
+        double s = 0;
+        for( int x = 0; x <= r - l; x++ )
+            s += p[x*cn + c];
+        sum[c] += s;
+    }
+}
+
+static inline void
+ffAccumulate( const uchar* row, int l, int r, double* sum )
+{
+    int x = l;
+    unsigned s = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int VECSZ = VTraits<v_uint8>::vlanes();
+    // 16-bit partial sums cannot overflow within 128 iterations
+    for( ; x <= r - VECSZ + 1; )
+    {
+        v_uint16 vs = vx_setzero_u16();
+        for( int n = 0; n < 128 && x <= r - VECSZ + 1; n++, x += VECSZ )
+        {
+            v_uint16 a, b;
+            v_expand(vx_load(row + x), a, b);
+            vs = v_add(vs, v_add(a, b));
+        }
+        s += v_reduce_sum(vs);
+    }
+#endif
+    for( ; x <= r; x++ )
+        s += row[x];
+    sum[0] += s;
+}
+
+template<typename _Tp, class Diff>
+class FloodFillSeedsInvoker : public ParallelLoopBody
+{
+public:
+    FloodFillSeedsInvoker( const Mat& _img, const Point* _seeds, const Diff& _diff, int _flags,
+                           TLSData<FFillVisitedMask>& _visited,
+                           std::vector<std::vector<FFillSpan> >& _regions,
+                           std::vector<ConnectedComp>& _comps )
+        : img(_img), seeds(_seeds), diff(_diff), flags(_flags), visited(_visited),
+          regions(_regions), comps(_comps)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        FFillVisitedMask& vmask = visited.getRef();
+        vmask.init(img.size());
+        std::vector<FFillSpan> stack;
+        for( int k = range.start; k < range.end; k++ )
+            fill(seeds[k], vmask, stack, regions[k], comps[k]);
+    }
+
+protected:
+    void fill( Point seed, FFillVisitedMask& vmask, std::vector<FFillSpan>& stack,
+               std::vector<FFillSpan>& spans, ConnectedComp& comp ) const
+    {
+        const int c8 = (flags & 255) == 8;
+        const bool fixedRange = (flags & FLOODFILL_FIXED_RANGE) != 0;
+        const int width = img.cols, height = img.rows;
+        const _Tp val0 = img.at<_Tp>(seed);
+        double sum[4] = { 0, 0, 0, 0 };
+        int area = 0, XMin = seed.x, XMax = seed.x, YMin = seed.y, YMax = seed.y;
+
+        spans.clear();
+        stack.clear();
+        addSpan(seed.y, seed.x, vmask, val0, fixedRange, spans, stack);
+
+        while( !stack.empty() )
+        {
+            FFillSpan s = stack.back();
+            stack.pop_back();
+
+            const _Tp* prow = img.ptr<_Tp>(s.y);
+            area += s.r - s.l + 1;
+            XMin = std::min(XMin, s.l);
+            XMax = std::max(XMax, s.r);
+            YMin = std::min(YMin, s.y);
+            YMax = std::max(YMax, s.y);
+            ffAccumulate(prow, s.l, s.r, sum);
+
+            for( int dy = -1; dy <= 1; dy += 2 )
+            {
+                int y = s.y + dy;
+                if( (unsigned)y >= (unsigned)height )
+                    continue;
+                const _Tp* row = img.ptr<_Tp>(y);
+                int right = std::min(s.r + c8, width - 1);
+                for( int x = std::max(s.l - c8, 0); x <= right; x++ )
+                {
+                    x = vmask.find(y, x, right, false);
+                    if( x > right )
+                        break;
+                    bool accept;
+                    if( fixedRange )
+                        accept = diff(row + x, &val0);
+                    else
+                    {
+                        accept = false;
+                        for( int px = std::max(x - c8, s.l); px <= std::min(x + c8, s.r) && !accept; px++ )
+                            accept = diff(row + x, prow + px);
+                    }
+                    if( accept )
+                        x = addSpan(y, x, vmask, val0, fixedRange, spans, stack);
+                }
+            }
+        }
+
+        vmask.clearRows(YMin, YMax);
+
+        comp.pt = seed;
+        comp.area = area;
+        comp.rect = Rect(XMin, YMin, XMax - XMin + 1, YMax - YMin + 1);
+        for( int c = 0; c < 4; c++ )
+            comp.avg[c] = sum[c] / area;
+    }
+
+    // grows the span containing (x, y) to the left and to the right, marks it and
+    // returns its right end
+    int addSpan( int y, int x, FFillVisitedMask& vmask, const _Tp& val0, bool fixedRange,
+                 std::vector<FFillSpan>& spans, std::vector<FFillSpan>& stack ) const
+    {
+        const _Tp* row = img.ptr<_Tp>(y);
+        int l = x, r;
+        if( fixedRange )
+            while( l > 0 && !vmask.test(y, l - 1) && diff(row + (l - 1), &val0) )
+                l--;
+        else
+            while( l > 0 && !vmask.test(y, l - 1) && diff(row + (l - 1), row + l) )
+                l--;
+
+        int limit = vmask.find(y, x + 1, img.cols - 1, true) - 1;
+        r = (fixedRange ? ffFixedRunEnd(row, x + 1, limit, val0, diff) :
+                          ffGradRunEnd(row, x + 1, limit, diff)) - 1;
+
+        vmask.setSpan(y, l, r);
+        FFillSpan s = { y, l, r };
+        spans.push_back(s);
+        stack.push_back(s);
+        return r;
+    }
+
+    const Mat& img;
+    const Point* seeds;
+    Diff diff;
+    int flags;
+    TLSData<FFillVisitedMask>& visited;
+    std::vector<std::vector<FFillSpan> >& regions;
+    std::vector<ConnectedComp>& comps;
+};
+
+template<typename _Tp, class Diff> static void
+floodFillSeeds_( const Mat& img, const Point* seeds, int nseeds, const Diff& diff, int flags,
+                 std::vector<std::vector<FFillSpan> >& regions, std::vector<ConnectedComp>& comps )
+{
+    TLSData<FFillVisitedMask> visited;
+    parallel_for_(Range(0, nseeds),
+                  FloodFillSeedsInvoker<_Tp, Diff>(img, seeds, diff, flags, visited, regions, comps));
+}
+
 }
 
 /****************************************************************************************\
@@ -637,6 +944,111 @@ int cv::floodFill( InputOutputArray _image, Point seedPoint,
 }
 
 
+void cv::floodFillSeeds( InputArray _image, InputArray _seeds, OutputArray _labels,
+                         OutputArray _stats, OutputArray _means,
+                         Scalar loDiff, Scalar upDiff, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _image.getMat(), seedMat = _seeds.getMat();
+    CV_Assert( !img.empty() );
+
+    Size size = img.size();
+    int type = img.type();
+    int cn = img.channels();
+
+    if ( (cn != 1) && (cn != 3) )
+    {
+        CV_Error( cv::Error::StsBadArg, "Number of channels in input image must be 1 or 3" );
+    }
+
+    const int connectivity = flags & 255;
+    if( connectivity != 0 && connectivity != 4 && connectivity != 8 )
+        CV_Error( cv::Error::StsBadFlag, "Connectivity must be 4, 0(=4) or 8" );
+
+    int nseeds = seedMat.empty() ? 0 : seedMat.checkVector(2, CV_32S);
+    CV_Assert( nseeds >= 0 );
+    const Point* seeds = nseeds > 0 ? seedMat.ptr<Point>() : 0;
+    for( int k = 0; k < nseeds; k++ )
+        if( (unsigned)seeds[k].x >= (unsigned)size.width ||
+            (unsigned)seeds[k].y >= (unsigned)size.height )
+            CV_Error( cv::Error::StsOutOfRange, "Seed point is outside of image" );
+
+    Vec3b ld_b, ud_b;
+    Vec3i ld_i, ud_i;
+    Vec3f ld_f, ud_f;
+    for( int i = 0; i < cn; i++ )
+    {
+        if( loDiff[i] < 0 || upDiff[i] < 0 )
+            CV_Error( cv::Error::StsBadArg, "lo_diff and up_diff must be non-negative" );
+        ld_b[i] = saturate_cast<uchar>(cvFloor(loDiff[i]));
+        ud_b[i] = saturate_cast<uchar>(cvFloor(upDiff[i]));
+        ld_i[i] = cvFloor(loDiff[i]);
+        ud_i[i] = cvFloor(upDiff[i]);
+        ld_f[i] = (float)loDiff[i];
+        ud_f[i] = (float)upDiff[i];
+    }
+
+    std::vector<std::vector<FFillSpan> > regions(nseeds);
+    std::vector<ConnectedComp> comps(nseeds);
+
+    if( nseeds == 0 )
+        ;
+    else if( type == CV_8UC1 )
+        floodFillSeeds_<uchar>(img, seeds, nseeds, Diff8uC1(ld_b[0], ud_b[0]), flags, regions, comps);
+    else if( type == CV_8UC3 )
+        floodFillSeeds_<Vec3b>(img, seeds, nseeds, Diff8uC3(ld_b, ud_b), flags, regions, comps);
+    else if( type == CV_32SC1 )
+        floodFillSeeds_<int>(img, seeds, nseeds, Diff32sC1(ld_i[0], ud_i[0]), flags, regions, comps);
+    else if( type == CV_32SC3 )
+        floodFillSeeds_<Vec3i>(img, seeds, nseeds, Diff32sC3(ld_i, ud_i), flags, regions, comps);
+    else if( type == CV_32FC1 )
+        floodFillSeeds_<float>(img, seeds, nseeds, Diff32fC1(ld_f[0], ud_f[0]), flags, regions, comps);
+    else if( type == CV_32FC3 )
+        floodFillSeeds_<Vec3f>(img, seeds, nseeds, Diff32fC3(ld_f, ud_f), flags, regions, comps);
+    else
+        CV_Error( cv::Error::StsUnsupportedFormat, "" );
+
+    _labels.create( size, CV_32S );
+    Mat labels = _labels.getMat();
+    labels.setTo(Scalar::all(0));
+    // paint the regions backwards, so that where they overlap the lowest seed index wins
+    for( int k = nseeds - 1; k >= 0; k-- )
+    {
+        const std::vector<FFillSpan>& spans = regions[k];
+        for( size_t j = 0; j < spans.size(); j++ )
+        {
+            int* lab = labels.ptr<int>(spans[j].y);
+            std::fill(lab + spans[j].l, lab + spans[j].r + 1, k + 1);
+        }
+    }
+
+    if( _stats.needed() )
+    {
+        _stats.create( nseeds, CC_STAT_MAX, CV_32S );
+        Mat stats = _stats.getMat();
+        for( int k = 0; k < nseeds; k++ )
+        {
+            int* st = stats.ptr<int>(k);
+            st[CC_STAT_LEFT] = comps[k].rect.x;
+            st[CC_STAT_TOP] = comps[k].rect.y;
+            st[CC_STAT_WIDTH] = comps[k].rect.width;
+            st[CC_STAT_HEIGHT] = comps[k].rect.height;
+            st[CC_STAT_AREA] = comps[k].area;
+        }
+    }
+
+    if( _means.needed() )
+    {
+        _means.create( nseeds, cn, CV_64F );
+        Mat means = _means.getMat();
+        for( int k = 0; k < nseeds; k++ )
+            for( int i = 0; i < cn; i++ )
+                means.at<double>(k, i) = comps[k].avg[i];
+    }
+}
+
+
 CV_IMPL void
 cvFloodFill( CvArr* arr, CvPoint seed_point,
              CvScalar newVal, CvScalar lo_diff, CvScalar up_diff,
@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencv2/imgproc/detail/gcgraph.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 #include <limits>
 
 using namespace cv;
@@ -66,9 +67,12 @@ public:
     double operator()( const Vec3d color ) const;
     double operator()( int ci, const Vec3d color ) const;
     int whichComponent( const Vec3d color ) const;
+    void calcRow( const double* c0, const double* c1, const double* c2, int n,
+                  double* prob, int* comp ) const;
 
     void initLearning();
     void addSample( int ci, const Vec3d color );
+    void addSamples( int ci, int count, const int64* sum, const int64* prod );
     void endLearning();
 
 private:
@@ -152,6 +156,61 @@ int GMM::whichComponent( const Vec3d color ) const
     return k;
 }
 
+/*
+  Evaluates the mixture for n colors given as three planes: the probability of
+  each color (if prob is not NULL) and its most probable component (if comp is not NULL).
+*/
+void GMM::calcRow( const double* c0, const double* c1, const double* c2, int n,
+                   double* prob, int* comp ) const
+{
+    int i = 0;
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+    const int VECSZ = VTraits<v_float64>::vlanes();
+    double buf[VTraits<v_float64>::max_nlanes];
+    for( ; i <= n - VECSZ; i += VECSZ )
+    {
+        v_float64 x0 = vx_load(c0 + i), x1 = vx_load(c1 + i), x2 = vx_load(c2 + i);
+        v_float64 vprob = vx_setzero_f64(), vmax = vx_setzero_f64(), vcomp = vx_setzero_f64();
+        for( int ci = 0; ci < componentsCount; ci++ )
+        {
+            if( coefs[ci] <= 0 )
+                continue;
+            CV_Assert( covDeterms[ci] > std::numeric_limits<double>::epsilon() );
+            const double* m = mean + 3*ci;
+            const double (*ic)[3] = inverseCovs[ci];
+            v_float64 d0 = v_sub(x0, vx_setall_f64(m[0]));
+            v_float64 d1 = v_sub(x1, vx_setall_f64(m[1]));
+            v_float64 d2 = v_sub(x2, vx_setall_f64(m[2]));
+            v_float64 t0 = v_fma(d2, vx_setall_f64(ic[2][0]), v_fma(d1, vx_setall_f64(ic[1][0]), v_mul(d0, vx_setall_f64(ic[0][0]))));
+            v_float64 t1 = v_fma(d2, vx_setall_f64(ic[2][1]), v_fma(d1, vx_setall_f64(ic[1][1]), v_mul(d0, vx_setall_f64(ic[0][1]))));
+            v_float64 t2 = v_fma(d2, vx_setall_f64(ic[2][2]), v_fma(d1, vx_setall_f64(ic[1][2]), v_mul(d0, vx_setall_f64(ic[0][2]))));
+            v_float64 mult = v_fma(d2, t2, v_fma(d1, t1, v_mul(d0, t0)));
+            v_float64 p = v_mul(vx_setall_f64(1.0/sqrt(covDeterms[ci])), v_exp(v_mul(mult, vx_setall_f64(-0.5))));
+            vprob = v_fma(vx_setall_f64(coefs[ci]), p, vprob);
+            v_float64 gt = v_gt(p, vmax);
+            vmax = v_select(gt, p, vmax);
+            vcomp = v_select(gt, vx_setall_f64((double)ci), vcomp);
+        }
+        if( prob )
+            v_store(prob + i, vprob);
+        if( comp )
+        {
+            v_store(buf, vcomp);
+            for( int j = 0; j < VECSZ; j++ )
+                comp[i + j] = (int)buf[j];
+        }
+    }
+#endif
+    for( ; i < n; i++ )
+    {
+        Vec3d color(c0[i], c1[i], c2[i]);
+        if( prob )
+            prob[i] = (*this)( color );
+        if( comp )
+            comp[i] = whichComponent( color );
+    }
+}
+
 void GMM::initLearning()
 {
     for( int ci = 0; ci < componentsCount; ci++)
@@ -175,6 +234,20 @@ void GMM::addSample( int ci, const Vec3d color )
     totalSampleCount++;
 }
 
+/*
+  Adds count samples of the component at once, given the sums of their colors and
+  the upper triangle (00, 01, 02, 11, 12, 22) of the sums of their color products.
+*/
+void GMM::addSamples( int ci, int count, const int64* sum, const int64* prod )
+{
+    sums[ci][0] += (double)sum[0]; sums[ci][1] += (double)sum[1]; sums[ci][2] += (double)sum[2];
+    prods[ci][0][0] += (double)prod[0]; prods[ci][0][1] += (double)prod[1]; prods[ci][0][2] += (double)prod[2];
+    prods[ci][1][0] += (double)prod[1]; prods[ci][1][1] += (double)prod[3]; prods[ci][1][2] += (double)prod[4];
+    prods[ci][2][0] += (double)prod[2]; prods[ci][2][1] += (double)prod[4]; prods[ci][2][2] += (double)prod[5];
+    sampleCounts[ci] += count;
+    totalSampleCount += count;
+}
+
 void GMM::endLearning()
 {
     for( int ci = 0; ci < componentsCount; ci++ )
@@ -233,40 +306,50 @@ void GMM::calcInverseCovAndDeterm(int ci, const double singularFix)
 
 } // namespace
 
+/*
+  Squared distance between two colors.
+*/
+static inline int colorDist2( const Vec3b& a, const Vec3b& b )
+{
+    int d0 = a[0] - b[0], d1 = a[1] - b[1], d2 = a[2] - b[2];
+    return d0*d0 + d1*d1 + d2*d2;
+}
+
 /*
   Calculate beta - parameter of GrabCut algorithm.
   beta = 1/(2*avg(sqr(||color[i] - color[j]||)))
 */
 static double calcBeta( const Mat& img )
 {
-    double beta = 0;
-    for( int y = 0; y < img.rows; y++ )
+    // the row sums are integer, so the result does not depend on the number of threads
+    std::vector<int64> rowSums(img.rows);
+    parallel_for_(Range(0, img.rows), [&](const Range& range)
     {
-        for( int x = 0; x < img.cols; x++ )
+        for( int y = range.start; y < range.end; y++ )
         {
-            Vec3d color = img.at<Vec3b>(y,x);
-            if( x>0 ) // left
+            const Vec3b* row = img.ptr<Vec3b>(y);
+            int64 s = 0;
+            for( int x = 1; x < img.cols; x++ ) // left
+                s += colorDist2(row[x], row[x-1]);
+            if( y > 0 )
             {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y,x-1);
-                beta += diff.dot(diff);
-            }
-            if( y>0 && x>0 ) // upleft
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x-1);
-                beta += diff.dot(diff);
-            }
-            if( y>0 ) // up
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x);
-                beta += diff.dot(diff);
-            }
-            if( y>0 && x<img.cols-1) // upright
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x+1);
-                beta += diff.dot(diff);
+                const Vec3b* prev = img.ptr<Vec3b>(y-1);
+                for( int x = 0; x < img.cols; x++ )
+                {
+                    s += colorDist2(row[x], prev[x]); // up
+                    if( x > 0 ) // upleft
+                        s += colorDist2(row[x], prev[x-1]);
+                    if( x < img.cols-1 ) // upright
+                        s += colorDist2(row[x], prev[x+1]);
+                }
             }
+            rowSums[y] = s;
         }
-    }
+    });
+
+    double beta = 0;
+    for( int y = 0; y < img.rows; y++ )
+        beta += (double)rowSums[y];
     if( beta <= std::numeric_limits<double>::epsilon() )
         beta = 0;
     else
@@ -275,6 +358,22 @@ static double calcBeta( const Mat& img )
     return beta;
 }
 
+/*
+  Replaces the squared color distances in w by gamma*exp(-beta*w).
+*/
+static void expWeights( double* w, int n, double beta, double gamma )
+{
+    int x = 0;
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+    const int VECSZ = VTraits<v_float64>::vlanes();
+    v_float64 vbeta = vx_setall_f64(-beta), vgamma = vx_setall_f64(gamma);
+    for( ; x <= n - VECSZ; x += VECSZ )
+        v_store(w + x, v_mul(vgamma, v_exp(v_mul(vbeta, vx_load(w + x)))));
+#endif
+    for( ; x < n; x++ )
+        w[x] = gamma * exp(-beta*w[x]);
+}
+
 /*
   Calculate weights of noterminal vertices of graph.
   beta and gamma - parameters of GrabCut algorithm.
@@ -286,41 +385,44 @@ static void calcNWeights( const Mat& img, Mat& leftW, Mat& upleftW, Mat& upW, Ma
     upleftW.create( img.rows, img.cols, CV_64FC1 );
     upW.create( img.rows, img.cols, CV_64FC1 );
     uprightW.create( img.rows, img.cols, CV_64FC1 );
-    for( int y = 0; y < img.rows; y++ )
+    parallel_for_(Range(0, img.rows), [&](const Range& range)
     {
-        for( int x = 0; x < img.cols; x++ )
+        const int cols = img.cols;
+        for( int y = range.start; y < range.end; y++ )
         {
-            Vec3d color = img.at<Vec3b>(y,x);
-            if( x-1>=0 ) // left
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y,x-1);
-                leftW.at<double>(y,x) = gamma * exp(-beta*diff.dot(diff));
-            }
-            else
-                leftW.at<double>(y,x) = 0;
-            if( x-1>=0 && y-1>=0 ) // upleft
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x-1);
-                upleftW.at<double>(y,x) = gammaDivSqrt2 * exp(-beta*diff.dot(diff));
-            }
-            else
-                upleftW.at<double>(y,x) = 0;
-            if( y-1>=0 ) // up
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x);
-                upW.at<double>(y,x) = gamma * exp(-beta*diff.dot(diff));
-            }
-            else
-                upW.at<double>(y,x) = 0;
-            if( x+1<img.cols && y-1>=0 ) // upright
+            const Vec3b* row = img.ptr<Vec3b>(y);
+            double* lw = leftW.ptr<double>(y);
+            double* ulw = upleftW.ptr<double>(y);
+            double* uw = upW.ptr<double>(y);
+            double* urw = uprightW.ptr<double>(y);
+
+            lw[0] = 0;
+            for( int x = 1; x < cols; x++ ) // left
+                lw[x] = colorDist2(row[x], row[x-1]);
+            expWeights( lw + 1, cols - 1, beta, gamma );
+
+            if( y == 0 )
             {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x+1);
-                uprightW.at<double>(y,x) = gammaDivSqrt2 * exp(-beta*diff.dot(diff));
+                std::fill(ulw, ulw + cols, 0.);
+                std::fill(uw, uw + cols, 0.);
+                std::fill(urw, urw + cols, 0.);
+                continue;
             }
-            else
-                uprightW.at<double>(y,x) = 0;
+
+            const Vec3b* prev = img.ptr<Vec3b>(y-1);
+            ulw[0] = 0;
+            for( int x = 1; x < cols; x++ ) // upleft
+                ulw[x] = colorDist2(row[x], prev[x-1]);
+            expWeights( ulw + 1, cols - 1, beta, gammaDivSqrt2 );
+            for( int x = 0; x < cols; x++ ) // up
+                uw[x] = colorDist2(row[x], prev[x]);
+            expWeights( uw, cols, beta, gamma );
+            for( int x = 0; x < cols - 1; x++ ) // upright
+                urw[x] = colorDist2(row[x], prev[x+1]);
+            expWeights( urw, cols - 1, beta, gammaDivSqrt2 );
+            urw[cols-1] = 0;
         }
-    }
+    });
 }
 
 /*
@@ -410,55 +512,200 @@ static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM
     fgdGMM.endLearning();
 }
 
+/*
+  Splits the colors of the n pixels of a row selected by sel (or of all of them
+  if sel is NULL) into three planes, returns the number of the copied colors.
+*/
+static int splitColors( const Vec3b* row, int n, const uchar* sel, double* c0, double* c1, double* c2 )
+{
+    int k = 0;
+    for( int x = 0; x < n; x++ )
+    {
+        if( sel && !sel[x] )
+            continue;
+        c0[k] = row[x][0]; c1[k] = row[x][1]; c2[k] = row[x][2];
+        k++;
+    }
+    return k;
+}
+
+static inline bool isBgd( uchar m )
+{
+    return m == GC_BGD || m == GC_PR_BGD;
+}
+
 /*
   Assign GMMs components for each pixel.
 */
 static void assignGMMsComponents( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, Mat& compIdxs )
 {
-    Point p;
-    for( p.y = 0; p.y < img.rows; p.y++ )
+    parallel_for_(Range(0, img.rows), [&](const Range& range)
     {
-        for( p.x = 0; p.x < img.cols; p.x++ )
+        const int cols = img.cols;
+        AutoBuffer<double> _buf(cols*3);
+        AutoBuffer<uchar> _sel(cols*2);
+        AutoBuffer<int> _comp(cols);
+        double *c0 = _buf.data(), *c1 = c0 + cols, *c2 = c1 + cols;
+        uchar *bsel = _sel.data(), *fsel = bsel + cols;
+        int* comp = _comp.data();
+        for( int y = range.start; y < range.end; y++ )
         {
-            Vec3d color = img.at<Vec3b>(p);
-            compIdxs.at<int>(p) = mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD ?
-                bgdGMM.whichComponent(color) : fgdGMM.whichComponent(color);
+            const Vec3b* row = img.ptr<Vec3b>(y);
+            const uchar* m = mask.ptr<uchar>(y);
+            int* dst = compIdxs.ptr<int>(y);
+            for( int x = 0; x < cols; x++ )
+            {
+                bsel[x] = isBgd(m[x]);
+                fsel[x] = !bsel[x];
+            }
+            for( int k = 0; k < 2; k++ )
+            {
+                const uchar* sel = k == 0 ? bsel : fsel;
+                int n = splitColors( row, cols, sel, c0, c1, c2 );
+                (k == 0 ? bgdGMM : fgdGMM).calcRow( c0, c1, c2, n, 0, comp );
+                for( int x = 0, j = 0; x < cols; x++ )
+                    if( sel[x] )
+                        dst[x] = comp[j++];
+            }
         }
-    }
+    });
 }
 
+namespace {
+
+/*
+  Sums of the colors and of the color products of the samples of every GMM component,
+  accumulated in integers so that the result does not depend on the order of samples.
+*/
+struct GMMSamples
+{
+    GMMSamples()
+    {
+        memset( sum, 0, sizeof(sum) );
+        memset( prod, 0, sizeof(prod) );
+        memset( count, 0, sizeof(count) );
+    }
+
+    void add( int ci, const Vec3b& color )
+    {
+        int c0 = color[0], c1 = color[1], c2 = color[2];
+        int64* s = sum[ci];
+        int64* p = prod[ci];
+        s[0] += c0; s[1] += c1; s[2] += c2;
+        p[0] += c0*c0; p[1] += c0*c1; p[2] += c0*c2;
+        p[3] += c1*c1; p[4] += c1*c2; p[5] += c2*c2;
+        count[ci]++;
+    }
+
+    void add( const GMMSamples& other )
+    {
+        for( int ci = 0; ci < GMM::componentsCount; ci++ )
+        {
+            for( int i = 0; i < 3; i++ )
+                sum[ci][i] += other.sum[ci][i];
+            for( int i = 0; i < 6; i++ )
+                prod[ci][i] += other.prod[ci][i];
+            count[ci] += other.count[ci];
+        }
+    }
+
+    int64 sum[GMM::componentsCount][3];
+    int64 prod[GMM::componentsCount][6];
+    int count[GMM::componentsCount];
+};
+
+} // namespace
+
 /*
   Learn GMMs parameters.
 */
 static void learnGMMs( const Mat& img, const Mat& mask, const Mat& compIdxs, GMM& bgdGMM, GMM& fgdGMM )
 {
+    GMMSamples bgdSamples, fgdSamples;
+    Mutex mutex;
+    parallel_for_(Range(0, img.rows), [&](const Range& range)
+    {
+        GMMSamples bgd, fgd;
+        for( int y = range.start; y < range.end; y++ )
+        {
+            const Vec3b* row = img.ptr<Vec3b>(y);
+            const uchar* m = mask.ptr<uchar>(y);
+            const int* comp = compIdxs.ptr<int>(y);
+            for( int x = 0; x < img.cols; x++ )
+            {
+                if( isBgd(m[x]) )
+                    bgd.add( comp[x], row[x] );
+                else
+                    fgd.add( comp[x], row[x] );
+            }
+        }
+        AutoLock lock(mutex);
+        bgdSamples.add( bgd );
+        fgdSamples.add( fgd );
+    });
+
     bgdGMM.initLearning();
     fgdGMM.initLearning();
-    Point p;
     for( int ci = 0; ci < GMM::componentsCount; ci++ )
     {
-        for( p.y = 0; p.y < img.rows; p.y++ )
+        bgdGMM.addSamples( ci, bgdSamples.count[ci], bgdSamples.sum[ci], bgdSamples.prod[ci] );
+        fgdGMM.addSamples( ci, fgdSamples.count[ci], fgdSamples.sum[ci], fgdSamples.prod[ci] );
+    }
+    bgdGMM.endLearning();
+    fgdGMM.endLearning();
+}
+
+/*
+  Calculate weights of the terminal edges (source and sink weight for each pixel).
+  Returns false if some of the weights are infinite.
+*/
+static bool calcTWeights( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM,
+                          double lambda, Mat& tweights )
+{
+    tweights.create( img.size(), CV_64FC2 );
+    std::vector<uchar> rowFinite(img.rows);
+    parallel_for_(Range(0, img.rows), [&](const Range& range)
+    {
+        const int cols = img.cols;
+        AutoBuffer<double> _buf(cols*5);
+        AutoBuffer<uchar> _sel(cols);
+        double *c0 = _buf.data(), *c1 = c0 + cols, *c2 = c1 + cols;
+        double *bgdProb = c2 + cols, *fgdProb = bgdProb + cols;
+        uchar* sel = _sel.data();
+        for( int y = range.start; y < range.end; y++ )
         {
-            for( p.x = 0; p.x < img.cols; p.x++ )
+            const uchar* m = mask.ptr<uchar>(y);
+            Vec2d* tw = tweights.ptr<Vec2d>(y);
+            for( int x = 0; x < cols; x++ )
+                sel[x] = m[x] == GC_PR_BGD || m[x] == GC_PR_FGD;
+            int n = splitColors( img.ptr<Vec3b>(y), cols, sel, c0, c1, c2 );
+            bgdGMM.calcRow( c0, c1, c2, n, bgdProb, 0 );
+            fgdGMM.calcRow( c0, c1, c2, n, fgdProb, 0 );
+
+            bool finite = true;
+            for( int x = 0, j = 0; x < cols; x++ )
             {
-                if( compIdxs.at<int>(p) == ci )
+                if( sel[x] )
                 {
-                    if( mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD )
-                        bgdGMM.addSample( ci, img.at<Vec3b>(p) );
-                    else
-                        fgdGMM.addSample( ci, img.at<Vec3b>(p) );
+                    tw[x] = Vec2d( -log( bgdProb[j] ), -log( fgdProb[j] ) );
+                    finite = finite && bgdProb[j] > 0 && fgdProb[j] > 0;
+                    j++;
                 }
+                else if( m[x] == GC_BGD )
+                    tw[x] = Vec2d( 0, lambda );
+                else // GC_FGD
+                    tw[x] = Vec2d( lambda, 0 );
             }
+            rowFinite[y] = finite;
         }
-    }
-    bgdGMM.endLearning();
-    fgdGMM.endLearning();
+    });
+    return std::find(rowFinite.begin(), rowFinite.end(), (uchar)0) == rowFinite.end();
 }
 
 /*
   Construct GCGraph
 */
-static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, double lambda,
+static void constructGCGraph( const Mat& img, const Mat& tweights,
                        const Mat& leftW, const Mat& upleftW, const Mat& upW, const Mat& uprightW,
                        GCGraph<double>& graph )
 {
@@ -472,26 +719,10 @@ static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM
         {
             // add node
             int vtxIdx = graph.addVtx();
-            Vec3b color = img.at<Vec3b>(p);
 
             // set t-weights
-            double fromSource, toSink;
-            if( mask.at<uchar>(p) == GC_PR_BGD || mask.at<uchar>(p) == GC_PR_FGD )
-            {
-                fromSource = -log( bgdGMM(color) );
-                toSink = -log( fgdGMM(color) );
-            }
-            else if( mask.at<uchar>(p) == GC_BGD )
-            {
-                fromSource = 0;
-                toSink = lambda;
-            }
-            else // GC_FGD
-            {
-                fromSource = lambda;
-                toSink = 0;
-            }
-            graph.addTermWeights( vtxIdx, fromSource, toSink );
+            const Vec2d& tw = tweights.at<Vec2d>(p);
+            graph.addTermWeights( vtxIdx, tw[0], tw[1] );
 
             // set n-weights
             if( p.x>0 )
@@ -518,6 +749,26 @@ static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM
     }
 }
 
+/*
+  Update the t-weights of the graph left from the previous iteration. The residual
+  capacities keep the flow found so far, only the difference of the terminal weights
+  is added to every vertex, so maxFlow() continues from that flow.
+*/
+static void updateGCGraph( const Mat& tweights, const Mat& prevTWeights, GCGraph<double>& graph )
+{
+    for( int y = 0, vtxIdx = 0; y < tweights.rows; y++ )
+    {
+        const Vec2d* tw = tweights.ptr<Vec2d>(y);
+        const Vec2d* prev = prevTWeights.ptr<Vec2d>(y);
+        for( int x = 0; x < tweights.cols; x++, vtxIdx++ )
+        {
+            double delta = (tw[x][0] - tw[x][1]) - (prev[x][0] - prev[x][1]);
+            if( delta != 0 )
+                graph.addTermWeights( vtxIdx, std::max(delta, 0.), std::max(-delta, 0.) );
+        }
+    }
+}
+
 /*
   Estimate segmentation using MaxFlow algorithm
 */
@@ -584,13 +835,27 @@ void cv::grabCut( InputArray _img, InputOutputArray _mask, Rect rect,
     Mat leftW, upleftW, upW, uprightW;
     calcNWeights( img, leftW, upleftW, upW, uprightW, beta, gamma );
 
+    // The n-weights do not change between iterations, so the graph is built once and
+    // later iterations only update its t-weights and reuse the flow found so far.
+    // The graph is rebuilt when some t-weights are infinite.
+    GCGraph<double> graph;
+    Mat tweights, prevTWeights;
+    bool reuseGraph = false;
     for( int i = 0; i < iterCount; i++ )
     {
-        GCGraph<double> graph;
         assignGMMsComponents( img, mask, bgdGMM, fgdGMM, compIdxs );
         if( mode != GC_EVAL_FREEZE_MODEL )
             learnGMMs( img, mask, compIdxs, bgdGMM, fgdGMM );
-        constructGCGraph(img, mask, bgdGMM, fgdGMM, lambda, leftW, upleftW, upW, uprightW, graph );
+        bool finite = calcTWeights( img, mask, bgdGMM, fgdGMM, lambda, tweights );
+        if( reuseGraph && finite )
+            updateGCGraph( tweights, prevTWeights, graph );
+        else
+        {
+            graph = GCGraph<double>();
+            constructGCGraph( img, tweights, leftW, upleftW, upW, uprightW, graph );
+        }
+        reuseGraph = finite;
+        std::swap( tweights, prevTWeights );
         estimateSegmentation( graph, mask );
     }
 }
@@ -107,6 +107,49 @@ findLocalMaximums( int numrho, int numangle, int threshold,
         }
 }
 
+/*
+Finds the local maximums of the accumulator of the standard transform
+(stage 2), sorts them by the number of votes (stage 3) and stores the
+first min(total,linesMax) lines to the output buffer (stage 4).
+*/
+static void
+getLinesFromAccum( const int* accum, int numrho, int numangle, int threshold, int linesMax,
+                   float rho, float theta, double min_theta, std::vector<int>& sort_buf,
+                   OutputArray lines, int type )
+{
+    // stage 2. find local maximums
+    sort_buf.clear();
+    findLocalMaximums( numrho, numangle, threshold, accum, sort_buf );
+
+    // stage 3. sort the detected lines by accumulator value
+    std::sort(sort_buf.begin(), sort_buf.end(), hough_cmp_gt(accum));
+
+    // stage 4. store the first min(total,linesMax) lines to the output buffer
+    linesMax = std::min(linesMax, (int)sort_buf.size());
+    double scale = 1./(numrho+2);
+
+    lines.create(linesMax, 1, type);
+    Mat _lines = lines.getMat();
+    for( int i = 0; i < linesMax; i++ )
+    {
+        LinePolar line;
+        int idx = sort_buf[i];
+        int n = cvFloor(idx*scale) - 1;
+        int r = idx - (n+1)*(numrho+2) - 1;
+        line.rho = (r - (numrho - 1)*0.5f) * rho;
+        line.angle = static_cast<float>(min_theta) + n * theta;
+        if (type == CV_32FC2)
+        {
+            _lines.at<Vec2f>(i) = Vec2f(line.rho, line.angle);
+        }
+        else
+        {
+            CV_DbgAssert(type == CV_32FC3);
+            _lines.at<Vec3f>(i) = Vec3f(line.rho, line.angle, (float)accum[idx]);
+        }
+    }
+}
+
 /*
 Here image is an input raster;
 step is it's step; size characterizes it's ROI;
@@ -210,36 +253,8 @@ HoughLinesStandard( InputArray src, OutputArray lines, int type,
             }
      }
 
-    // stage 2. find local maximums
-    findLocalMaximums( numrho, numangle, threshold, accum, _sort_buf );
-
-    // stage 3. sort the detected lines by accumulator value
-    std::sort(_sort_buf.begin(), _sort_buf.end(), hough_cmp_gt(accum));
-
-    // stage 4. store the first min(total,linesMax) lines to the output buffer
-    linesMax = std::min(linesMax, (int)_sort_buf.size());
-    double scale = 1./(numrho+2);
-
-    lines.create(linesMax, 1, type);
-    Mat _lines = lines.getMat();
-    for( i = 0; i < linesMax; i++ )
-    {
-        LinePolar line;
-        int idx = _sort_buf[i];
-        int n = cvFloor(idx*scale) - 1;
-        int r = idx - (n+1)*(numrho+2) - 1;
-        line.rho = (r - (numrho - 1)*0.5f) * rho;
-        line.angle = static_cast<float>(min_theta) + n * theta;
-        if (type == CV_32FC2)
-        {
-            _lines.at<Vec2f>(i) = Vec2f(line.rho, line.angle);
-        }
-        else
-        {
-            CV_DbgAssert(type == CV_32FC3);
-            _lines.at<Vec3f>(i) = Vec3f(line.rho, line.angle, (float)accum[idx]);
-        }
-    }
+    getLinesFromAccum( accum, numrho, numangle, threshold, linesMax,
+                       rho, theta, min_theta, _sort_buf, lines, type );
 }
 
 
@@ -486,11 +501,21 @@ HoughLinesSDiv( InputArray image, OutputArray lines, int type,
 *                              Probabilistic Hough Transform                             *
 \****************************************************************************************/
 
+// Working buffers of the probabilistic transform, kept by HoughLinesDetector between calls
+struct HoughLinesPBuffers
+{
+    Mat accum;
+    Mat mask;
+    std::vector<float> trigtab;
+    std::vector<Point> nzloc;
+};
+
 static void
 HoughLinesProbabilistic( Mat& image,
                          float rho, float theta, int threshold,
                          int lineLength, int lineGap,
-                         std::vector<Vec4i>& lines, int linesMax )
+                         std::vector<Vec4i>& lines, int linesMax,
+                         HoughLinesPBuffers& buf )
 {
     Point pt;
     float irho = 1 / rho;
@@ -533,9 +558,14 @@ HoughLinesProbabilistic( Mat& image,
     }
 #endif
 
-    Mat accum = Mat::zeros( numangle, numrho, CV_32SC1 );
-    Mat mask( height, width, CV_8UC1 );
-    std::vector<float> trigtab(numangle*2);
+    buf.accum.create( numangle, numrho, CV_32SC1 );
+    buf.accum.setTo( Scalar::all(0) );
+    buf.mask.create( height, width, CV_8UC1 );
+    buf.trigtab.resize( numangle*2 );
+    buf.nzloc.clear();
+    Mat& accum = buf.accum;
+    Mat& mask = buf.mask;
+    std::vector<float>& trigtab = buf.trigtab;
 
     for( int n = 0; n < numangle; n++ )
     {
@@ -544,7 +574,7 @@ HoughLinesProbabilistic( Mat& image,
     }
     const float* ttab = &trigtab[0];
     uchar* mdata0 = mask.ptr();
-    std::vector<Point> nzloc;
+    std::vector<Point>& nzloc = buf.nzloc;
 
     // stage 1. collect non-zero image points
     for( pt.y = 0; pt.y < height; pt.y++ )
@@ -954,7 +984,8 @@ void HoughLinesP(InputArray _image, OutputArray _lines,
 
     Mat image = _image.getMat();
     std::vector<Vec4i> lines;
-    HoughLinesProbabilistic(image, (float)rho, (float)theta, threshold, cvRound(minLineLength), cvRound(maxGap), lines, INT_MAX);
+    HoughLinesPBuffers buf;
+    HoughLinesProbabilistic(image, (float)rho, (float)theta, threshold, cvRound(minLineLength), cvRound(maxGap), lines, INT_MAX, buf);
     Mat(lines).copyTo(_lines);
 }
 
@@ -1030,6 +1061,228 @@ void HoughLinesPointSet( InputArray _point, OutputArray _lines, int lines_max, i
     Mat(lines).copyTo(_lines);
 }
 
+/****************************************************************************************\
+*                                 Stateful Line Detector                                 *
+\****************************************************************************************/
+
+/*
+Votes the non-zero pixels of the given rows and columns of the image into accum,
+an accumulator of the standard transform. base[n] is the index of the cell of
+angle n and rho 0, idxbuf is a buffer of numangle elements.
+*/
+static void
+houghVoteStandard( const Mat& image, Range rows, Range cols,
+                   const float* tabSin, const float* tabCos, const int* base,
+                   int numangle, int* accum, int* idxbuf )
+{
+    for( int i = rows.start; i < rows.end; i++ )
+    {
+        const uchar* data = image.ptr(i);
+        for( int j = cols.start; j < cols.end; j++ )
+        {
+            if( !data[j] )
+                continue;
+
+            int n = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+            const int VECSZ = VTraits<v_float32>::vlanes();
+            v_float32 vj = vx_setall_f32((float)j), vi = vx_setall_f32((float)i);
+            for( ; n <= numangle - VECSZ; n += VECSZ )
+            {
+                v_int32 r = v_round(v_add(v_mul(vj, vx_load(tabCos + n)), v_mul(vi, vx_load(tabSin + n))));
+                v_store(idxbuf + n, v_add(r, vx_load(base + n)));
+            }
+#endif
+            for( ; n < numangle; n++ )
+                idxbuf[n] = cvRound( j * tabCos[n] + i * tabSin[n] ) + base[n];
+            for( n = 0; n < numangle; n++ )
+                accum[idxbuf[n]]++;
+        }
+    }
+}
+
+/*
+Sums the accumulators of the threads.
+*/
+static void
+sumAccumulators( const std::vector<Mat>& src, int count, Mat& dst )
+{
+    parallel_for_(Range(0, dst.rows), [&](const Range& range)
+    {
+        const int cols = dst.cols;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int* d = dst.ptr<int>(i);
+            const int* s0 = src[0].ptr<int>(i);
+            int j = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+            const int VECSZ = VTraits<v_int32>::vlanes();
+            for( ; j <= cols - VECSZ; j += VECSZ )
+            {
+                v_int32 v = vx_load(s0 + j);
+                for( int k = 1; k < count; k++ )
+                    v = v_add(v, vx_load(src[k].ptr<int>(i) + j));
+                v_store(d + j, v);
+            }
+#endif
+            for( ; j < cols; j++ )
+            {
+                int v = s0[j];
+                for( int k = 1; k < count; k++ )
+                    v += src[k].ptr<int>(i)[j];
+                d[j] = v;
+            }
+        }
+    });
+}
+
+class HoughLinesDetectorImpl CV_FINAL : public HoughLinesDetector
+{
+public:
+    HoughLinesDetectorImpl( double _rho, double _theta, int _threshold,
+                            double _minLineLength, double _maxLineGap )
+        : rho(_rho), theta(_theta), threshold(_threshold),
+          minLineLength(_minLineLength), maxLineGap(_maxLineGap), parallelVoting(true),
+          trigNumangle(-1), trigIrho(0.f), trigNumrho(-1)
+    {
+        CV_Assert( rho > 0 && theta > 0 );
+    }
+
+    void detect( InputArray image, OutputArray lines, Rect roi ) CV_OVERRIDE;
+    void detectSegments( InputArray image, OutputArray lines, Rect roi ) CV_OVERRIDE;
+
+    void setThreshold( int _threshold ) CV_OVERRIDE { threshold = _threshold; }
+    int getThreshold() const CV_OVERRIDE { return threshold; }
+    void setMinLineLength( double _minLineLength ) CV_OVERRIDE { minLineLength = _minLineLength; }
+    double getMinLineLength() const CV_OVERRIDE { return minLineLength; }
+    void setMaxLineGap( double _maxLineGap ) CV_OVERRIDE { maxLineGap = _maxLineGap; }
+    double getMaxLineGap() const CV_OVERRIDE { return maxLineGap; }
+    void setParallelVoting( bool enabled ) CV_OVERRIDE { parallelVoting = enabled; }
+    bool getParallelVoting() const CV_OVERRIDE { return parallelVoting; }
+
+protected:
+    static Rect clipRoi( Rect roi, Size size )
+    {
+        Rect whole(Point(), size);
+        return roi.empty() ? whole : (roi & whole);
+    }
+
+    double rho, theta;
+    int threshold;
+    double minLineLength, maxLineGap;
+    bool parallelVoting;
+
+    // standard transform
+    Mat accum;
+    std::vector<Mat> localAccums;
+    std::vector<float> tabSin, tabCos;
+    std::vector<int> base;
+    std::vector<int> idxBuf;  // numangle elements per stripe
+    std::vector<int> sortBuf;
+    int trigNumangle;
+    float trigIrho;
+    int trigNumrho;
+
+    // probabilistic transform
+    HoughLinesPBuffers pbuf;
+    std::vector<Vec4i> segments;
+};
+
+void HoughLinesDetectorImpl::detect( InputArray _image, OutputArray _lines, Rect roi )
+{
+    CV_INSTRUMENT_REGION();
+
+    int type = CV_32FC2;
+    if( _lines.fixedType() )
+    {
+        type = _lines.type();
+        CV_CheckType(type, type == CV_32FC2 || type == CV_32FC3, "Wrong type of output lines");
+    }
+
+    Mat image = _image.getMat();
+    CV_Assert( image.type() == CV_8UC1 );
+    roi = clipRoi(roi, image.size());
+
+    // the same accumulator geometry as HoughLines() uses for the whole image
+    const float frho = (float)rho, ftheta = (float)theta, irho = 1 / frho;
+    int max_rho = image.cols + image.rows;
+    int min_rho = -max_rho;
+    int numangle = computeNumangle(0.0, CV_PI, ftheta);
+    int numrho = cvRound(((max_rho - min_rho) + 1) / frho);
+
+    if( trigNumangle != numangle || trigIrho != irho || trigNumrho != numrho )
+    {
+        tabSin.resize(numangle);
+        tabCos.resize(numangle);
+        base.resize(numangle);
+        createTrigTable( numangle, 0.0, ftheta, irho, &tabSin[0], &tabCos[0] );
+        for( int n = 0; n < numangle; n++ )
+            base[n] = (n + 1) * (numrho + 2) + 1 + (numrho - 1) / 2;
+        trigNumangle = numangle;
+        trigIrho = irho;
+        trigNumrho = numrho;
+    }
+
+    accum.create( numangle + 2, numrho + 2, CV_32SC1 );
+    const Range rows(roi.y, roi.y + roi.height), cols(roi.x, roi.x + roi.width);
+    // every thread votes into its own accumulator, the sums do not depend on
+    // the number of threads
+    int nstripes = std::max(parallelVoting ? std::min(getNumThreads(), roi.height / 16) : 1, 1);
+    if( idxBuf.size() < (size_t)nstripes * numangle )
+        idxBuf.resize((size_t)nstripes * numangle);
+    if( nstripes == 1 )
+    {
+        accum.setTo( Scalar::all(0) );
+        houghVoteStandard( image, rows, cols, &tabSin[0], &tabCos[0], &base[0],
+                           numangle, accum.ptr<int>(), &idxBuf[0] );
+    }
+    else
+    {
+        if( (int)localAccums.size() < nstripes )
+            localAccums.resize(nstripes);
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
+        {
+            for( int k = range.start; k < range.end; k++ )
+            {
+                Mat& a = localAccums[k];
+                a.create( accum.size(), CV_32SC1 );
+                a.setTo( Scalar::all(0) );
+                Range stripe(rows.start + (int)((int64)rows.size() * k / nstripes),
+                             rows.start + (int)((int64)rows.size() * (k + 1) / nstripes));
+                houghVoteStandard( image, stripe, cols, &tabSin[0], &tabCos[0], &base[0],
+                                   numangle, a.ptr<int>(), &idxBuf[(size_t)k * numangle] );
+            }
+        }, nstripes);
+        sumAccumulators( localAccums, nstripes, accum );
+    }
+
+    getLinesFromAccum( accum.ptr<int>(), numrho, numangle, threshold, INT_MAX,
+                       frho, ftheta, 0.0, sortBuf, _lines, type );
+}
+
+void HoughLinesDetectorImpl::detectSegments( InputArray _image, OutputArray _lines, Rect roi )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat image = _image.getMat();
+    CV_Assert( image.type() == CV_8UC1 );
+    roi = clipRoi(roi, image.size());
+
+    Mat part = image(roi);
+    segments.clear();
+    HoughLinesProbabilistic( part, (float)rho, (float)theta, threshold,
+                             cvRound(minLineLength), cvRound(maxLineGap), segments, INT_MAX, pbuf );
+    for( size_t i = 0; i < segments.size(); i++ )
+        segments[i] += Vec4i(roi.x, roi.y, roi.x, roi.y);
+    Mat(segments).copyTo(_lines);
+}
+
+Ptr<HoughLinesDetector> createHoughLinesDetector( double rho, double theta, int threshold,
+                                                  double minLineLength, double maxLineGap )
+{
+    return makePtr<HoughLinesDetectorImpl>(rho, theta, threshold, minLineLength, maxLineGap);
+}
+
 /****************************************************************************************\
 *                                     Circle Detection                                   *
 \****************************************************************************************/
@@ -2438,8 +2691,11 @@ cvHoughLines2( CvArr* src_image, void* lineStorage, int method,
                 threshold, iparam1, iparam2, linesMax, min_theta, max_theta );
         break;
     case CV_HOUGH_PROBABILISTIC:
+        {
+        cv::HoughLinesPBuffers buf;
         HoughLinesProbabilistic( image, (float)rho, (float)theta,
-                threshold, iparam1, iparam2, l4, linesMax );
+                threshold, iparam1, iparam2, l4, linesMax, buf );
+        }
         break;
     default:
         CV_Error( cv::Error::StsBadArg, "Unrecognized method id" );
@@ -55,6 +55,7 @@
 #include "opencv2/core/openvx/ovx_defs.hpp"
 #include "opencv2/core/softfloat.hpp"
 #include "imgwarp.hpp"
+#include "resize.hpp"
 
 using namespace cv;
 
@@ -1715,14 +1716,9 @@ private:
 
 }
 
-void cv::remap( InputArray _src, OutputArray _dst,
-                InputArray _map1, InputArray _map2,
-                int interpolation, int borderType, const Scalar& borderValue )
+static void getRemapFuncs(int interpolation, int type, bool relative,
+                          RemapNNFunc& nnfunc, RemapFunc& ifunc, const void*& ctab)
 {
-    CV_INSTRUMENT_REGION();
-
-    const bool hasRelativeFlag = ((interpolation & WARP_RELATIVE_MAP) != 0);
-
     static RemapNNFunc nn_tab[2][8] =
     {
         {
@@ -1789,6 +1785,43 @@ void cv::remap( InputArray _src, OutputArray _dst,
         }
 };
 
+    int depth = CV_MAT_DEPTH(type);
+    const int relativeOptionIndex = (relative ? 1 : 0);
+    nnfunc = 0;
+    ifunc = 0;
+    ctab = 0;
+    if( interpolation == INTER_NEAREST )
+    {
+        nnfunc = nn_tab[relativeOptionIndex][depth];
+        CV_Assert( nnfunc != 0 );
+    }
+    else
+    {
+        if( interpolation == INTER_LINEAR )
+            ifunc = linear_tab[relativeOptionIndex][depth];
+        else if( interpolation == INTER_CUBIC ){
+            ifunc = cubic_tab[relativeOptionIndex][depth];
+            CV_Assert( CV_MAT_CN(type) <= 4 );
+        }
+        else if( interpolation == INTER_LANCZOS4 ){
+            ifunc = lanczos4_tab[relativeOptionIndex][depth];
+            CV_Assert( CV_MAT_CN(type) <= 4 );
+        }
+        else
+            CV_Error( cv::Error::StsBadArg, "Unknown interpolation method" );
+        CV_Assert( ifunc != 0 );
+        ctab = initInterTab2D( interpolation, depth == CV_8U );
+    }
+}
+
+void cv::remap( InputArray _src, OutputArray _dst,
+                InputArray _map1, InputArray _map2,
+                int interpolation, int borderType, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
+    const bool hasRelativeFlag = ((interpolation & WARP_RELATIVE_MAP) != 0);
+
     CV_Assert( !_map1.empty() );
     CV_Assert( _map2.empty() || (_map2.size() == _map1.size()));
 
@@ -1825,7 +1858,7 @@ void cv::remap( InputArray _src, OutputArray _dst,
     if( interpolation == INTER_AREA )
         interpolation = INTER_LINEAR;
 
-    int type = src.type(), depth = CV_MAT_DEPTH(type);
+    int type = src.type();
 
 #if defined HAVE_IPP && !IPP_DISABLE_REMAP
     CV_IPP_CHECK()
@@ -1871,32 +1904,8 @@ void cv::remap( InputArray _src, OutputArray _dst,
     RemapNNFunc nnfunc = 0;
     RemapFunc ifunc = 0;
     const void* ctab = 0;
-    bool fixpt = depth == CV_8U;
     bool planar_input = false;
-
-    const int relativeOptionIndex = (hasRelativeFlag ? 1 : 0);
-    if( interpolation == INTER_NEAREST )
-    {
-        nnfunc = nn_tab[relativeOptionIndex][depth];
-        CV_Assert( nnfunc != 0 );
-    }
-    else
-    {
-        if( interpolation == INTER_LINEAR )
-            ifunc = linear_tab[relativeOptionIndex][depth];
-        else if( interpolation == INTER_CUBIC ){
-            ifunc = cubic_tab[relativeOptionIndex][depth];
-            CV_Assert( _src.channels() <= 4 );
-        }
-        else if( interpolation == INTER_LANCZOS4 ){
-            ifunc = lanczos4_tab[relativeOptionIndex][depth];
-            CV_Assert( _src.channels() <= 4 );
-        }
-        else
-            CV_Error( cv::Error::StsBadArg, "Unknown interpolation method" );
-        CV_Assert( ifunc != 0 );
-        ctab = initInterTab2D( interpolation, fixpt );
-    }
+    getRemapFuncs(interpolation, type, hasRelativeFlag, nnfunc, ifunc, ctab);
 
     const Mat *m1 = &map1, *m2 = &map2;
 
@@ -2226,6 +2235,187 @@ void cv::convertMaps( InputArray _map1, InputArray _map2,
     }
 }
 
+namespace cv
+{
+
+// RemapPlan splits the destination into square tiles of this size
+static const int REMAP_TILE_SIZE = 64;
+
+class RemapPlanImpl CV_FINAL : public RemapPlan
+{
+public:
+    RemapPlanImpl(const Mat& map1, const Mat& map2, int _interpolation, int _borderType, const Scalar& _borderValue)
+        : borderType(_borderType), borderValue(_borderValue)
+    {
+        CV_Assert( !map1.empty() && (map2.empty() || map2.size() == map1.size()) );
+        size = map1.size();
+        CV_Assert( size.width < SHRT_MAX && size.height < SHRT_MAX );
+
+        bool relative = (_interpolation & WARP_RELATIVE_MAP) != 0;
+        interpolation = _interpolation & ~WARP_RELATIVE_MAP;
+        if( interpolation == INTER_AREA )
+            interpolation = INTER_LINEAR;
+        CV_Assert( interpolation == INTER_NEAREST || interpolation == INTER_LINEAR ||
+                   interpolation == INTER_CUBIC || interpolation == INTER_LANCZOS4 );
+        bool nn = interpolation == INTER_NEAREST;
+
+        // the fixed-point representation used by remap: integer coordinates and the indices of the
+        // interpolation coefficients (none for the nearest neighbor)
+        Mat xy, a;
+        const Mat *m1 = &map1, *m2 = &map2;
+        if( m2->type() == CV_16SC2 )
+            std::swap(m1, m2);
+        if( m1->type() == CV_16SC2 )
+        {
+            CV_Assert( m2->empty() || m2->type() == CV_16UC1 || m2->type() == CV_16SC1 );
+            xy = m1->clone();
+            if( !m2->empty() )
+            {
+                // CV_16SC1 indices are read as ushort by remap() too, so reinterpret them
+                Mat m2u(m2->size(), CV_16UC1, (void*)m2->data, m2->step);
+                bitwise_and(m2u, Scalar::all(INTER_TAB_SIZE2-1), a);
+            }
+            if( nn && !a.empty() )
+            {
+                for( int y = 0; y < size.height; y++ )
+                {
+                    short* XY = xy.ptr<short>(y);
+                    const ushort* A = a.ptr<ushort>(y);
+                    for( int x = 0; x < size.width; x++ )
+                    {
+                        XY[x*2] = saturate_cast<short>(XY[x*2] + NNDeltaTab_i[A[x]][0]);
+                        XY[x*2+1] = saturate_cast<short>(XY[x*2+1] + NNDeltaTab_i[A[x]][1]);
+                    }
+                }
+                a.release();
+            }
+            else if( !nn && a.empty() )
+                a = Mat::zeros(size, CV_16UC1);
+        }
+        else
+        {
+            CV_Assert( (map1.type() == CV_32FC2 && map2.empty()) ||
+                       (map1.type() == CV_32FC1 && map2.type() == CV_32FC1) );
+            convertMaps(map1, map2, xy, a, CV_16SC2, nn);
+        }
+
+        if( relative )
+        {
+            // the offsets are added once here, so the tiles are remapped with absolute coordinates
+            for( int y = 0; y < size.height; y++ )
+            {
+                short* XY = xy.ptr<short>(y);
+                for( int x = 0; x < size.width; x++ )
+                {
+                    XY[x*2] = saturate_cast<short>(XY[x*2] + x);
+                    XY[x*2+1] = saturate_cast<short>(XY[x*2+1] + y);
+                }
+            }
+        }
+
+        buildTiles(xy, a);
+    }
+
+    void apply(InputArray _src, OutputArray _dst) const CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat src = _src.getMat();
+        CV_Assert( !src.empty() && src.dims <= 2 && src.cols < SHRT_MAX && src.rows < SHRT_MAX );
+        _dst.create(size, src.type());
+        Mat dst = _dst.getMat();
+        if( dst.data == src.data )
+            src = src.clone();
+
+        RemapNNFunc nnfunc = 0;
+        RemapFunc ifunc = 0;
+        const void* ctab = 0;
+        getRemapFuncs(interpolation, src.type(), false, nnfunc, ifunc, ctab);
+
+        parallel_for_(Range(0, (int)tiles.size()), [&](const Range& range)
+        {
+            for( int i = range.start; i < range.end; i++ )
+            {
+                const Tile& t = tiles[i];
+                Mat dpart(dst, t.r);
+                Mat xy(t.r.size(), CV_16SC2, (void*)tileXY.ptr<short>(0, (int)t.ofs));
+                if( nnfunc )
+                    nnfunc(src, dpart, xy, borderType, borderValue, t.r.tl());
+                else
+                {
+                    Mat a(t.r.size(), CV_16UC1, (void*)tileA.ptr<ushort>(0, (int)t.ofs));
+                    ifunc(src, dpart, xy, a, ctab, borderType, borderValue, t.r.tl());
+                }
+            }
+        }, dst.total()/(double)(1<<16));
+    }
+
+    Size getSize() const CV_OVERRIDE { return size; }
+
+private:
+    struct Tile
+    {
+        Rect r;
+        size_t ofs; // offset of the first pixel of the tile in tileXY and tileA
+        int64 key;  // position of the source block the tile reads from
+    };
+
+    static bool tileLess(const Tile& a, const Tile& b) { return a.key < b.key; }
+
+    /* Copies the maps tile by tile, so each tile reads a contiguous piece of memory.
+
+    The tiles are ordered by the position of their source area (mean source point), in the order of
+    the source blocks. Neighbor tiles, which are likely to be processed by the same thread, then read
+    the same source rows, even if the transformation rotates or flips the image.
+    */
+    void buildTiles(const Mat& xy, const Mat& a)
+    {
+        int nx = (size.width + REMAP_TILE_SIZE - 1)/REMAP_TILE_SIZE;
+        int ny = (size.height + REMAP_TILE_SIZE - 1)/REMAP_TILE_SIZE;
+        tiles.resize((size_t)nx*ny);
+        for( int ty = 0; ty < ny; ty++ )
+            for( int tx = 0; tx < nx; tx++ )
+            {
+                Tile& t = tiles[(size_t)ty*nx + tx];
+                t.r = Rect(tx*REMAP_TILE_SIZE, ty*REMAP_TILE_SIZE, REMAP_TILE_SIZE, REMAP_TILE_SIZE) & Rect(Point(), size);
+                Scalar c = mean(xy(t.r));
+                int bx = cvFloor(c[0]/REMAP_TILE_SIZE), by = cvFloor(c[1]/REMAP_TILE_SIZE);
+                t.key = ((int64)by << 32) + bx;
+            }
+        std::stable_sort(tiles.begin(), tiles.end(), tileLess);
+
+        tileXY.create(1, size.area(), CV_16SC2);
+        if( !a.empty() )
+            tileA.create(1, size.area(), CV_16UC1);
+        size_t ofs = 0;
+        for( size_t i = 0; i < tiles.size(); i++ )
+        {
+            Tile& t = tiles[i];
+            t.ofs = ofs;
+            xy(t.r).copyTo(Mat(t.r.size(), CV_16SC2, tileXY.ptr<short>(0, (int)ofs)));
+            if( !a.empty() )
+                a(t.r).copyTo(Mat(t.r.size(), CV_16UC1, tileA.ptr<ushort>(0, (int)ofs)));
+            ofs += t.r.area();
+        }
+    }
+
+    Size size;
+    int interpolation, borderType;
+    Scalar borderValue;
+    std::vector<Tile> tiles;
+    Mat tileXY, tileA;
+};
+
+} // cv::
+
+cv::Ptr<cv::RemapPlan> cv::createRemapPlan( InputArray map1, InputArray map2, int interpolation,
+                                            int borderMode, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
+    return makePtr<RemapPlanImpl>(map1.getMat(), map2.getMat(), interpolation, borderMode, borderValue);
+}
+
 
 namespace cv
 {
@@ -2901,6 +3091,68 @@ void cv::warpAffine( InputArray _src, OutputArray _dst,
                     M, interpolation, borderType, borderValue.val);
 }
 
+void cv::warpAffineBatch( InputArray _src, InputArrayOfArrays _Ms, OutputArray _dst, Size dsize,
+                          int flags, int borderType, const Scalar& borderValue, int layout )
+{
+    CV_INSTRUMENT_REGION();
+
+    int interpolation = flags & INTER_MAX;
+    CV_Assert( _src.channels() <= 4 || (interpolation != INTER_LANCZOS4 &&
+                                        interpolation != INTER_CUBIC) );
+    if( interpolation == INTER_AREA )
+        interpolation = INTER_LINEAR;
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 && !dsize.empty() );
+    int type = src.type(), n = (int)_Ms.total();
+    CV_Assert( n > 0 );
+
+    std::vector<double> coeffs(n*6);
+    for( int i = 0; i < n; i++ )
+    {
+        Mat M0 = _Ms.getMat(i), matM(2, 3, CV_64F, &coeffs[i*6]);
+        CV_Assert( (M0.type() == CV_32F || M0.type() == CV_64F) && M0.rows == 2 && M0.cols == 3 );
+        M0.convertTo(matM, matM.type());
+        if( !(flags & WARP_INVERSE_MAP) )
+            invertAffineTransform(matM, matM);
+    }
+
+    Mat batch = createImageBatch(_dst, n, dsize, type, layout);
+    if( batch.data == src.data )
+        src = src.clone();
+
+    auto body = [&](const Range& range)
+    {
+        Mat img, buf;
+        std::vector<Mat> planes;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            getBatchImage(batch, i, layout, img, planes);
+            Mat out = img;
+            if( img.empty() )
+            {
+                buf.create(dsize, type);
+                // the pixels of outliers keep the values of the batch
+                if( borderType == BORDER_TRANSPARENT )
+                    merge(planes, buf);
+                out = buf;
+            }
+
+            hal::warpAffine(type, src.data, src.step, src.cols, src.rows, out.data, out.step, out.cols, out.rows,
+                            &coeffs[i*6], interpolation, borderType, borderValue.val);
+
+            if( img.empty() )
+                split(out, planes);
+        }
+    };
+
+    // see resizeBatch
+    if( n >= getNumThreads() )
+        parallel_for_(Range(0, n), body, n);
+    else
+        body(Range(0, n));
+}
+
 
 namespace cv
 {
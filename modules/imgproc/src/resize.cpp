@@ -59,6 +59,8 @@
 #include "opencv2/core/softfloat.hpp"
 #include "fixedpoint.inl.hpp"
 
+#include <map>
+
 using namespace cv;
 
 namespace
@@ -3821,31 +3823,8 @@ static bool ipp_resize(const uchar * src_data, size_t src_step, int src_width, i
 
 //==================================================================================================
 
-namespace hal {
-
-void resize(int src_type,
-            const uchar * src_data, size_t src_step, int src_width, int src_height,
-            uchar * dst_data, size_t dst_step, int dst_width, int dst_height,
-            double inv_scale_x, double inv_scale_y, int interpolation)
+static ResizeFunc getResizeGenericFunc(int interpolation, int depth)
 {
-    CV_INSTRUMENT_REGION();
-
-    CV_Assert((dst_width > 0 && dst_height > 0) || (inv_scale_x > 0 && inv_scale_y > 0));
-    if (inv_scale_x < DBL_EPSILON || inv_scale_y < DBL_EPSILON)
-    {
-        inv_scale_x = static_cast<double>(dst_width) / src_width;
-        inv_scale_y = static_cast<double>(dst_height) / src_height;
-    }
-
-    CALL_HAL(resize, cv_hal_resize, src_type, src_data, src_step, src_width, src_height, dst_data, dst_step, dst_width, dst_height, inv_scale_x, inv_scale_y, interpolation);
-
-    int  depth = CV_MAT_DEPTH(src_type), cn = CV_MAT_CN(src_type);
-    Size dsize = Size(saturate_cast<int>(src_width*inv_scale_x),
-                        saturate_cast<int>(src_height*inv_scale_y));
-    CV_Assert( !dsize.empty() );
-
-    CV_IPP_RUN_FAST(ipp_resize(src_data, src_step, src_width, src_height, dst_data, dst_step, dsize.width, dsize.height, inv_scale_x, inv_scale_y, depth, cn, interpolation))
-
     static ResizeFunc linear_tab[] =
     {
         resizeGeneric_<
@@ -3931,6 +3910,231 @@ void resize(int src_type,
         0
     };
 
+    if( interpolation == INTER_CUBIC )
+        return cubic_tab[depth];
+    if( interpolation == INTER_LANCZOS4 )
+        return lanczos4_tab[depth];
+    return linear_tab[depth];
+}
+
+/* Coefficient tables of the separable resize: INTER_LINEAR, INTER_CUBIC, INTER_LANCZOS4 and the
+   bilinear emulation of INTER_AREA. The tables depend on the sizes only, not on the image content,
+   so one instance may be applied to any number of images of the same size and type. */
+class ResizeGenericTabs
+{
+public:
+    ResizeGenericTabs(int type, Size ssize, Size dsize, double inv_scale_x, double inv_scale_y, int interpolation);
+
+    void operator()(const Mat& src, Mat& dst) const
+    {
+        func( src, dst, xofs, alphaTab, yofs, betaTab, xmin, xmax, ksize );
+    }
+
+private:
+    ResizeFunc func;
+    AutoBuffer<uchar> buffer;
+    int* xofs, *yofs;
+    void* alphaTab, *betaTab;
+    int xmin, xmax, ksize;
+
+    ResizeGenericTabs(const ResizeGenericTabs&); // = delete
+    ResizeGenericTabs& operator=(const ResizeGenericTabs&); // = delete
+};
+
+ResizeGenericTabs::ResizeGenericTabs(int type, Size ssize, Size dsize, double inv_scale_x, double inv_scale_y,
+                                     int interpolation)
+{
+    int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    int src_width = ssize.width;
+    double scale_x = 1./inv_scale_x, scale_y = 1./inv_scale_y;
+    int k, sx, sy, dx, dy;
+
+    xmin = 0, xmax = dsize.width;
+    int width = dsize.width*cn;
+    bool area_mode = interpolation == INTER_AREA;
+    bool fixpt = depth == CV_8U;
+    float fx, fy;
+    int ksize2;
+    if( interpolation == INTER_CUBIC )
+        ksize = 4;
+    else if( interpolation == INTER_LANCZOS4 )
+        ksize = 8;
+    else if( interpolation == INTER_LINEAR || interpolation == INTER_AREA )
+        ksize = 2;
+    else
+        CV_Error( cv::Error::StsBadArg, "Unknown interpolation method" );
+    ksize2 = ksize/2;
+
+    func = getResizeGenericFunc(interpolation, depth);
+    CV_Assert( func != 0 );
+
+    buffer.allocate((width + dsize.height)*(sizeof(int) + sizeof(float)*ksize));
+    xofs = (int*)buffer.data();
+    yofs = xofs + width;
+    float* alpha = (float*)(yofs + dsize.height);
+    short* ialpha = (short*)alpha;
+    float* beta = alpha + width*ksize;
+    short* ibeta = ialpha + width*ksize;
+    float cbuf[MAX_ESIZE] = {0};
+
+    for( dx = 0; dx < dsize.width; dx++ )
+    {
+        if( !area_mode )
+        {
+            fx = (float)((dx+0.5)*scale_x - 0.5);
+            sx = cvFloor(fx);
+            fx -= sx;
+        }
+        else
+        {
+            sx = cvFloor(dx*scale_x);
+            fx = (float)((dx+1) - (sx+1)*inv_scale_x);
+            fx = fx <= 0 ? 0.f : fx - cvFloor(fx);
+        }
+
+        if( sx < ksize2-1 )
+        {
+            xmin = dx+1;
+            if( sx < 0 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
+                fx = 0, sx = 0;
+        }
+
+        if( sx + ksize2 >= src_width )
+        {
+            xmax = std::min( xmax, dx );
+            if( sx >= src_width-1 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
+                fx = 0, sx = src_width-1;
+        }
+
+        for( k = 0, sx *= cn; k < cn; k++ )
+            xofs[dx*cn + k] = sx + k;
+
+        if( interpolation == INTER_CUBIC )
+            interpolateCubic( fx, cbuf );
+        else if( interpolation == INTER_LANCZOS4 )
+            interpolateLanczos4( fx, cbuf );
+        else
+        {
+            cbuf[0] = 1.f - fx;
+            cbuf[1] = fx;
+        }
+        if( fixpt )
+        {
+            for( k = 0; k < ksize; k++ )
+                ialpha[dx*cn*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
+            for( ; k < cn*ksize; k++ )
+                ialpha[dx*cn*ksize + k] = ialpha[dx*cn*ksize + k - ksize];
+        }
+        else
+        {
+            for( k = 0; k < ksize; k++ )
+                alpha[dx*cn*ksize + k] = cbuf[k];
+            for( ; k < cn*ksize; k++ )
+                alpha[dx*cn*ksize + k] = alpha[dx*cn*ksize + k - ksize];
+        }
+    }
+
+    for( dy = 0; dy < dsize.height; dy++ )
+    {
+        if( !area_mode )
+        {
+            fy = (float)((dy+0.5)*scale_y - 0.5);
+            sy = cvFloor(fy);
+            fy -= sy;
+        }
+        else
+        {
+            sy = cvFloor(dy*scale_y);
+            fy = (float)((dy+1) - (sy+1)*inv_scale_y);
+            fy = fy <= 0 ? 0.f : fy - cvFloor(fy);
+        }
+
+        yofs[dy] = sy;
+        if( interpolation == INTER_CUBIC )
+            interpolateCubic( fy, cbuf );
+        else if( interpolation == INTER_LANCZOS4 )
+            interpolateLanczos4( fy, cbuf );
+        else
+        {
+            cbuf[0] = 1.f - fy;
+            cbuf[1] = fy;
+        }
+
+        if( fixpt )
+        {
+            for( k = 0; k < ksize; k++ )
+                ibeta[dy*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
+        }
+        else
+        {
+            for( k = 0; k < ksize; k++ )
+                beta[dy*ksize + k] = cbuf[k];
+        }
+    }
+
+    alphaTab = fixpt ? (void*)ialpha : (void*)alpha;
+    betaTab = fixpt ? (void*)ibeta : (void*)beta;
+}
+
+// Returns true if hal::resize uses the separable implementation (see ResizeGenericTabs) for the given
+// parameters. Must be kept in sync with the special cases of hal::resize.
+static bool isResizeGeneric(double inv_scale_x, double inv_scale_y, int interpolation)
+{
+    if( interpolation == INTER_NEAREST || interpolation == INTER_NEAREST_EXACT ||
+        interpolation == INTER_LINEAR_EXACT )
+        return false;
+
+    double scale_x = 1./inv_scale_x, scale_y = 1./inv_scale_y;
+    int iscale_x = saturate_cast<int>(scale_x);
+    int iscale_y = saturate_cast<int>(scale_y);
+    bool is_area_fast = std::abs(scale_x - iscale_x) < DBL_EPSILON &&
+            std::abs(scale_y - iscale_y) < DBL_EPSILON;
+
+    if( interpolation == INTER_LINEAR && is_area_fast && iscale_x == 2 && iscale_y == 2 )
+        return false;
+    return !(interpolation == INTER_AREA && scale_x >= 1 && scale_y >= 1);
+}
+
+// Runs the HAL or IPP implementation of the resize if there is one, in the same order as hal::resize.
+static bool resizeHalOrIpp(int type, const Mat& src, Mat& dst, double inv_scale_x, double inv_scale_y, int interpolation)
+{
+    int res = cv_hal_resize(type, src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows,
+                            inv_scale_x, inv_scale_y, interpolation);
+    if (res == CV_HAL_ERROR_OK)
+        return true;
+    else if (res != CV_HAL_ERROR_NOT_IMPLEMENTED)
+        CV_Error_(cv::Error::StsInternal, ("HAL implementation resize ==> cv_hal_resize returned %d (0x%08x)", res, res));
+
+    CV_IPP_RUN_FAST(ipp_resize(src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows,
+                               inv_scale_x, inv_scale_y, CV_MAT_DEPTH(type), CV_MAT_CN(type), interpolation), true)
+    return false;
+}
+
+namespace hal {
+
+void resize(int src_type,
+            const uchar * src_data, size_t src_step, int src_width, int src_height,
+            uchar * dst_data, size_t dst_step, int dst_width, int dst_height,
+            double inv_scale_x, double inv_scale_y, int interpolation)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert((dst_width > 0 && dst_height > 0) || (inv_scale_x > 0 && inv_scale_y > 0));
+    if (inv_scale_x < DBL_EPSILON || inv_scale_y < DBL_EPSILON)
+    {
+        inv_scale_x = static_cast<double>(dst_width) / src_width;
+        inv_scale_y = static_cast<double>(dst_height) / src_height;
+    }
+
+    CALL_HAL(resize, cv_hal_resize, src_type, src_data, src_step, src_width, src_height, dst_data, dst_step, dst_width, dst_height, inv_scale_x, inv_scale_y, interpolation);
+
+    int  depth = CV_MAT_DEPTH(src_type), cn = CV_MAT_CN(src_type);
+    Size dsize = Size(saturate_cast<int>(src_width*inv_scale_x),
+                        saturate_cast<int>(src_height*inv_scale_y));
+    CV_Assert( !dsize.empty() );
+
+    CV_IPP_RUN_FAST(ipp_resize(src_data, src_step, src_width, src_height, dst_data, dst_step, dsize.width, dsize.height, inv_scale_x, inv_scale_y, depth, cn, interpolation))
+
     static ResizeAreaFastFunc areafast_tab[] =
     {
         resizeAreaFast_<uchar, int, ResizeAreaFastVec<uchar, ResizeAreaFastVec_SIMD_8u> >,
@@ -4067,130 +4271,8 @@ void resize(int src_type,
         }
     }
 
-    int xmin = 0, xmax = dsize.width, width = dsize.width*cn;
-    bool area_mode = interpolation == INTER_AREA;
-    bool fixpt = depth == CV_8U;
-    float fx, fy;
-    ResizeFunc func=0;
-    int ksize=0, ksize2;
-    if( interpolation == INTER_CUBIC )
-        ksize = 4, func = cubic_tab[depth];
-    else if( interpolation == INTER_LANCZOS4 )
-        ksize = 8, func = lanczos4_tab[depth];
-    else if( interpolation == INTER_LINEAR || interpolation == INTER_AREA )
-        ksize = 2, func = linear_tab[depth];
-    else
-        CV_Error( cv::Error::StsBadArg, "Unknown interpolation method" );
-    ksize2 = ksize/2;
-
-    CV_Assert( func != 0 );
-
-    AutoBuffer<uchar> _buffer((width + dsize.height)*(sizeof(int) + sizeof(float)*ksize));
-    int* xofs = (int*)_buffer.data();
-    int* yofs = xofs + width;
-    float* alpha = (float*)(yofs + dsize.height);
-    short* ialpha = (short*)alpha;
-    float* beta = alpha + width*ksize;
-    short* ibeta = ialpha + width*ksize;
-    float cbuf[MAX_ESIZE] = {0};
-
-    for( dx = 0; dx < dsize.width; dx++ )
-    {
-        if( !area_mode )
-        {
-            fx = (float)((dx+0.5)*scale_x - 0.5);
-            sx = cvFloor(fx);
-            fx -= sx;
-        }
-        else
-        {
-            sx = cvFloor(dx*scale_x);
-            fx = (float)((dx+1) - (sx+1)*inv_scale_x);
-            fx = fx <= 0 ? 0.f : fx - cvFloor(fx);
-        }
-
-        if( sx < ksize2-1 )
-        {
-            xmin = dx+1;
-            if( sx < 0 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
-                fx = 0, sx = 0;
-        }
-
-        if( sx + ksize2 >= src_width )
-        {
-            xmax = std::min( xmax, dx );
-            if( sx >= src_width-1 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
-                fx = 0, sx = src_width-1;
-        }
-
-        for( k = 0, sx *= cn; k < cn; k++ )
-            xofs[dx*cn + k] = sx + k;
-
-        if( interpolation == INTER_CUBIC )
-            interpolateCubic( fx, cbuf );
-        else if( interpolation == INTER_LANCZOS4 )
-            interpolateLanczos4( fx, cbuf );
-        else
-        {
-            cbuf[0] = 1.f - fx;
-            cbuf[1] = fx;
-        }
-        if( fixpt )
-        {
-            for( k = 0; k < ksize; k++ )
-                ialpha[dx*cn*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
-            for( ; k < cn*ksize; k++ )
-                ialpha[dx*cn*ksize + k] = ialpha[dx*cn*ksize + k - ksize];
-        }
-        else
-        {
-            for( k = 0; k < ksize; k++ )
-                alpha[dx*cn*ksize + k] = cbuf[k];
-            for( ; k < cn*ksize; k++ )
-                alpha[dx*cn*ksize + k] = alpha[dx*cn*ksize + k - ksize];
-        }
-    }
-
-    for( dy = 0; dy < dsize.height; dy++ )
-    {
-        if( !area_mode )
-        {
-            fy = (float)((dy+0.5)*scale_y - 0.5);
-            sy = cvFloor(fy);
-            fy -= sy;
-        }
-        else
-        {
-            sy = cvFloor(dy*scale_y);
-            fy = (float)((dy+1) - (sy+1)*inv_scale_y);
-            fy = fy <= 0 ? 0.f : fy - cvFloor(fy);
-        }
-
-        yofs[dy] = sy;
-        if( interpolation == INTER_CUBIC )
-            interpolateCubic( fy, cbuf );
-        else if( interpolation == INTER_LANCZOS4 )
-            interpolateLanczos4( fy, cbuf );
-        else
-        {
-            cbuf[0] = 1.f - fy;
-            cbuf[1] = fy;
-        }
-
-        if( fixpt )
-        {
-            for( k = 0; k < ksize; k++ )
-                ibeta[dy*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
-        }
-        else
-        {
-            for( k = 0; k < ksize; k++ )
-                beta[dy*ksize + k] = cbuf[k];
-        }
-    }
-
-    func( src, dst, xofs, fixpt ? (void*)ialpha : (void*)alpha, yofs,
-          fixpt ? (void*)ibeta : (void*)beta, xmin, xmax, ksize );
+    ResizeGenericTabs tabs(src_type, Size(src_width, src_height), dsize, inv_scale_x, inv_scale_y, interpolation);
+    tabs(src, dst);
 }
 
 } // cv::hal::
@@ -4245,6 +4327,130 @@ void cv::resize( InputArray _src, OutputArray _dst, Size dsize,
     hal::resize(src.type(), src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows, inv_scale_x, inv_scale_y, interpolation);
 }
 
+//==================================================================================================
+
+namespace cv {
+
+Mat createImageBatch(OutputArray _dst, int nimages, Size size, int type, int layout)
+{
+    CV_Assert( nimages > 0 && !size.empty() );
+    CV_Assert( layout == BATCH_NHWC || layout == BATCH_NCHW );
+    int cn = CV_MAT_CN(type);
+    int nhwc[] = { nimages, size.height, size.width, cn };
+    int nchw[] = { nimages, cn, size.height, size.width };
+    _dst.create(4, layout == BATCH_NHWC ? nhwc : nchw, CV_MAT_DEPTH(type));
+    return _dst.getMat();
+}
+
+void getBatchImage(const Mat& batch, int i, int layout, Mat& img, std::vector<Mat>& planes)
+{
+    CV_Assert( batch.dims == 4 && batch.channels() == 1 && 0 <= i && i < batch.size[0] );
+    int depth = batch.depth();
+    if( layout == BATCH_NHWC )
+    {
+        img = Mat(batch.size[1], batch.size[2], CV_MAKETYPE(depth, batch.size[3]),
+                  (void*)batch.ptr(i), batch.step[1]);
+        planes.clear();
+        return;
+    }
+
+    CV_Assert( layout == BATCH_NCHW );
+    int cn = batch.size[1];
+    planes.resize(cn);
+    for( int c = 0; c < cn; c++ )
+        planes[c] = Mat(batch.size[2], batch.size[3], depth, (void*)batch.ptr(i, c), batch.step[2]);
+    if( cn == 1 )
+    {
+        img = planes[0];
+        planes.clear();
+    }
+    else
+        img.release();
+}
+
+} // cv::
+
+void cv::resizeBatch( InputArray _src, const std::vector<Rect>& rois, OutputArray _dst, Size dsize,
+                      int interpolation, int layout )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 && !rois.empty() && !dsize.empty() );
+    int type = src.type(), nrois = (int)rois.size();
+    for( int i = 0; i < nrois; i++ )
+        CV_Assert( !rois[i].empty() && (rois[i] & Rect(Point(), src.size())) == rois[i] );
+
+    if (interpolation == INTER_LINEAR_EXACT && (src.depth() == CV_32F || src.depth() == CV_64F))
+        interpolation = INTER_LINEAR;
+
+    Mat batch = createImageBatch(_dst, nrois, dsize, type, layout);
+    if( batch.data == src.data )
+        src = src.clone();
+
+    // ROIs of the same size share the interpolation tables
+    std::vector<int> tabIdx(nrois, -1);
+    std::vector<Ptr<ResizeGenericTabs> > tabs;
+    std::map<std::pair<int, int>, int> tabBySize;
+    for( int i = 0; i < nrois; i++ )
+    {
+        Size ssize = rois[i].size();
+        double inv_scale_x = (double)dsize.width/ssize.width, inv_scale_y = (double)dsize.height/ssize.height;
+        if( ssize == dsize || !isResizeGeneric(inv_scale_x, inv_scale_y, interpolation) )
+            continue;
+        std::pair<int, int> key(ssize.width, ssize.height);
+        std::map<std::pair<int, int>, int>::const_iterator it = tabBySize.find(key);
+        if( it == tabBySize.end() )
+        {
+            it = tabBySize.insert(std::make_pair(key, (int)tabs.size())).first;
+            tabs.push_back(makePtr<ResizeGenericTabs>(type, ssize, dsize, inv_scale_x, inv_scale_y, interpolation));
+        }
+        tabIdx[i] = it->second;
+    }
+
+    auto body = [&](const Range& range)
+    {
+        Mat img, buf;
+        std::vector<Mat> planes;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            getBatchImage(batch, i, layout, img, planes);
+            Mat out = img;
+            if( img.empty() )
+            {
+                buf.create(dsize, type);
+                out = buf;
+            }
+
+            Mat roi = src(rois[i]);
+            double inv_scale_x = (double)dsize.width/roi.cols, inv_scale_y = (double)dsize.height/roi.rows;
+
+            if( roi.size() == dsize )
+                roi.copyTo(out);
+            else if( tabIdx[i] >= 0 )
+            {
+                // the shared tables replace only the generic implementation of hal::resize
+                if( !resizeHalOrIpp(type, roi, out, inv_scale_x, inv_scale_y, interpolation) )
+                    (*tabs[tabIdx[i]])(roi, out);
+            }
+            else
+                hal::resize(type, roi.data, roi.step, roi.cols, roi.rows, out.data, out.step, out.cols, out.rows,
+                            inv_scale_x, inv_scale_y, interpolation);
+
+            if( img.empty() )
+                split(out, planes);
+        }
+    };
+
+    // The ROIs are usually small, so they are distributed between the threads instead of
+    // parallelizing each resize (parallel_for_ invoked from a worker thread runs sequentially).
+    // When there are fewer ROIs than threads, they are resized one by one, each in parallel.
+    if( nrois >= getNumThreads() )
+        parallel_for_(Range(0, nrois), body, nrois);
+    else
+        body(Range(0, nrois));
+}
+
 #ifndef OPENCV_EXCLUDE_C_API
 
 CV_IMPL void
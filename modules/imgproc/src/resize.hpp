@@ -79,6 +79,12 @@ void resizeNN4_LASX(const Range&, const Mat&, Mat&, int*, double);
 #endif
 }
 
+// Creates the output of a batched transformation (see resizeBatch) as a 4D single-channel matrix
+Mat createImageBatch(OutputArray dst, int nimages, Size size, int type, int layout);
+// Returns the i-th image of a batch as a matrix header in img. When the layout keeps the channels
+// of the image in separate planes, img is released and the headers of the planes are returned instead.
+void getBatchImage(const Mat& batch, int i, int layout, Mat& img, std::vector<Mat>& planes);
+
 }
 #endif
 /* End of file. */
@@ -82,13 +82,43 @@ allocWSNodes( std::vector<WSNode>& storage )
     return sz;
 }
 
+// Pixel next to a marker, the flooding starts from such pixels
+struct WSSeed
+{
+    int mask_ofs;
+    int img_ofs;
+    int priority;
+};
+
+// Images with fewer pixels are processed by a single flood
+static const int WS_MIN_PARALLEL_PIXELS = 1 << 18;
+
+// MAX(a,b) = b + MAX(a-b,0)
+#define ws_max(a,b) ((b) + subs_tab[(a)-(b)+256])
+// MIN(a,b) = a - MAX(a-b,0)
+#define ws_min(a,b) ((a) - subs_tab[(a)-(b)+256])
+
+// Get highest absolute channel difference in diff
+#define c_diff(ptr1,ptr2,diff)           \
+{                                        \
+    db = std::abs((ptr1)[0] - (ptr2)[0]);\
+    dg = std::abs((ptr1)[1] - (ptr2)[1]);\
+    dr = std::abs((ptr1)[2] - (ptr2)[2]);\
+    diff = ws_max(db,dg);                \
+    diff = ws_max(diff,dr);              \
+    CV_Assert( 0 <= diff && diff <= 255 );  \
 }
 
+/* Fills the basins starting from the seeds, which must be listed in the raster order.
 
-void cv::watershed( InputArray _src, InputOutputArray _markers )
+The flood only visits the pixels which are 4-connected to the seeds through unlabeled pixels,
+so floods of different connected components of the unlabeled area are independent.
+The node storage and its free list (free_node) may be reused by subsequent calls.
+*/
+static void
+floodWatershed( const Mat& src, Mat& dst, const WSSeed* seeds, int nseeds, const int* subs_tab,
+                std::vector<WSNode>& storage, int& free_node )
 {
-    CV_INSTRUMENT_REGION();
-
     // Labels for pixels
     const int IN_QUEUE = -2; // Pixel visited
     const int WSHED = -1; // Pixel belongs to watershed
@@ -96,26 +126,15 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
     // possible bit values = 2^8
     const int NQ = 256;
 
-    Mat src = _src.getMat(), dst = _markers.getMat();
-    Size size = src.size();
-
-    // Vector of every created node
-    std::vector<WSNode> storage;
-    int free_node = 0, node;
+    int node;
     // Priority queue of queues of nodes
     // from high priority (0) to low priority (255)
     WSQueue q[NQ];
     // Non-empty queue with highest priority
     int active_queue;
-    int i, j;
+    int i;
     // Color differences
     int db, dg, dr;
-    int subs_tab[513];
-
-    // MAX(a,b) = b + MAX(a-b,0)
-    #define ws_max(a,b) ((b) + subs_tab[(a)-(b)+NQ])
-    // MIN(a,b) = a - MAX(a-b,0)
-    #define ws_min(a,b) ((a) - subs_tab[(a)-(b)+NQ])
 
     // Create a new node with offsets mofs and iofs in queue idx
     #define ws_push(idx,mofs,iofs)          \
@@ -147,80 +166,14 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         iofs = storage[node].img_ofs;       \
     }
 
-    // Get highest absolute channel difference in diff
-    #define c_diff(ptr1,ptr2,diff)           \
-    {                                        \
-        db = std::abs((ptr1)[0] - (ptr2)[0]);\
-        dg = std::abs((ptr1)[1] - (ptr2)[1]);\
-        dr = std::abs((ptr1)[2] - (ptr2)[2]);\
-        diff = ws_max(db,dg);                \
-        diff = ws_max(diff,dr);              \
-        CV_Assert( 0 <= diff && diff <= 255 );  \
-    }
-
-    CV_Assert( src.type() == CV_8UC3 && dst.type() == CV_32SC1 );
-    CV_Assert( src.size() == dst.size() );
-
-    // Current pixel in input image
-    const uchar* img = src.ptr();
     // Step size to next row in input image
-    int istep = int(src.step/sizeof(img[0]));
-
-    // Current pixel in mask image
-    int* mask = dst.ptr<int>();
+    int istep = int(src.step/sizeof(src.data[0]));
     // Step size to next row in mask image
-    int mstep = int(dst.step / sizeof(mask[0]));
-
-    for( i = 0; i < 256; i++ )
-        subs_tab[i] = 0;
-    for( i = 256; i <= 512; i++ )
-        subs_tab[i] = i - 256;
+    int mstep = int(dst.step/sizeof(int));
 
-    // draw a pixel-wide border of dummy "watershed" (i.e. boundary) pixels
-    for( j = 0; j < size.width; j++ )
-        mask[j] = mask[j + mstep*(size.height-1)] = WSHED;
-
-    // initial phase: put all the neighbor pixels of each marker to the ordered queue -
-    // determine the initial boundaries of the basins
-    for( i = 1; i < size.height-1; i++ )
-    {
-        img += istep; mask += mstep;
-        mask[0] = mask[size.width-1] = WSHED; // boundary pixels
-
-        for( j = 1; j < size.width-1; j++ )
-        {
-            int* m = mask + j;
-            if( m[0] < 0 ) m[0] = 0;
-            if( m[0] == 0 && (m[-1] > 0 || m[1] > 0 || m[-mstep] > 0 || m[mstep] > 0) )
-            {
-                // Find smallest difference to adjacent markers
-                const uchar* ptr = img + j*3;
-                int idx = 256, t;
-                if( m[-1] > 0 )
-                    c_diff( ptr, ptr - 3, idx );
-                if( m[1] > 0 )
-                {
-                    c_diff( ptr, ptr + 3, t );
-                    idx = ws_min( idx, t );
-                }
-                if( m[-mstep] > 0 )
-                {
-                    c_diff( ptr, ptr - istep, t );
-                    idx = ws_min( idx, t );
-                }
-                if( m[mstep] > 0 )
-                {
-                    c_diff( ptr, ptr + istep, t );
-                    idx = ws_min( idx, t );
-                }
-
-                // Add to according queue
-                CV_Assert( 0 <= idx && idx <= 255 );
-                ws_push( idx, i*mstep + j, i*istep + j*3 );
-                m[0] = IN_QUEUE;
-            }
-        }
-    }
+    // put the seeds to the ordered queue
+    for( i = 0; i < nseeds; i++ )
+        ws_push( seeds[i].priority, seeds[i].mask_ofs, seeds[i].img_ofs );
 
     // find the first non-empty queue
     for( i = 0; i < NQ; i++ )
@@ -232,8 +185,8 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         return;
 
     active_queue = i;
-    img = src.ptr();
-    mask = dst.ptr<int>();
+    const uchar* img = src.ptr();
+    int* mask = dst.ptr<int>();
 
     // recursively fill the basins
     for(;;)
@@ -322,8 +275,162 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
             m[mstep] = IN_QUEUE;
         }
     }
+
+    #undef ws_push
+    #undef ws_pop
 }
 
+}
+
+
+void cv::watershed( InputArray _src, InputOutputArray _markers )
+{
+    CV_INSTRUMENT_REGION();
+
+    // Labels for pixels
+    const int IN_QUEUE = -2; // Pixel visited
+    const int WSHED = -1; // Pixel belongs to watershed
+
+    Mat src = _src.getMat(), dst = _markers.getMat();
+    Size size = src.size();
+
+    int i, j;
+    // Color differences
+    int db, dg, dr;
+    int subs_tab[513];
+
+    CV_Assert( src.type() == CV_8UC3 && dst.type() == CV_32SC1 );
+    CV_Assert( src.size() == dst.size() );
+
+    // Current pixel in input image
+    const uchar* img = src.ptr();
+    // Step size to next row in input image
+    int istep = int(src.step/sizeof(img[0]));
+
+    // Current pixel in mask image
+    int* mask = dst.ptr<int>();
+    // Step size to next row in mask image
+    int mstep = int(dst.step / sizeof(mask[0]));
+
+    for( i = 0; i < 256; i++ )
+        subs_tab[i] = 0;
+    for( i = 256; i <= 512; i++ )
+        subs_tab[i] = i - 256;
+
+    // Connected components of the unlabeled area are flooded independently (and in parallel),
+    // the result is the same as the one of a single flood
+    bool parallel = getNumThreads() > 1 && (int64)size.width*size.height >= WS_MIN_PARALLEL_PIXELS;
+    Mat unknown;
+    if( parallel )
+        unknown = Mat::zeros(size, CV_8UC1);
+
+    // draw a pixel-wide border of dummy "watershed" (i.e. boundary) pixels
+    for( j = 0; j < size.width; j++ )
+        mask[j] = mask[j + mstep*(size.height-1)] = WSHED;
+
+    // initial phase: collect all the neighbor pixels of each marker -
+    // determine the initial boundaries of the basins
+    std::vector<WSSeed> seeds;
+    for( i = 1; i < size.height-1; i++ )
+    {
+        img += istep; mask += mstep;
+        mask[0] = mask[size.width-1] = WSHED; // boundary pixels
+        uchar* urow = parallel ? unknown.ptr(i) : 0;
+
+        for( j = 1; j < size.width-1; j++ )
+        {
+            int* m = mask + j;
+            if( m[0] < 0 ) m[0] = 0;
+            if( m[0] == 0 && (m[-1] > 0 || m[1] > 0 || m[-mstep] > 0 || m[mstep] > 0) )
+            {
+                // Find smallest difference to adjacent markers
+                const uchar* ptr = img + j*3;
+                int idx = 256, t;
+                if( m[-1] > 0 )
+                    c_diff( ptr, ptr - 3, idx );
+                if( m[1] > 0 )
+                {
+                    c_diff( ptr, ptr + 3, t );
+                    idx = ws_min( idx, t );
+                }
+                if( m[-mstep] > 0 )
+                {
+                    c_diff( ptr, ptr - istep, t );
+                    idx = ws_min( idx, t );
+                }
+                if( m[mstep] > 0 )
+                {
+                    c_diff( ptr, ptr + istep, t );
+                    idx = ws_min( idx, t );
+                }
+
+                CV_Assert( 0 <= idx && idx <= 255 );
+                WSSeed seed = { i*mstep + j, i*istep + j*3, idx };
+                seeds.push_back(seed);
+                m[0] = IN_QUEUE;
+            }
+            if( urow )
+                urow[j] = (uchar)(m[0] <= 0);
+        }
+    }
+
+    // if there is no markers, exit immediately
+    if( seeds.empty() )
+        return;
+
+    std::vector<WSNode> storage;
+    int free_node = 0;
+
+    std::vector<WSSeed> groupedSeeds;
+    std::vector<int> groupOfs;
+    if( parallel )
+    {
+        Mat labels;
+        int ncomps = connectedComponents(unknown, labels, 4, CV_32S);
+
+        // group the seeds by components, keeping the raster order inside of each group
+        std::vector<int> compOfs(ncomps + 1, 0);
+        std::vector<int> seedComp(seeds.size());
+        for( size_t k = 0; k < seeds.size(); k++ )
+        {
+            int ofs = seeds[k].mask_ofs;
+            seedComp[k] = labels.at<int>(ofs / mstep, ofs % mstep);
+            compOfs[seedComp[k] + 1]++;
+        }
+        for( int c = 0; c < ncomps; c++ )
+        {
+            if( compOfs[c + 1] > 0 )
+                groupOfs.push_back(compOfs[c]);
+            compOfs[c + 1] += compOfs[c];
+        }
+        groupOfs.push_back((int)seeds.size());
+
+        groupedSeeds.resize(seeds.size());
+        for( size_t k = 0; k < seeds.size(); k++ )
+            groupedSeeds[compOfs[seedComp[k]]++] = seeds[k];
+    }
+
+    if( groupOfs.size() <= 2 )
+    {
+        floodWatershed( src, dst, &seeds[0], (int)seeds.size(), subs_tab, storage, free_node );
+        return;
+    }
+
+    int ngroups = (int)groupOfs.size() - 1;
+    parallel_for_(Range(0, ngroups), [&](const Range& range)
+    {
+        std::vector<WSNode> localStorage;
+        int localFree = 0;
+        for( int g = range.start; g < range.end; g++ )
+            floodWatershed( src, dst, &groupedSeeds[groupOfs[g]], groupOfs[g + 1] - groupOfs[g],
+                            subs_tab, localStorage, localFree );
+    });
+}
+
+#undef ws_max
+#undef ws_min
+#undef c_diff
+
 
 /****************************************************************************************\
 *                                         Meanshift                                      *
@@ -353,7 +460,7 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
     std::vector<cv::Mat> src_pyramid(max_level+1);
     std::vector<cv::Mat> dst_pyramid(max_level+1);
     cv::Mat mask0;
-    int i, j, level;
+    int level;
     //uchar* submask = 0;
 
     #define cdiff(ofs0) (tab[c0-dptr[ofs0]+255] + \
@@ -381,7 +488,7 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
         termcrit.epsilon = 1.f;
     termcrit.epsilon = MAX(termcrit.epsilon, 0.f);
 
-    for( i = 0; i < 768; i++ )
+    for( int i = 0; i < 768; i++ )
         tab[i] = (i - 255)*(i - 255);
 
     // 1. construct pyramid
@@ -404,10 +511,7 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
     {
         cv::Mat src = src_pyramid[level];
         cv::Size size = src.size();
-        const uchar* sptr = src.ptr();
         int sstep = (int)src.step;
-        uchar* dptr;
-        int dstep;
         float sp = (float)(sp0 / (1 << level));
         sp = MAX( sp, 1 );
 
@@ -416,15 +520,15 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
         {
             cv::Size size1 = dst_pyramid[level+1].size();
             m = cv::Mat(size.height, size.width, CV_8UC1, mask0.ptr());
-            dstep = (int)dst_pyramid[level+1].step;
-            dptr = dst_pyramid[level+1].ptr() + dstep + cn;
+            int dstep = (int)dst_pyramid[level+1].step;
+            const uchar* dptr = dst_pyramid[level+1].ptr() + dstep + cn;
             cv::pyrUp( dst_pyramid[level+1], dst_pyramid[level], dst_pyramid[level].size() );
             m.setTo(cv::Scalar::all(0));
 
-            for( i = 1; i < size1.height-1; i++, dptr += dstep - (size1.width-2)*3)
+            for( int i = 1; i < size1.height-1; i++, dptr += dstep - (size1.width-2)*3)
             {
                 uchar* mask = m.ptr(1 + i * 2);
-                for( j = 1; j < size1.width-1; j++, dptr += cn )
+                for( int j = 1; j < size1.width-1; j++, dptr += cn )
                 {
                     int c0 = dptr[0], c1 = dptr[1], c2 = dptr[2];
                     mask[j*2 - 1] = cdiff(-3) || cdiff(3) || cdiff(-dstep-3) || cdiff(-dstep) ||
@@ -435,15 +539,17 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
             cv::dilate( m, m, cv::Mat() );
         }
 
-        dptr = dst_pyramid[level].ptr();
-        dstep = (int)dst_pyramid[level].step;
+        cv::Mat dst = dst_pyramid[level];
 
-        for( i = 0; i < size.height; i++, sptr += sstep - size.width*3,
-                                          dptr += dstep - size.width*3
-        )
+        // every pixel is processed independently of the others
+        cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range& range)
+        {
+        for( int i = range.start; i < range.end; i++ )
         {
-            uchar* mask = m.empty() ? NULL : m.ptr(i);
-            for( j = 0; j < size.width; j++, sptr += 3, dptr += 3 )
+            const uchar* sptr = src.ptr(i);
+            uchar* dptr = dst.ptr(i);
+            const uchar* mask = m.empty() ? NULL : m.ptr(i);
+            for( int j = 0; j < size.width; j++, sptr += 3, dptr += 3 )
             {
                 int x0 = j, y0 = i, x1, y1, iter;
                 int c0, c1, c2;
@@ -542,6 +648,7 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
                 dptr[2] = (uchar)c2;
             }
         }
+        }, (double)size.width*size.height/(1 << 14));
     }
 }
 
@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 ////////////////////////////////////////////////// matchTemplate //////////////////////////////////////////////////////////
 
@@ -903,129 +904,175 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
     }
 }
 
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+// Template statistics used by the normalization step of matchTemplate
+struct MatchTemplateStats
+{
+    Scalar mean;
+    double norm;
+    double sum2;
+    bool flat;      // zero variance, TM_CCOEFF_NORMED result is all ones
+};
+
+static MatchTemplateStats computeMatchTemplateStats( const Mat& templ, int method )
 {
+    MatchTemplateStats st;
+    st.norm = st.sum2 = 0;
+    st.flat = false;
+
     if( method == cv::TM_CCORR )
-        return;
+        return st;
 
-    int numType = method == cv::TM_CCORR || method == cv::TM_CCORR_NORMED ? 0 :
-                  method == cv::TM_CCOEFF || method == cv::TM_CCOEFF_NORMED ? 1 : 2;
-    bool isNormed = method == cv::TM_CCORR_NORMED ||
-                    method == cv::TM_SQDIFF_NORMED ||
-                    method == cv::TM_CCOEFF_NORMED;
+    if( method == cv::TM_CCOEFF )
+    {
+        st.mean = mean(templ);
+        return st;
+    }
 
+    bool ccoeff = method == cv::TM_CCOEFF_NORMED;
     double invArea = 1./((double)templ.rows * templ.cols);
+    Scalar templSdv;
+    meanStdDev( templ, st.mean, templSdv );
 
-    Mat sum, sqsum;
-    Scalar templMean, templSdv;
-    double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
-    double templNorm = 0, templSum2 = 0;
+    double templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
 
-    if( method == cv::TM_CCOEFF )
+    if( templNorm < DBL_EPSILON && ccoeff )
     {
-        integral(img, sum, CV_64F);
-        templMean = mean(templ);
+        st.flat = true;
+        return st;
     }
-    else
-    {
-        integral(img, sum, sqsum, CV_64F);
-        meanStdDev( templ, templMean, templSdv );
 
-        templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
+    double templSum2 = templNorm + st.mean[0]*st.mean[0] + st.mean[1]*st.mean[1] + st.mean[2]*st.mean[2] + st.mean[3]*st.mean[3];
 
-        if( templNorm < DBL_EPSILON && method == cv::TM_CCOEFF_NORMED )
-        {
-            result = Scalar::all(1);
-            return;
-        }
+    if( !ccoeff )
+    {
+        st.mean = Scalar::all(0);
+        templNorm = templSum2;
+    }
 
-        templSum2 = templNorm + templMean[0]*templMean[0] + templMean[1]*templMean[1] + templMean[2]*templMean[2] + templMean[3]*templMean[3];
+    templSum2 /= invArea;
+    templNorm = std::sqrt(templNorm);
+    templNorm /= std::sqrt(invArea); // care of accuracy here
 
-        if( numType != 1 )
-        {
-            templMean = Scalar::all(0);
-            templNorm = templSum2;
-        }
+    st.norm = templNorm;
+    st.sum2 = templSum2;
+    return st;
+}
+
+// Converts the cross-correlation stored in result to the requested method in place,
+// sum and sqsum are the integral images of the processed image
+static void normalizeMatchTemplate( const Mat& sum, const Mat& sqsum, Size templSize,
+                                    const MatchTemplateStats& st, Mat& result, int method, int cn )
+{
+    int numType = method == cv::TM_CCORR || method == cv::TM_CCORR_NORMED ? 0 :
+                  method == cv::TM_CCOEFF || method == cv::TM_CCOEFF_NORMED ? 1 : 2;
+    bool isNormed = method == cv::TM_CCORR_NORMED ||
+                    method == cv::TM_SQDIFF_NORMED ||
+                    method == cv::TM_CCOEFF_NORMED;
 
-        templSum2 /= invArea;
-        templNorm = std::sqrt(templNorm);
-        templNorm /= std::sqrt(invArea); // care of accuracy here
+    double invArea = 1./((double)templSize.height * templSize.width);
+    const Scalar templMean = st.mean;
+    const double templNorm = st.norm, templSum2 = st.sum2;
 
+    const double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
+    if( method != cv::TM_CCOEFF )
+    {
         CV_Assert(sqsum.data != NULL);
-        q0 = (double*)sqsum.data;
-        q1 = q0 + templ.cols*cn;
-        q2 = (double*)(sqsum.data + templ.rows*sqsum.step);
-        q3 = q2 + templ.cols*cn;
+        q0 = (const double*)sqsum.data;
+        q1 = q0 + templSize.width*cn;
+        q2 = (const double*)(sqsum.data + templSize.height*sqsum.step);
+        q3 = q2 + templSize.width*cn;
     }
 
     CV_Assert(sum.data != NULL);
-    double* p0 = (double*)sum.data;
-    double* p1 = p0 + templ.cols*cn;
-    double* p2 = (double*)(sum.data + templ.rows*sum.step);
-    double* p3 = p2 + templ.cols*cn;
+    const double* p0 = (const double*)sum.data;
+    const double* p1 = p0 + templSize.width*cn;
+    const double* p2 = (const double*)(sum.data + templSize.height*sum.step);
+    const double* p3 = p2 + templSize.width*cn;
 
     int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
     int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
 
-    int i, j, k;
-
-    for( i = 0; i < result.rows; i++ )
+    parallel_for_(Range(0, result.rows), [&](const Range& range)
     {
-        float* rrow = result.ptr<float>(i);
-        int idx = i * sumstep;
-        int idx2 = i * sqstep;
-
-        for( j = 0; j < result.cols; j++, idx += cn, idx2 += cn )
+        for( int i = range.start; i < range.end; i++ )
         {
-            double num = rrow[j], t;
-            double wndMean2 = 0, wndSum2 = 0;
+            float* rrow = result.ptr<float>(i);
+            int idx = i * sumstep;
+            int idx2 = i * sqstep;
 
-            if( numType == 1 )
+            for( int j = 0; j < result.cols; j++, idx += cn, idx2 += cn )
             {
-                for( k = 0; k < cn; k++ )
+                double num = rrow[j], t;
+                double wndMean2 = 0, wndSum2 = 0;
+
+                if( numType == 1 )
                 {
-                    t = p0[idx+k] - p1[idx+k] - p2[idx+k] + p3[idx+k];
-                    wndMean2 += t*t;
-                    num -= t*templMean[k];
-                }
+                    for( int k = 0; k < cn; k++ )
+                    {
+                        t = p0[idx+k] - p1[idx+k] - p2[idx+k] + p3[idx+k];
+                        wndMean2 += t*t;
+                        num -= t*templMean[k];
+                    }
 
-                wndMean2 *= invArea;
-            }
+                    wndMean2 *= invArea;
+                }
 
-            if( isNormed || numType == 2 )
-            {
-                for( k = 0; k < cn; k++ )
+                if( isNormed || numType == 2 )
                 {
-                    t = q0[idx2+k] - q1[idx2+k] - q2[idx2+k] + q3[idx2+k];
-                    wndSum2 += t;
+                    for( int k = 0; k < cn; k++ )
+                    {
+                        t = q0[idx2+k] - q1[idx2+k] - q2[idx2+k] + q3[idx2+k];
+                        wndSum2 += t;
+                    }
+
+                    if( numType == 2 )
+                    {
+                        num = wndSum2 - 2*num + templSum2;
+                        num = MAX(num, 0.);
+                    }
                 }
 
-                if( numType == 2 )
+                if( isNormed )
                 {
-                    num = wndSum2 - 2*num + templSum2;
-                    num = MAX(num, 0.);
+                    double diff2 = MAX(wndSum2 - wndMean2, 0);
+                    if (diff2 <= std::min(0.5, 10 * FLT_EPSILON * wndSum2))
+                        t = 0; // avoid rounding errors
+                    else
+                        t = std::sqrt(diff2)*templNorm;
+
+                    if( fabs(num) < t )
+                        num /= t;
+                    else if( fabs(num) < t*1.125 )
+                        num = num > 0 ? 1 : -1;
+                    else
+                        num = method != cv::TM_SQDIFF_NORMED ? 0 : 1;
                 }
-            }
-
-            if( isNormed )
-            {
-                double diff2 = MAX(wndSum2 - wndMean2, 0);
-                if (diff2 <= std::min(0.5, 10 * FLT_EPSILON * wndSum2))
-                    t = 0; // avoid rounding errors
-                else
-                    t = std::sqrt(diff2)*templNorm;
 
-                if( fabs(num) < t )
-                    num /= t;
-                else if( fabs(num) < t*1.125 )
-                    num = num > 0 ? 1 : -1;
-                else
-                    num = method != cv::TM_SQDIFF_NORMED ? 0 : 1;
+                rrow[j] = (float)num;
             }
-
-            rrow[j] = (float)num;
         }
+    }, result.total()*cn / (double)(1 << 16));
+}
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+{
+    if( method == cv::TM_CCORR )
+        return;
+
+    MatchTemplateStats st = computeMatchTemplateStats(templ, method);
+    if( st.flat )
+    {
+        result = Scalar::all(1);
+        return;
     }
+
+    Mat sum, sqsum;
+    if( method == cv::TM_CCOEFF )
+        integral(img, sum, CV_64F);
+    else
+        integral(img, sum, sqsum, CV_64F);
+
+    normalizeMatchTemplate(sum, sqsum, templ.size(), st, result, method, cn);
 }
 }
 
@@ -1193,6 +1240,305 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
     common_matchTemplate(img, templ, result, method, cn);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cv
+{
+
+// Templates with at most this number of pixels are correlated directly in the spatial domain
+static const int MATCHER_MAX_SPATIAL_AREA = 18*18;
+
+// dst[j] += sum_x src[j + x]*t[x], j = 0..width-1
+static void correlateRow32f( const float* src, const float* t, int tw, float* dst, int width )
+{
+    int j = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int VECSZ = VTraits<v_float32>::vlanes();
+    for( ; j <= width - 2*VECSZ; j += 2*VECSZ )
+    {
+        v_float32 s0 = vx_load(dst + j), s1 = vx_load(dst + j + VECSZ);
+        for( int x = 0; x < tw; x++ )
+        {
+            v_float32 w = vx_setall_f32(t[x]);
+            s0 = v_fma(vx_load(src + j + x), w, s0);
+            s1 = v_fma(vx_load(src + j + x + VECSZ), w, s1);
+        }
+        v_store(dst + j, s0);
+        v_store(dst + j + VECSZ, s1);
+    }
+#endif
+    for( ; j < width; j++ )
+    {
+        float s = dst[j];
+        for( int x = 0; x < tw; x++ )
+            s += src[j + x]*t[x];
+        dst[j] = s;
+    }
+}
+
+class TemplateMatcherImpl CV_FINAL : public TemplateMatcher
+{
+public:
+    TemplateMatcherImpl( const Mat& templ, int method );
+
+    void match( InputArray image, OutputArray result ) CV_OVERRIDE;
+    int getMethod() const CV_OVERRIDE { return method_; }
+    Size getTemplateSize() const CV_OVERRIDE { return templ_.size(); }
+
+private:
+    // buffers and transforms of one stripe of tiles
+    struct Workspace
+    {
+        Ptr<hal::DFT2D> fwd, inv;
+        Mat dftImg, plane, acc;
+    };
+
+    void spatialCorr( const Mat& img, Mat& corr );
+    void prepareDFT( Size imgSize );
+    void dftCorr( const Mat& img, Mat& corr );
+
+    Mat templ_;
+    int method_;
+    MatchTemplateStats stats_;
+    bool spatial_;
+    std::vector<Mat> templPlanes_, imgPlanes_;
+
+    // state of the frequency domain path, valid for images of imgSize_
+    Size imgSize_, blockSize_, dftSize_;
+    int dftDepth_;
+    Mat dftTempl_;
+    std::vector<Workspace> workspaces_;
+
+    Mat sum_, sqsum_;
+};
+
+TemplateMatcherImpl::TemplateMatcherImpl( const Mat& templ, int method )
+    : templ_(templ.clone()), method_(method), imgSize_(-1, -1)
+{
+    int depth = templ_.depth(), cn = templ_.channels();
+    stats_ = computeMatchTemplateStats(templ_, method_);
+    spatial_ = templ_.rows*templ_.cols <= MATCHER_MAX_SPATIAL_AREA;
+    // the same precision as the one of crossCorr
+    dftDepth_ = depth == CV_8U ? CV_32F : CV_64F;
+
+    if( spatial_ )
+    {
+        split(templ_, templPlanes_);
+        for( int k = 0; k < cn; k++ )
+            templPlanes_[k].convertTo(templPlanes_[k], CV_32F);
+    }
+}
+
+void TemplateMatcherImpl::spatialCorr( const Mat& img, Mat& corr )
+{
+    int cn = img.channels();
+    Size tsz = templ_.size();
+
+    if( cn == 1 && img.depth() == CV_32F )
+        imgPlanes_.assign(1, img);
+    else
+    {
+        split(img, imgPlanes_);
+        for( int k = 0; k < cn; k++ )
+            imgPlanes_[k].convertTo(imgPlanes_[k], CV_32F);
+    }
+
+    parallel_for_(Range(0, corr.rows), [&](const Range& range)
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            float* dst = corr.ptr<float>(i);
+            memset(dst, 0, corr.cols*sizeof(dst[0]));
+            for( int k = 0; k < cn; k++ )
+                for( int y = 0; y < tsz.height; y++ )
+                    correlateRow32f(imgPlanes_[k].ptr<float>(i + y), templPlanes_[k].ptr<float>(y),
+                                    tsz.width, dst, corr.cols);
+        }
+    }, (double)corr.total()*tsz.area()*cn / (1 << 20));
+}
+
+void TemplateMatcherImpl::prepareDFT( Size imgSize )
+{
+    if( imgSize == imgSize_ )
+        return;
+
+    const double blockScale = 4.5;
+    const int minBlockSize = 256;
+    int tcn = templ_.channels();
+    Size tsz = templ_.size();
+    Size corrSize(imgSize.width - tsz.width + 1, imgSize.height - tsz.height + 1);
+    Size blocksize, dftsize;
+
+    blocksize.width = cvRound(tsz.width*blockScale);
+    blocksize.width = std::max( blocksize.width, minBlockSize - tsz.width + 1 );
+    blocksize.width = std::min( blocksize.width, corrSize.width );
+    blocksize.height = cvRound(tsz.height*blockScale);
+    blocksize.height = std::max( blocksize.height, minBlockSize - tsz.height + 1 );
+    blocksize.height = std::min( blocksize.height, corrSize.height );
+
+    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + tsz.width - 1), 2);
+    dftsize.height = getOptimalDFTSize(blocksize.height + tsz.height - 1);
+    if( dftsize.width <= 0 || dftsize.height <= 0 )
+        CV_Error( cv::Error::StsOutOfRange, "the input arrays are too big" );
+
+    blocksize.width = std::min( dftsize.width - tsz.width + 1, corrSize.width );
+    blocksize.height = std::min( dftsize.height - tsz.height + 1, corrSize.height );
+
+    if( dftsize != dftSize_ )
+    {
+        // compute DFT of each template plane
+        dftTempl_.create( dftsize.height*tcn, dftsize.width, dftDepth_ );
+        dftTempl_ = Scalar::all(0);
+        Ptr<hal::DFT2D> c = hal::DFT2D::create(dftsize.width, dftsize.height, dftDepth_, 1, 1, CV_HAL_DFT_IS_INPLACE, tsz.height);
+        for( int k = 0; k < tcn; k++ )
+        {
+            Mat dst(dftTempl_, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+            Mat dst1(dst, Rect(0, 0, tsz.width, tsz.height));
+            Mat plane;
+            extractChannel(templ_, plane, k);
+            plane.convertTo(dst1, dftDepth_);
+            c->apply(dst.data, (int)dst.step, dst.data, (int)dst.step);
+        }
+    }
+
+    int tileCount = ((corrSize.width + blocksize.width - 1)/blocksize.width)*
+                    ((corrSize.height + blocksize.height - 1)/blocksize.height);
+    int nstripes = std::max(std::min(tileCount, getNumThreads()), 1);
+
+    if( dftsize != dftSize_ || blocksize != blockSize_ || (int)workspaces_.size() != nstripes )
+    {
+        int f = CV_HAL_DFT_IS_INPLACE;
+        workspaces_.assign(nstripes, Workspace());
+        for( int s = 0; s < nstripes; s++ )
+        {
+            Workspace& ws = workspaces_[s];
+            // tiles at the bottom are shorter, the transforms of the full tile height are valid for them too
+            ws.fwd = hal::DFT2D::create(dftsize.width, dftsize.height, dftDepth_, 1, 1, f, blocksize.height + tsz.height - 1);
+            ws.inv = hal::DFT2D::create(dftsize.width, dftsize.height, dftDepth_, 1, 1,
+                                        f | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE, blocksize.height);
+            ws.dftImg.create(dftsize, dftDepth_);
+            if( tcn > 1 )
+            {
+                ws.plane.create(blocksize.height + tsz.height - 1, blocksize.width + tsz.width - 1, templ_.depth());
+                ws.acc.create(blocksize, dftDepth_);
+            }
+        }
+    }
+
+    imgSize_ = imgSize;
+    blockSize_ = blocksize;
+    dftSize_ = dftsize;
+}
+
+void TemplateMatcherImpl::dftCorr( const Mat& img, Mat& corr )
+{
+    prepareDFT(img.size());
+
+    int cn = img.channels();
+    Size tsz = templ_.size(), blocksize = blockSize_;
+    int tileCountX = (corr.cols + blocksize.width - 1)/blocksize.width;
+    int tileCount = tileCountX*((corr.rows + blocksize.height - 1)/blocksize.height);
+    int nstripes = (int)workspaces_.size();
+
+    // stripe s processes tiles s, s + nstripes, ... with its own buffers
+    parallel_for_(Range(0, nstripes), [&](const Range& range)
+    {
+        for( int s = range.start; s < range.end; s++ )
+        {
+            Workspace& ws = workspaces_[s];
+            for( int i = s; i < tileCount; i += nstripes )
+            {
+                int x = (i%tileCountX)*blocksize.width;
+                int y = (i/tileCountX)*blocksize.height;
+                Size bsz(std::min(blocksize.width, corr.cols - x),
+                         std::min(blocksize.height, corr.rows - y));
+                Size dsz(bsz.width + tsz.width - 1, bsz.height + tsz.height - 1);
+                Mat src0(img, Rect(x, y, dsz.width, dsz.height));
+                Mat dst1(ws.dftImg, Rect(0, 0, dsz.width, dsz.height));
+                Mat cdst(corr, Rect(x, y, bsz.width, bsz.height));
+
+                for( int k = 0; k < cn; k++ )
+                {
+                    ws.dftImg = Scalar::all(0);
+                    if( cn > 1 )
+                    {
+                        Mat plane(ws.plane, Rect(0, 0, dsz.width, dsz.height));
+                        int pairs[] = {k, 0};
+                        mixChannels(&src0, 1, &plane, 1, pairs, 1);
+                        plane.convertTo(dst1, dftDepth_);
+                    }
+                    else
+                        src0.convertTo(dst1, dftDepth_);
+
+                    ws.fwd->apply(ws.dftImg.data, (int)ws.dftImg.step, ws.dftImg.data, (int)ws.dftImg.step);
+                    Mat dftTempl1(dftTempl_, Rect(0, k*dftSize_.height, dftSize_.width, dftSize_.height));
+                    mulSpectrums(ws.dftImg, dftTempl1, ws.dftImg, 0, true);
+                    ws.inv->apply(ws.dftImg.data, (int)ws.dftImg.step, ws.dftImg.data, (int)ws.dftImg.step);
+
+                    Mat res(ws.dftImg, Rect(0, 0, bsz.width, bsz.height));
+                    if( cn == 1 )
+                        res.convertTo(cdst, CV_32F);
+                    else
+                    {
+                        Mat acc(ws.acc, Rect(0, 0, bsz.width, bsz.height));
+                        if( k == 0 )
+                            res.copyTo(acc);
+                        else
+                            add(acc, res, acc);
+                        if( k == cn - 1 )
+                            acc.convertTo(cdst, CV_32F);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void TemplateMatcherImpl::match( InputArray _img, OutputArray _result )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _img.getMat();
+    CV_Assert( img.type() == templ_.type() && img.dims <= 2 );
+    CV_Assert( img.rows >= templ_.rows && img.cols >= templ_.cols );
+
+    Size corrSize(img.cols - templ_.cols + 1, img.rows - templ_.rows + 1);
+    _result.create(corrSize, CV_32F);
+    Mat result = _result.getMat();
+
+    if( stats_.flat )
+    {
+        result = Scalar::all(1);
+        return;
+    }
+
+    if( spatial_ )
+        spatialCorr(img, result);
+    else
+        dftCorr(img, result);
+
+    if( method_ == cv::TM_CCORR )
+        return;
+
+    if( method_ == cv::TM_CCOEFF )
+        integral(img, sum_, CV_64F);
+    else
+        integral(img, sum_, sqsum_, CV_64F);
+
+    normalizeMatchTemplate(sum_, sqsum_, templ_.size(), stats_, result, method_, img.channels());
+}
+
+Ptr<TemplateMatcher> createTemplateMatcher( InputArray _templ, int method )
+{
+    Mat templ = _templ.getMat();
+    CV_Assert( cv::TM_SQDIFF <= method && method <= cv::TM_CCOEFF_NORMED );
+    CV_Assert( !templ.empty() && templ.dims <= 2 && (templ.depth() == CV_8U || templ.depth() == CV_32F) );
+    CV_Assert( templ.channels() <= 4 );
+    return makePtr<TemplateMatcherImpl>(templ, method);
+}
+
+}
+
 CV_IMPL void
 cvMatchTemplate( const CvArr* _img, const CvArr* _templ, CvArr* _result, int method )
 {
@@ -561,6 +561,60 @@ INSTANTIATE_TEST_CASE_P(
                                      CHAIN_APPROX_TC89_L1,
                                      CHAIN_APPROX_TC89_KCOS)));
 
+typedef testing::TestWithParam<tuple<int, int>> Imgproc_FindContours_Parallel;
+
+// Parallel band scan must give exactly the same result as the sequential one
+TEST_P(Imgproc_FindContours_Parallel, same_as_sequential)
+{
+    const int mode = get<0>(GetParam());
+    const int method = get<1>(GetParam());
+
+    const Size sz {1600, 1200};
+    Mat img = Mat::zeros(sz, CV_8UC1);
+    RNG& rng = TS::ptr()->get_rng();
+    for (int y = 0; y < sz.height; )
+    {
+        const int h = rng.uniform(20, 150);
+        Mat strip = img.rowRange(y, std::min(y + h, sz.height));
+        cvtest::randUni(rng, strip, 0, 255);
+        y += h + rng.uniform(0, 4); // strips may touch each other
+    }
+    Mat fimg;
+    boxFilter(img, fimg, CV_8U, Size(5, 5));
+    cv::threshold(fimg, img, 135, 255, THRESH_BINARY);
+    // nested contours crossing strips
+    for (int r = 300; r > 0; r -= 20)
+        circle(img, Point(800, 600), r, Scalar::all(r % 40 ? 255 : 0), FILLED);
+    img.rowRange(400, 403).setTo(Scalar::all(0));
+
+    Mat src = img;
+    if (mode == RETR_FLOODFILL)
+        img.convertTo(src, CV_32S);
+
+    const int threads = getNumThreads();
+    vector<vector<Point>> contours, contours_seq;
+    vector<Vec4i> hierarchy, hierarchy_seq;
+    setNumThreads(1);
+    findContours(src, contours_seq, hierarchy_seq, mode, method, Point(3, -5));
+    setNumThreads(4);
+    findContours(src, contours, hierarchy, mode, method, Point(3, -5));
+    setNumThreads(threads);
+
+    ASSERT_EQ(contours_seq.size(), contours.size());
+    for (size_t i = 0; i < contours.size(); ++i)
+    {
+        SCOPED_TRACE(format("contour = %zu", i));
+        EXPECT_MAT_NEAR(Mat(contours_seq[i]), Mat(contours[i]), 0);
+    }
+    EXPECT_MAT_NEAR(Mat(hierarchy_seq), Mat(hierarchy), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    ,
+    Imgproc_FindContours_Parallel,
+    testing::Combine(testing::Values(RETR_EXTERNAL, RETR_LIST, RETR_CCOMP, RETR_TREE, RETR_FLOODFILL),
+                     testing::Values(CHAIN_APPROX_NONE, CHAIN_APPROX_SIMPLE, CHAIN_APPROX_TC89_L1)));
+
 TEST(Imgproc_FindContours, link_runs)
 {
     const Size sz {500, 500};
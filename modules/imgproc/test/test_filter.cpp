@@ -2509,4 +2509,94 @@ INSTANTIATE_TEST_CASE_P(/**/, Imgproc_sepFilter2D_types,
     testing::Values(CV_16S, CV_32F, CV_64F),
 );
 
+typedef testing::TestWithParam<int> Imgproc_FilterPipeline;
+TEST_P(Imgproc_FilterPipeline, edges_same_as_separate_calls)
+{
+    const int threads = getNumThreads();
+    setNumThreads(GetParam());
+
+    Mat src(481, 643, CV_8UC3);
+    randu(src, 0, 256);
+    GaussianBlur(src, src, Size(0, 0), 3); // make the gradients non-trivial
+
+    Ptr<FilterPipeline> p = createFilterPipeline();
+    p->addGaussianBlur(Size(5, 5), 1.5);
+    p->addGradientMagnitude(3);
+    p->addThreshold(10, 255, THRESH_BINARY);
+    p->addConvertTo(CV_8U);
+    ASSERT_EQ(4, p->getNumStages());
+    Mat dst;
+    p->apply(src, dst);
+
+    Mat g = getGaussianKernel(5, 1.5, CV_32F), blurred, dx, dy, mag, ref;
+    sepFilter2D(src, blurred, -1, g, g);
+    Sobel(blurred, dx, CV_32F, 1, 0, 3);
+    Sobel(blurred, dy, CV_32F, 0, 1, 3);
+    magnitude(dx.reshape(1), dy.reshape(1), mag);
+    cv::threshold(mag.reshape(3), mag, 10, 255, THRESH_BINARY);
+    mag.convertTo(ref, CV_8U);
+
+    setNumThreads(threads);
+    ASSERT_EQ(CV_8UC3, dst.type());
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    EXPECT_GT(countNonZero(dst.reshape(1)), 0);
+}
+
+TEST_P(Imgproc_FilterPipeline, linear_stages_same_as_separate_calls)
+{
+    const int threads = getNumThreads();
+    setNumThreads(GetParam());
+
+    Mat src(517, 300, CV_32FC1), kernel(3, 4, CV_32F);
+    randu(src, -1, 1);
+    randu(kernel, -1, 1);
+    Mat kx = (Mat_<float>(1, 3) << 0.25f, 0.5f, 0.25f), ky = (Mat_<float>(5, 1) << 1, 2, 3, 2, 1);
+
+    Ptr<FilterPipeline> p = createFilterPipeline();
+    p->addFilter2D(-1, kernel, Point(1, 2), 0.5, BORDER_REFLECT);
+    p->addSepFilter2D(CV_64F, kx, ky, Point(-1, -1), 0, BORDER_REPLICATE);
+    p->addSobel(CV_64F, 1, 1, 5, 0.5, 0, BORDER_CONSTANT);
+    p->addConvertTo(CV_16S, 100, 3);
+    Mat dst;
+    p->apply(src, dst);
+
+    Mat t1, t2, t3, ref;
+    cv::filter2D(src, t1, -1, kernel, Point(1, 2), 0.5, BORDER_REFLECT);
+    sepFilter2D(t1, t2, CV_64F, kx, ky, Point(-1, -1), 0, BORDER_REPLICATE);
+    Sobel(t2, t3, CV_64F, 1, 1, 5, 0.5, 0, BORDER_CONSTANT);
+    t3.convertTo(ref, CV_16S, 100, 3);
+
+    setNumThreads(threads);
+    ASSERT_EQ(CV_16SC1, dst.type());
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1);
+}
+
+TEST_P(Imgproc_FilterPipeline, sigma_blur_and_1x1_gradient)
+{
+    const int threads = getNumThreads();
+    setNumThreads(GetParam());
+
+    // the aperture of the blur is derived from sigma (25x25), the bands must overlap by it
+    Mat src(600, 211, CV_32FC1);
+    randu(src, 0, 255);
+
+    Ptr<FilterPipeline> p = createFilterPipeline();
+    p->addGaussianBlur(Size(0, 0), 3);
+    p->addGradientMagnitude(1);
+    Mat dst;
+    p->apply(src, dst);
+
+    Mat blurred, dx, dy, ref;
+    GaussianBlur(src, blurred, Size(0, 0), 3);
+    Sobel(blurred, dx, CV_32F, 1, 0, 1);
+    Sobel(blurred, dy, CV_32F, 0, 1, 1);
+    magnitude(dx, dy, ref);
+
+    setNumThreads(threads);
+    ASSERT_EQ(CV_32FC1, dst.type());
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-3);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_FilterPipeline, testing::Values(1, 4));
+
 }} // namespace
@@ -541,5 +541,58 @@ TEST(Imgproc_FloodFill, maskValue)
     ASSERT_EQ(1, cvtest::norm(mask.rowRange(1, n-1).colRange(1, n-1), NORM_INF));
 }
 
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_FloodFillSeeds;
+
+TEST_P(Imgproc_FloodFillSeeds, same_as_floodFill)
+{
+    const int type = get<0>(GetParam());
+    const int flags = get<1>(GetParam());
+    RNG& rng = theRNG();
+
+    Mat img(120, 170, type);
+    rng.fill(img, RNG::UNIFORM, Scalar::all(0), Scalar::all(255));
+    GaussianBlur(img, img, Size(0, 0), 3);
+    img(Rect(30, 20, 50, 40)).setTo(Scalar::all(40));
+
+    std::vector<Point> seeds;
+    seeds.push_back(Point(35, 25));
+    seeds.push_back(Point(60, 50));
+    for( int k = 0; k < 10; k++ )
+        seeds.push_back(Point(rng.uniform(0, img.cols), rng.uniform(0, img.rows)));
+
+    Scalar loDiff = Scalar::all(3), upDiff = Scalar::all(3);
+    Mat labels, stats, means;
+    floodFillSeeds(img, seeds, labels, stats, means, loDiff, upDiff, flags);
+
+    ASSERT_EQ(CV_32SC1, labels.type());
+    ASSERT_EQ(img.size(), labels.size());
+    ASSERT_EQ((int)seeds.size(), stats.rows);
+    ASSERT_EQ((int)seeds.size(), means.rows);
+    ASSERT_EQ(img.channels(), means.cols);
+
+    Mat expected = Mat::zeros(img.size(), CV_32S);
+    for( int k = (int)seeds.size() - 1; k >= 0; k-- )
+    {
+        Mat mask, img_copy = img.clone();
+        Rect rect;
+        int area = floodFill(img_copy, mask, seeds[k], Scalar(), &rect, loDiff, upDiff,
+                             flags | FLOODFILL_MASK_ONLY | (255 << 8));
+        mask = mask(Rect(1, 1, img.cols, img.rows));
+        expected.setTo(Scalar::all(k + 1), mask);
+
+        EXPECT_EQ(area, stats.at<int>(k, CC_STAT_AREA)) << "seed " << k;
+        EXPECT_EQ(rect, Rect(stats.at<int>(k, CC_STAT_LEFT), stats.at<int>(k, CC_STAT_TOP),
+                             stats.at<int>(k, CC_STAT_WIDTH), stats.at<int>(k, CC_STAT_HEIGHT))) << "seed " << k;
+        Scalar m = mean(img, mask);
+        for( int i = 0; i < img.channels(); i++ )
+            EXPECT_NEAR(m[i], means.at<double>(k, i), 1e-3) << "seed " << k;
+    }
+    EXPECT_EQ(0, cvtest::norm(expected, labels, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_FloodFillSeeds, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_32FC1),
+    testing::Values(4, 8, 4 | FLOODFILL_FIXED_RANGE, 8 | FLOODFILL_FIXED_RANGE)));
+
 }} // namespace
 /* End of file. */
@@ -175,4 +175,31 @@ TEST(Imgproc_GrabCut, repeatability)
     EXPECT_EQ(0, countNonZero(mask_2 != mask_3));
 }
 
+TEST(Imgproc_GrabCut, graph_reuse)
+{
+    Mat img(180, 240, CV_8UC3), expected = Mat::zeros(img.size(), CV_8UC1);
+    RNG rng(12345);
+    rng.fill(img, RNG::NORMAL, Scalar(60, 120, 60), Scalar::all(20));
+    Mat fgd(img.size(), CV_8UC3);
+    rng.fill(fgd, RNG::NORMAL, Scalar(40, 60, 200), Scalar::all(20));
+    ellipse(expected, Point(120, 90), Size(60, 40), 20, 0, 360, Scalar(1), FILLED);
+    fgd.copyTo(img, expected);
+
+    // later iterations reuse the graph and the flow of the previous ones,
+    // the result must be the same min cut as with a graph built from scratch
+    Rect rect(40, 30, 160, 120);
+    Mat mask1, mask2, bgdModel1, fgdModel1, bgdModel2, fgdModel2;
+    theRNG().state = 12378213;
+    grabCut(img, mask1, rect, bgdModel1, fgdModel1, 3, GC_INIT_WITH_RECT);
+    theRNG().state = 12378213;
+    grabCut(img, mask2, rect, bgdModel2, fgdModel2, 1, GC_INIT_WITH_RECT);
+    grabCut(img, mask2, rect, bgdModel2, fgdModel2, 1, GC_EVAL);
+    grabCut(img, mask2, rect, bgdModel2, fgdModel2, 1, GC_EVAL);
+
+    EXPECT_EQ(0, countNonZero(mask1 != mask2));
+    EXPECT_LE(cvtest::norm(bgdModel1, bgdModel2, NORM_INF), 1e-6);
+    EXPECT_LE(cvtest::norm(fgdModel1, fgdModel2, NORM_INF), 1e-6);
+    EXPECT_LE(countNonZero((mask1 & 1) != expected), (int)img.total() / 100);
+}
+
 }} // namespace
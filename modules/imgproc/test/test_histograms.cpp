@@ -2096,5 +2096,60 @@ INSTANTIATE_TEST_CASE_P(Imgproc_Hist, Imgproc_Equalize_Hist, ::testing::Combine(
                         ::testing::Values(cv::Size(123, 321), cv::Size(256, 256), cv::Size(1024, 768)),
                         ::testing::Range(0, 10)));
 
+typedef testing::TestWithParam<int> Imgproc_CLAHE_Temporal;
+TEST_P(Imgproc_CLAHE_Temporal, same_as_per_frame)
+{
+    const int type = GetParam();
+    const double maxval = type == CV_8UC1 ? 255 : 65535;
+    Mat frame0(240, 320, type), frame1;
+    randu(frame0, 0, maxval/2);
+    GaussianBlur(frame0, frame0, Size(0, 0), 5);
+    frame1 = frame0.clone();
+    frame1(Rect(50, 40, 60, 70)) += Scalar::all(maxval/4);
+
+    Ptr<CLAHE> clahe = createCLAHE(4.0, Size(8, 6)), temporal = createTemporalCLAHE(4.0, Size(8, 6), 1.0, maxval/100);
+
+    // the changed tiles are recomputed, the other ones keep the same lookup tables
+    Mat ref, dst;
+    for( int i = 0; i < 3; i++ )
+    {
+        const Mat& frame = i == 1 ? frame1 : frame0;
+        clahe->apply(frame, ref);
+        temporal->apply(frame, dst);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF)) << "frame " << i;
+    }
+
+    // small changes keep the lookup tables of the reference frame: the brightness shift is visible
+    // in the output, while the per-frame equalization compensates it
+    Mat noisy = frame0 + Scalar::all(maxval/200), ref0;
+    clahe->apply(frame0, ref0);
+    temporal->apply(noisy, dst);
+    clahe->apply(noisy, ref);
+    EXPECT_GT(cvtest::norm(ref, dst, NORM_INF), 0);
+    EXPECT_GT(cvtest::norm(ref0, dst, NORM_INF), 0);
+    Mat lut0;
+    temporal->apply(frame0, lut0);
+    EXPECT_EQ(0, cvtest::norm(ref0, lut0, NORM_INF));
+
+    // the same shift exceeds the zero threshold
+    Ptr<CLAHE> temporal0 = createTemporalCLAHE(4.0, Size(8, 6), 1.0, 0);
+    temporal0->apply(frame0, dst);
+    temporal0->apply(noisy, dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // blending of identical histograms does not change them, blending of different ones does
+    Ptr<CLAHE> blended = createTemporalCLAHE(4.0, Size(8, 6), 0.5, 0);
+    blended->apply(frame0, dst);
+    blended->apply(frame0, dst);
+    EXPECT_EQ(0, cvtest::norm(ref0, dst, NORM_INF));
+    blended->apply(frame1, dst);
+    clahe->apply(frame1, ref);
+    EXPECT_GT(cvtest::norm(ref, dst, NORM_INF), 0);
+
+    EXPECT_ANY_THROW(createTemporalCLAHE(4.0, Size(8, 6), 0, 0));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_CLAHE_Temporal, testing::Values(CV_8UC1, CV_16UC1));
+
 }} // namespace
 /* End Of File */
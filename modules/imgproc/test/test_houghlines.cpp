@@ -387,6 +387,50 @@ TEST(WeightedHoughLines, diagonal)
     EXPECT_NEAR(CV_PI*3/4, lines[1][1], CV_PI/180 + 1e-6);
 }
 
+TEST(HoughLinesDetector, same_as_HoughLines)
+{
+    Mat img(240, 320, CV_8UC1, Scalar(0));
+    line(img, Point(10, 20), Point(300, 200), Scalar(255));
+    line(img, Point(40, 230), Point(280, 15), Scalar(255));
+    line(img, Point(0, 120), Point(319, 120), Scalar(255));
+    line(img, Point(160, 0), Point(160, 239), Scalar(255));
+    RNG& rng = theRNG();
+    for( int i = 0; i < 300; i++ )
+        img.at<uchar>(rng.uniform(0, img.rows), rng.uniform(0, img.cols)) = 255;
+
+    Ptr<HoughLinesDetector> detector = createHoughLinesDetector(1, CV_PI/180, 60, 30, 5);
+    Rect roi(50, 30, 200, 150);
+
+    for( int iter = 0; iter < 2; iter++ ) // the second pass reuses the buffers
+    {
+        detector->setParallelVoting(iter == 0);
+
+        std::vector<Vec3f> lines, ref;
+        detector->detect(img, lines);
+        HoughLines(img, ref, 1, CV_PI/180, 60);
+        ASSERT_FALSE(ref.empty());
+        EXPECT_MAT_NEAR(Mat(ref).reshape(1), Mat(lines).reshape(1), 0);
+
+        Mat masked = Mat::zeros(img.size(), CV_8UC1);
+        img(roi).copyTo(masked(roi));
+        detector->detect(img, lines, roi);
+        HoughLines(masked, ref, 1, CV_PI/180, 60);
+        EXPECT_MAT_NEAR(Mat(ref).reshape(1), Mat(lines).reshape(1), 0);
+
+        std::vector<Vec4i> segments, refSegments;
+        detector->detectSegments(img, segments);
+        HoughLinesP(img, refSegments, 1, CV_PI/180, 60, 30, 5);
+        ASSERT_FALSE(refSegments.empty());
+        EXPECT_MAT_NEAR(Mat(refSegments).reshape(1), Mat(segments).reshape(1), 0);
+
+        detector->detectSegments(img, segments, roi);
+        HoughLinesP(img(roi).clone(), refSegments, 1, CV_PI/180, 60, 30, 5);
+        for( size_t i = 0; i < refSegments.size(); i++ )
+            refSegments[i] += Vec4i(roi.x, roi.y, roi.x, roi.y);
+        EXPECT_MAT_NEAR(Mat(refSegments).reshape(1), Mat(segments).reshape(1), 0);
+    }
+}
+
 INSTANTIATE_TEST_CASE_P( ImgProc, StandartHoughLinesTest, testing::Combine(testing::Values( "shared/pic5.png", "../stitching/a1.png" ),
                                                                            testing::Values( 1, 10 ),
                                                                            testing::Values( 0.05, 0.1 ),
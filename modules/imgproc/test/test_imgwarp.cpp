@@ -1765,5 +1765,124 @@ TEST(Imgproc_Remap, issue_23562)
     }
 }
 
+static Mat batchImage(const Mat& batch, int i, int layout)
+{
+    if( layout == BATCH_NHWC )
+        return Mat(batch.size[1], batch.size[2], CV_MAKETYPE(batch.depth(), batch.size[3]), (void*)batch.ptr(i));
+    std::vector<Mat> planes;
+    for( int c = 0; c < batch.size[1]; c++ )
+        planes.push_back(Mat(batch.size[2], batch.size[3], batch.depth(), (void*)batch.ptr(i, c)));
+    Mat img;
+    merge(planes, img);
+    return img;
+}
+
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_ResizeBatch;
+TEST_P(Imgproc_ResizeBatch, same_as_resize)
+{
+    const int interpolation = get<0>(GetParam()), layout = get<1>(GetParam());
+    RNG& rng = theRNG();
+    Mat src(480, 640, CV_8UC3);
+    randu(src, 0, 256);
+    const Size dsize(48, 32);
+
+    std::vector<Rect> rois;
+    for( int i = 0; i < 150; i++ )
+    {
+        // a few sizes are repeated to share the tables, and some of them need no resize
+        Size sz = i % 3 == 0 ? Size(96, 64) : i % 7 == 0 ? dsize : Size(rng.uniform(1, 200), rng.uniform(1, 200));
+        rois.push_back(Rect(rng.uniform(0, src.cols - sz.width + 1), rng.uniform(0, src.rows - sz.height + 1),
+                            sz.width, sz.height));
+    }
+
+    Mat batch;
+    resizeBatch(src, rois, batch, dsize, interpolation, layout);
+    ASSERT_EQ(4, batch.dims);
+    ASSERT_EQ(CV_8UC1, batch.type());
+    ASSERT_EQ((int)rois.size(), batch.size[0]);
+
+    for( size_t i = 0; i < rois.size(); i++ )
+    {
+        Mat ref;
+        resize(src(rois[i]), ref, dsize, 0, 0, interpolation);
+        ASSERT_EQ(0, cvtest::norm(ref, batchImage(batch, (int)i, layout), NORM_INF)) << "roi=" << rois[i];
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_ResizeBatch, testing::Combine(
+    testing::Values(INTER_NEAREST, INTER_LINEAR, INTER_CUBIC, INTER_AREA, INTER_LANCZOS4, INTER_LINEAR_EXACT),
+    testing::Values(BATCH_NHWC, BATCH_NCHW)));
+
+TEST(Imgproc_WarpAffineBatch, same_as_warpAffine)
+{
+    Mat src(200, 300, CV_32FC3);
+    randu(src, -1, 1);
+    const Size dsize(64, 64);
+    std::vector<Mat> Ms;
+    for( int i = 0; i < 20; i++ )
+        Ms.push_back(getRotationMatrix2D(Point2f(150.f, 100.f), i*18., 0.5 + i*0.05));
+
+    for( int layout = BATCH_NHWC; layout <= BATCH_NCHW; layout++ )
+    {
+        int sizes[] = { (int)Ms.size(), 3, dsize.height, dsize.width };
+        Mat batch(4, sizes, CV_32F, Scalar::all(5));
+        if( layout == BATCH_NHWC )
+            batch = batch.reshape(1, std::vector<int>{ sizes[0], dsize.height, dsize.width, 3 });
+        warpAffineBatch(src, Ms, batch, dsize, INTER_LINEAR, BORDER_TRANSPARENT, Scalar(), layout);
+
+        for( size_t i = 0; i < Ms.size(); i++ )
+        {
+            Mat ref(dsize, CV_32FC3, Scalar::all(5));
+            warpAffine(src, ref, Ms[i], dsize, INTER_LINEAR, BORDER_TRANSPARENT);
+            ASSERT_EQ(0, cvtest::norm(ref, batchImage(batch, (int)i, layout), NORM_INF)) << "i=" << i << " layout=" << layout;
+        }
+    }
+}
+
+typedef testing::TestWithParam<tuple<int, int, bool> > Imgproc_RemapPlan;
+TEST_P(Imgproc_RemapPlan, same_as_remap)
+{
+    const int interpolation = get<0>(GetParam()), type = get<1>(GetParam());
+    const bool relative = get<2>(GetParam());
+    Mat src(300, 400, type);
+    randu(src, 0, 256);
+
+    // a rotation with a radial distortion, partially outside of the source
+    Mat mapx(257, 333, CV_32FC1), mapy(mapx.size(), CV_32FC1);
+    for( int y = 0; y < mapx.rows; y++ )
+        for( int x = 0; x < mapx.cols; x++ )
+        {
+            float u = x - 160.f, v = y - 130.f, k = 1.f + 2e-6f*(u*u + v*v);
+            mapx.at<float>(y, x) = 200.f + k*(0.8f*u - 0.6f*v) - (relative ? x : 0);
+            mapy.at<float>(y, x) = 150.f + k*(0.6f*u + 0.8f*v) - (relative ? y : 0);
+        }
+    const int flags = interpolation | (relative ? WARP_RELATIVE_MAP : 0);
+
+    Ptr<RemapPlan> plan = createRemapPlan(mapx, mapy, flags, BORDER_CONSTANT, Scalar::all(7));
+    ASSERT_EQ(mapx.size(), plan->getSize());
+    Mat dst, ref;
+    plan->apply(src, dst);
+    remap(src, ref, mapx, mapy, flags, BORDER_CONSTANT, Scalar::all(7));
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // fixed-point maps give the same result
+    Mat map1, map2;
+    convertMaps(mapx, mapy, map1, map2, CV_16SC2);
+    createRemapPlan(map1, map2, flags, BORDER_CONSTANT, Scalar::all(7))->apply(src, dst);
+    remap(src, ref, map1, map2, flags, BORDER_CONSTANT, Scalar::all(7));
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // interpolation table indices may be passed as CV_16SC1
+    ASSERT_EQ(CV_16UC1, map2.type());
+    Mat map2s(map2.size(), CV_16SC1, map2.data, map2.step);
+    createRemapPlan(map1, map2s, flags, BORDER_CONSTANT, Scalar::all(7))->apply(src, dst);
+    remap(src, ref, map1, map2s, flags, BORDER_CONSTANT, Scalar::all(7));
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_RemapPlan, testing::Combine(
+    testing::Values(INTER_NEAREST, INTER_LINEAR, INTER_CUBIC, INTER_LANCZOS4),
+    testing::Values(CV_8UC3, CV_32FC1),
+    testing::Bool()));
+
 }} // namespace
-/* End of file. */
@@ -341,5 +341,54 @@ INSTANTIATE_TEST_CASE_P(/**/,
             testing::Values(1, 3),
             testing::Values(TM_SQDIFF, TM_SQDIFF_NORMED, TM_CCORR, TM_CCORR_NORMED, TM_CCOEFF, TM_CCOEFF_NORMED)));
 
+typedef testing::TestWithParam<testing::tuple<perf::MatDepth, int, MatchModes>> TemplateMatcher_Modes;
+
+TEST_P(TemplateMatcher_Modes, accuracy)
+{
+    const int data_type = CV_MAKE_TYPE(get<0>(GetParam()), get<1>(GetParam()));
+    const int method = get<2>(GetParam());
+    RNG & rng = TS::ptr()->get_rng();
+
+    for (int ITER = 0; ITER < 10; ++ITER)
+    {
+        SCOPED_TRACE(cv::format("iteration %d", ITER));
+
+        // both small (spatial) and large (DFT) templates
+        const Size templSize = ITER % 2 == 0 ? Size(rng.uniform(1, 18), rng.uniform(1, 18))
+                                             : Size(rng.uniform(19, 60), rng.uniform(19, 60));
+        Mat templ(templSize, data_type, Scalar::all(0));
+        cvtest::randUni(rng, templ, Scalar::all(0), Scalar::all(255));
+        Ptr<TemplateMatcher> matcher = createTemplateMatcher(templ, method);
+        ASSERT_FALSE(matcher.empty());
+        EXPECT_EQ(method, matcher->getMethod());
+        EXPECT_EQ(templSize, matcher->getTemplateSize());
+
+        // a stream of same-sized frames, then a frame of another size
+        const Size imgSize(rng.uniform(128, 320), rng.uniform(128, 240));
+        for (int frame = 0; frame < 4; ++frame)
+        {
+            SCOPED_TRACE(cv::format("frame %d", frame));
+            Size sz = frame < 3 ? imgSize : imgSize + Size(17, 9);
+            Mat img(sz, data_type, Scalar::all(0));
+            cvtest::randUni(rng, img, Scalar::all(0), Scalar::all(255));
+
+            Mat result;
+            matcher->match(img, result);
+
+            Mat reference;
+            matchTemplate_reference(img, templ, reference, method);
+
+            EXPECT_MAT_NEAR_RELATIVE(result, reference, 1e-3);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/,
+    TemplateMatcher_Modes,
+        testing::Combine(
+            testing::Values(CV_8U, CV_32F),
+            testing::Values(1, 3),
+            testing::Values(TM_SQDIFF, TM_SQDIFF_NORMED, TM_CCORR, TM_CCORR_NORMED, TM_CCOEFF, TM_CCOEFF_NORMED)));
+
 
 }} // namespace
@@ -128,3 +128,68 @@ TEST(Imgproc_Watershed, regression) { CV_WatershedTest test; test.safe_run(); }
 }} // namespace
 
 #endif
+
+namespace opencv_test { namespace {
+
+static void makeSegmentationTestImage(Mat& img, Mat& markers, bool separated)
+{
+    RNG rng(12345);
+    img.create(700, 900, CV_8UC3);
+    randu(img, Scalar::all(0), Scalar::all(60));
+    markers = Mat::zeros(img.size(), CV_32SC1);
+    if (!separated)
+        markers(Rect(0, 0, img.cols, 8)) = Scalar::all(1); // background marker
+    for (int k = 0; k < 60; k++)
+    {
+        Point c(rng.uniform(30, img.cols - 30), rng.uniform(30, img.rows - 30));
+        int r = rng.uniform(8, 25);
+        circle(img, c, r, Scalar::all(rng.uniform(100, 255)), FILLED);
+        if (separated)
+        {
+            // the unknown area is a ring around each object, as in the usual
+            // "sure foreground / sure background" markers
+            circle(markers, c, r + 6, Scalar::all(1), FILLED);
+            circle(markers, c, r + 3, Scalar::all(0), FILLED);
+        }
+        circle(markers, c, r / 3, Scalar::all(k + 2), FILLED);
+    }
+}
+
+typedef testing::TestWithParam<bool> Imgproc_Watershed_Parallel;
+
+TEST_P(Imgproc_Watershed_Parallel, same_as_sequential)
+{
+    Mat img, markers;
+    makeSegmentationTestImage(img, markers, GetParam());
+
+    const int threads = getNumThreads();
+    Mat ref = markers.clone(), res = markers.clone();
+    setNumThreads(1);
+    watershed(img, ref);
+    setNumThreads(4);
+    watershed(img, res);
+    setNumThreads(threads);
+
+    EXPECT_EQ(0, cvtest::norm(ref, res, NORM_INF));
+    EXPECT_GT(countNonZero(ref == -1), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_Watershed_Parallel, testing::Bool());
+
+TEST(Imgproc_PyrMeanShiftFiltering, parallel_same_as_sequential)
+{
+    Mat img, markers;
+    makeSegmentationTestImage(img, markers, false);
+
+    const int threads = getNumThreads();
+    Mat ref, res;
+    setNumThreads(1);
+    pyrMeanShiftFiltering(img, ref, 10, 20, 2);
+    setNumThreads(4);
+    pyrMeanShiftFiltering(img, res, 10, 20, 2);
+    setNumThreads(threads);
+
+    EXPECT_EQ(0, cvtest::norm(ref, res, NORM_INF));
+}
+
+}} // namespace